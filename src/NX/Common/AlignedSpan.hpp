@@ -0,0 +1,148 @@
+#pragma once
+
+#include "NX/Common/Types.hpp"
+
+#include "nonstd/span.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <type_traits>
+
+namespace NX::Common
+{
+/**
+ * @brief Size in bytes of a cache line on every platform NXCommon targets. Also the width of an AVX-512 register.
+ */
+inline constexpr usize k_CacheLineSize = 64;
+
+/**
+ * @brief Returns true if ptr is a multiple of alignment.
+ * @param ptr
+ * @param alignment Must be a power of two
+ * @return bool
+ */
+inline bool IsAligned(const void* ptr, usize alignment) noexcept
+{
+  return (reinterpret_cast<std::uintptr_t>(ptr) & (alignment - 1)) == 0;
+}
+
+/**
+ * @brief Informs the compiler that ptr is a multiple of Alignment so that loads and stores through it may be aligned.
+ * The behavior is undefined if it is not.
+ * @tparam Alignment
+ * @tparam T
+ * @param ptr
+ * @return T*
+ */
+template <usize Alignment, class T>
+inline T* AssumeAligned(T* ptr) noexcept
+{
+  static_assert((Alignment & (Alignment - 1)) == 0, "AssumeAligned: Alignment must be a power of two");
+#if defined(__GNUC__) || defined(__clang__)
+  return static_cast<T*>(__builtin_assume_aligned(ptr, Alignment));
+#else
+  return ptr;
+#endif
+}
+
+/**
+ * @class AlignedSpan
+ * @brief AlignedSpan is a span whose data is known to be aligned to at least Alignment bytes. Kernels taking an
+ * AlignedSpan may use aligned SIMD loads and stores on data(). It converts implicitly to nonstd::span.
+ * @tparam T
+ * @tparam Alignment
+ */
+template <class T, usize Alignment>
+class AlignedSpan
+{
+public:
+  static_assert((Alignment & (Alignment - 1)) == 0, "AlignedSpan: Alignment must be a power of two");
+  static_assert(Alignment >= alignof(T), "AlignedSpan: Alignment must be at least the alignment of the value type");
+
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using size_type = usize;
+  using pointer = T*;
+  using reference = T&;
+  using iterator = T*;
+
+  static inline constexpr usize k_Alignment = Alignment;
+
+  AlignedSpan() noexcept = default;
+
+  /**
+   * @brief Wraps span. Throws std::runtime_error if the data of span is not aligned to Alignment.
+   * @param span
+   */
+  explicit AlignedSpan(nonstd::span<T> span)
+  : m_Span(span)
+  {
+    if(!IsAligned(span.data(), Alignment))
+    {
+      throw std::runtime_error("AlignedSpan: Data is not sufficiently aligned");
+    }
+  }
+
+  /**
+   * @brief Allows an AlignedSpan<T> to be passed as an AlignedSpan<const T> or with a weaker alignment.
+   * @param other
+   */
+  template <class U, usize OtherAlignment, class = std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]> && (OtherAlignment >= Alignment)>>
+  AlignedSpan(const AlignedSpan<U, OtherAlignment>& other) noexcept
+  : m_Span(other.span())
+  {
+  }
+
+  pointer data() const noexcept
+  {
+    return AssumeAligned<Alignment>(m_Span.data());
+  }
+
+  size_type size() const noexcept
+  {
+    return m_Span.size();
+  }
+
+  size_type size_bytes() const noexcept
+  {
+    return m_Span.size() * sizeof(T);
+  }
+
+  bool empty() const noexcept
+  {
+    return m_Span.empty();
+  }
+
+  reference operator[](size_type index) const
+  {
+    return data()[index];
+  }
+
+  iterator begin() const noexcept
+  {
+    return data();
+  }
+
+  iterator end() const noexcept
+  {
+    return data() + size();
+  }
+
+  /**
+   * @brief Returns the span without the alignment guarantee.
+   * @return nonstd::span<T>
+   */
+  nonstd::span<T> span() const noexcept
+  {
+    return m_Span;
+  }
+
+  operator nonstd::span<T>() const noexcept
+  {
+    return m_Span;
+  }
+
+private:
+  nonstd::span<T> m_Span;
+};
+} // namespace NX::Common
@@ -5,6 +5,10 @@
 
 #include "NX/Common/Types.hpp"
 
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
 #ifdef _WIN32
 #define COMPLEX_BYTE_ORDER little
 #elif defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__) && defined(__ORDER_BIG_ENDIAN__)
@@ -120,4 +124,42 @@ inline constexpr T byteswap(T value) noexcept
     }
   }
 }
+
+/**
+ * @brief Returns the number of set bits in value. Compiles to popcnt only when the target enables it, so hot loops
+ * should dispatch to a kernel built for popcnt instead.
+ * @param value
+ * @return int
+ */
+inline constexpr int popcount(uint64 value) noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_popcountll(value);
+#else
+  value = value - ((value >> 1) & 0x5555555555555555ull);
+  value = (value & 0x3333333333333333ull) + ((value >> 2) & 0x3333333333333333ull);
+  value = (value + (value >> 4)) & 0x0F0F0F0F0F0F0F0Full;
+  return static_cast<int>((value * 0x0101010101010101ull) >> 56);
+#endif
+}
+
+/**
+ * @brief Returns the number of trailing zero bits in value, or 64 if value is zero.
+ * @param value
+ * @return int
+ */
+inline int countr_zero(uint64 value) noexcept
+{
+  if(value == 0)
+  {
+    return 64;
+  }
+#if defined(__GNUC__) || defined(__clang__)
+  return __builtin_ctzll(value);
+#else
+  unsigned long index = 0;
+  _BitScanForward64(&index, value);
+  return static_cast<int>(index);
+#endif
+}
 } // namespace NX::Common
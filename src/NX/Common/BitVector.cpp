@@ -0,0 +1,491 @@
+#include "NX/Common/BitVector.hpp"
+
+#include "NX/Common/CpuFeatures.hpp"
+#include "NX/Common/ParallelDataAlgorithm.hpp"
+
+#if defined(NXCOMMON_ARCH_X86)
+#include <immintrin.h>
+#endif
+
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+
+namespace NX::Common
+{
+namespace
+{
+/**
+ * @brief Operations touching fewer than this many bytes are done on the calling thread.
+ */
+constexpr usize k_ParallelThresholdBytes = 1ull << 20;
+
+/**
+ * @brief Number of bytes each parallel task touches. Sized to stay resident in L2.
+ */
+constexpr usize k_ParallelGrainBytes = 1ull << 18;
+
+constexpr uint64 k_LowBits = 0x7F7F7F7F7F7F7F7Full;
+constexpr uint64 k_HighBits = 0x8080808080808080ull;
+constexpr uint64 k_OnePerByte = 0x0101010101010101ull;
+
+/**
+ * @brief Calls func(wordBegin, wordEnd) over [0, numWords), split through ParallelDataAlgorithm when the operation
+ * touches enough memory. bytesPerWord is the number of bytes read and written per word.
+ */
+template <class Func>
+void ForEachWordRange(usize numWords, usize bytesPerWord, Func&& func)
+{
+  ParallelDataAlgorithm algorithm(Range(0, numWords));
+  algorithm.setGrain(k_ParallelGrainBytes / bytesPerWord);
+  algorithm.setParallelizationEnabled(numWords * bytesPerWord >= k_ParallelThresholdBytes);
+  algorithm.execute([&func](const Range& range) { func(range.min(), range.max()); });
+}
+
+/**
+ * @brief Sets the high bit of each byte of value that is nonzero and clears every other bit.
+ */
+inline uint64 NonzeroBytesToHighBits(uint64 value)
+{
+  return (((value & k_LowBits) + k_LowBits) | value) & k_HighBits;
+}
+
+/**
+ * @brief Packs 8 bytes into 8 bits, byte i becoming bit i.
+ */
+inline uint8 PackByte(const uint8* values)
+{
+  uint64 bytes = 0;
+  std::memcpy(&bytes, values, sizeof(bytes));
+  return static_cast<uint8>(((NonzeroBytesToHighBits(bytes) >> 7) * 0x0102040810204080ull) >> 56);
+}
+
+/**
+ * @brief Expands 8 bits into 8 bytes that are 0 or 1, bit i becoming byte i.
+ */
+inline void UnpackByte(uint8 bits, uint8* values)
+{
+  const uint64 spread = (bits * k_OnePerByte) & 0x8040201008040201ull;
+  const uint64 bytes = (NonzeroBytesToHighBits(spread) >> 7);
+  std::memcpy(values, &bytes, sizeof(bytes));
+}
+
+using CountKernelFunc = uint64 (*)(const uint64*, usize);
+using PackKernelFunc = void (*)(const uint8*, usize, uint64*);
+using UnpackKernelFunc = void (*)(const uint64*, usize, uint8*);
+
+uint64 CountScalar(const uint64* words, usize numWords)
+{
+  uint64 count = 0;
+  for(usize i = 0; i < numWords; i++)
+  {
+    count += static_cast<uint64>(popcount(words[i]));
+  }
+  return count;
+}
+
+/**
+ * @brief Packs numWords full words, 64 bytes each.
+ */
+void PackScalar(const uint8* values, usize numWords, uint64* words)
+{
+  for(usize i = 0; i < numWords; i++)
+  {
+    uint64 word = 0;
+    for(usize byte = 0; byte < 8; byte++)
+    {
+      word |= static_cast<uint64>(PackByte(values + i * 64 + byte * 8)) << (byte * 8);
+    }
+    words[i] = word;
+  }
+}
+
+/**
+ * @brief Unpacks numWords full words into 64 bytes each.
+ */
+void UnpackScalar(const uint64* words, usize numWords, uint8* values)
+{
+  for(usize i = 0; i < numWords; i++)
+  {
+    for(usize byte = 0; byte < 8; byte++)
+    {
+      UnpackByte(static_cast<uint8>(words[i] >> (byte * 8)), values + i * 64 + byte * 8);
+    }
+  }
+}
+
+#if defined(NXCOMMON_ARCH_X86)
+NXCOMMON_TARGET("popcnt") inline uint64 PopcntWord(uint64 word)
+{
+#if defined(__x86_64__) || defined(_M_X64)
+  return static_cast<uint64>(_mm_popcnt_u64(word));
+#else
+  return static_cast<uint64>(_mm_popcnt_u32(static_cast<uint32>(word))) + static_cast<uint64>(_mm_popcnt_u32(static_cast<uint32>(word >> 32)));
+#endif
+}
+
+/**
+ * @brief Uses four accumulators so consecutive popcnt instructions do not wait on each other.
+ */
+NXCOMMON_TARGET("popcnt") uint64 CountPopcnt(const uint64* words, usize numWords)
+{
+  uint64 counts[4] = {0, 0, 0, 0};
+  usize i = 0;
+  for(; i + 4 <= numWords; i += 4)
+  {
+    counts[0] += PopcntWord(words[i]);
+    counts[1] += PopcntWord(words[i + 1]);
+    counts[2] += PopcntWord(words[i + 2]);
+    counts[3] += PopcntWord(words[i + 3]);
+  }
+  for(; i < numWords; i++)
+  {
+    counts[0] += PopcntWord(words[i]);
+  }
+  return counts[0] + counts[1] + counts[2] + counts[3];
+}
+
+/**
+ * @brief Counts bits with a pshufb nibble lookup. Per byte counts are summed in 8 bit lanes for up to 31 vectors,
+ * which cannot overflow, before being widened with psadbw.
+ */
+NXCOMMON_TARGET("avx2") uint64 CountAvx2(const uint64* words, usize numWords)
+{
+  const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+  const __m256i lowMask = _mm256_set1_epi8(0x0F);
+  __m256i total = _mm256_setzero_si256();
+  usize i = 0;
+  while(i + 4 <= numWords)
+  {
+    const usize numVectors = std::min<usize>((numWords - i) / 4, 31);
+    __m256i byteCounts = _mm256_setzero_si256();
+    for(usize v = 0; v < numVectors; v++, i += 4)
+    {
+      const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(words + i));
+      const __m256i low = _mm256_shuffle_epi8(lookup, _mm256_and_si256(values, lowMask));
+      const __m256i high = _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(values, 4), lowMask));
+      byteCounts = _mm256_add_epi8(byteCounts, _mm256_add_epi8(low, high));
+    }
+    total = _mm256_add_epi64(total, _mm256_sad_epu8(byteCounts, _mm256_setzero_si256()));
+  }
+  alignas(32) uint64 lanes[4];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(lanes), total);
+  return lanes[0] + lanes[1] + lanes[2] + lanes[3] + CountPopcnt(words + i, numWords - i);
+}
+
+/**
+ * @brief Builds each word from the movemask of 16 byte compares against zero.
+ */
+NXCOMMON_TARGET("sse2") void PackSse2(const uint8* values, usize numWords, uint64* words)
+{
+  const __m128i zero = _mm_setzero_si128();
+  for(usize i = 0; i < numWords; i++)
+  {
+    uint64 word = 0;
+    for(usize part = 0; part < 4; part++)
+    {
+      const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i * 64 + part * 16));
+      const auto zeroMask = static_cast<uint32>(_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, zero)));
+      word |= static_cast<uint64>(~zeroMask & 0xFFFFu) << (part * 16);
+    }
+    words[i] = word;
+  }
+}
+
+NXCOMMON_TARGET("avx2") void PackAvx2(const uint8* values, usize numWords, uint64* words)
+{
+  const __m256i zero = _mm256_setzero_si256();
+  for(usize i = 0; i < numWords; i++)
+  {
+    const __m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i * 64));
+    const __m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i * 64 + 32));
+    const auto lowZeros = static_cast<uint32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(low, zero)));
+    const auto highZeros = static_cast<uint32>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(high, zero)));
+    words[i] = ~(static_cast<uint64>(lowZeros) | (static_cast<uint64>(highZeros) << 32));
+  }
+}
+
+/**
+ * @brief Broadcasts 32 bits to every byte lane, routes byte j / 8 of them to byte j with pshufb and tests
+ * bit j % 8 against a per byte mask.
+ */
+NXCOMMON_TARGET("avx2") void UnpackAvx2(const uint64* words, usize numWords, uint8* values)
+{
+  const __m256i routing = _mm256_setr_epi8(0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 1, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 3, 3, 3, 3, 3, 3, 3, 3);
+  const __m256i bitMask = _mm256_set1_epi64x(static_cast<int64>(0x8040201008040201ull));
+  const __m256i ones = _mm256_set1_epi8(1);
+  for(usize i = 0; i < numWords; i++)
+  {
+    for(usize half = 0; half < 2; half++)
+    {
+      const auto bits = static_cast<int32>(static_cast<uint32>(words[i] >> (half * 32)));
+      const __m256i spread = _mm256_and_si256(_mm256_shuffle_epi8(_mm256_set1_epi32(bits), routing), bitMask);
+      const __m256i result = _mm256_and_si256(_mm256_cmpeq_epi8(spread, bitMask), ones);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(values + i * 64 + half * 32), result);
+    }
+  }
+}
+#endif
+
+CountKernelFunc SelectCountKernel()
+{
+#if defined(NXCOMMON_ARCH_X86)
+  const CpuFeatures& features = GetCpuFeatures();
+  if(features.avx2 && features.popcnt)
+  {
+    return CountAvx2;
+  }
+  if(features.popcnt)
+  {
+    return CountPopcnt;
+  }
+#endif
+  return CountScalar;
+}
+
+PackKernelFunc SelectPackKernel()
+{
+#if defined(NXCOMMON_ARCH_X86)
+  const CpuFeatures& features = GetCpuFeatures();
+  if(features.avx2)
+  {
+    return PackAvx2;
+  }
+  if(features.sse2)
+  {
+    return PackSse2;
+  }
+#endif
+  return PackScalar;
+}
+
+UnpackKernelFunc SelectUnpackKernel()
+{
+#if defined(NXCOMMON_ARCH_X86)
+  if(GetCpuFeatures().avx2)
+  {
+    return UnpackAvx2;
+  }
+#endif
+  return UnpackScalar;
+}
+
+/**
+ * @brief Applies op to each pair of words, storing the result in lhs.
+ */
+template <class Op>
+void CombineWords(uint64* lhs, const uint64* rhs, usize numWords, Op op)
+{
+  ForEachWordRange(numWords, 2 * sizeof(uint64), [lhs, rhs, op](usize begin, usize end) {
+    for(usize i = begin; i < end; i++)
+    {
+      lhs[i] = op(lhs[i], rhs[i]);
+    }
+  });
+}
+
+void CheckSameSize(const BitVector& lhs, const BitVector& rhs)
+{
+  if(lhs.size() != rhs.size())
+  {
+    throw std::invalid_argument("BitVector sizes must match");
+  }
+}
+} // namespace
+
+namespace detail
+{
+uint64 CountSetBits(const uint64* words, usize numWords)
+{
+  static const CountKernelFunc kernel = SelectCountKernel();
+
+  ParallelDataAlgorithm algorithm(Range(0, numWords));
+  algorithm.setGrain(k_ParallelGrainBytes / sizeof(uint64));
+  algorithm.setParallelizationEnabled(numWords * sizeof(uint64) >= k_ParallelThresholdBytes);
+  return algorithm.reduce(
+      uint64{0}, [words](const Range& range, uint64 count) { return count + kernel(words + range.min(), range.size()); }, std::plus<>());
+}
+
+void PackBits(const uint8* values, usize numValues, uint64* words)
+{
+  static const PackKernelFunc kernel = SelectPackKernel();
+
+  const usize numFullWords = numValues / BitVector::k_BitsPerWord;
+  ForEachWordRange(numFullWords, BitVector::k_BitsPerWord + sizeof(uint64), [values, words](usize begin, usize end) {
+    kernel(values + begin * BitVector::k_BitsPerWord, end - begin, words + begin);
+  });
+
+  const usize numTailBits = numValues % BitVector::k_BitsPerWord;
+  if(numTailBits > 0)
+  {
+    uint8 tail[BitVector::k_BitsPerWord] = {};
+    std::memcpy(tail, values + numFullWords * BitVector::k_BitsPerWord, numTailBits);
+    PackScalar(tail, 1, words + numFullWords);
+  }
+}
+
+void UnpackBits(const uint64* words, usize numValues, uint8* values)
+{
+  static const UnpackKernelFunc kernel = SelectUnpackKernel();
+
+  const usize numFullWords = numValues / BitVector::k_BitsPerWord;
+  ForEachWordRange(numFullWords, BitVector::k_BitsPerWord + sizeof(uint64), [values, words](usize begin, usize end) {
+    kernel(words + begin, end - begin, values + begin * BitVector::k_BitsPerWord);
+  });
+
+  const usize numTailBits = numValues % BitVector::k_BitsPerWord;
+  if(numTailBits > 0)
+  {
+    uint8 tail[BitVector::k_BitsPerWord] = {};
+    UnpackScalar(words + numFullWords, 1, tail);
+    std::memcpy(values + numFullWords * BitVector::k_BitsPerWord, tail, numTailBits);
+  }
+}
+} // namespace detail
+
+BitVector BitVector::Pack(nonstd::span<const bool> values, MemoryResource* resource)
+{
+  static_assert(sizeof(bool) == sizeof(uint8));
+  return Pack(nonstd::span<const uint8>(reinterpret_cast<const uint8*>(values.data()), values.size()), resource);
+}
+
+BitVector BitVector::Pack(nonstd::span<const uint8> values, MemoryResource* resource)
+{
+  DataVector<word_type> words(NumWords(values.size()), InitializationMode::Uninitialized, resource);
+  detail::PackBits(values.data(), values.size(), words.data());
+  return BitVector(std::move(words), values.size());
+}
+
+BitVector::BitVector(size_type numBits, bool value, MemoryResource* resource)
+: m_Words(NumWords(numBits), resource)
+, m_Size(numBits)
+{
+  if(value)
+  {
+    set();
+  }
+}
+
+void BitVector::resize(size_type numBits, bool value)
+{
+  const size_type oldSize = m_Size;
+  m_Words.resize(NumWords(numBits));
+  m_Size = numBits;
+  if(numBits < oldSize)
+  {
+    clearUnusedBits();
+  }
+  else if(value)
+  {
+    setRange(oldSize, numBits, true);
+  }
+}
+
+void BitVector::unpack(nonstd::span<bool> destination) const
+{
+  unpack(nonstd::span<uint8>(reinterpret_cast<uint8*>(destination.data()), destination.size()));
+}
+
+void BitVector::unpack(nonstd::span<uint8> destination) const
+{
+  if(destination.size() != m_Size)
+  {
+    throw std::invalid_argument("BitVector::unpack destination size must match the number of bits");
+  }
+  detail::UnpackBits(m_Words.data(), m_Size, destination.data());
+}
+
+void BitVector::set()
+{
+  m_Words.fill(~word_type(0));
+  clearUnusedBits();
+}
+
+void BitVector::setRange(size_type begin, size_type end, bool value)
+{
+  if(begin > end || end > m_Size)
+  {
+    throw std::out_of_range("BitVector::setRange range must lie within the bits");
+  }
+  if(begin == end)
+  {
+    return;
+  }
+  word_type* words = m_Words.data();
+  const size_type firstWord = begin / k_BitsPerWord;
+  const size_type lastWord = (end - 1) / k_BitsPerWord;
+  const word_type firstMask = ~word_type(0) << (begin % k_BitsPerWord);
+  const word_type lastMask = ~word_type(0) >> (k_BitsPerWord - 1 - (end - 1) % k_BitsPerWord);
+  const auto apply = [value](word_type& word, word_type mask) { word = value ? (word | mask) : (word & ~mask); };
+  if(firstWord == lastWord)
+  {
+    apply(words[firstWord], firstMask & lastMask);
+    return;
+  }
+  apply(words[firstWord], firstMask);
+  detail::ParallelFill(words + firstWord + 1, lastWord - firstWord - 1, value ? ~word_type(0) : word_type(0));
+  apply(words[lastWord], lastMask);
+}
+
+void BitVector::reset()
+{
+  m_Words.fill(0);
+}
+
+void BitVector::flip()
+{
+  word_type* words = m_Words.data();
+  ForEachWordRange(m_Words.size(), sizeof(word_type), [words](usize begin, usize end) {
+    for(usize i = begin; i < end; i++)
+    {
+      words[i] = ~words[i];
+    }
+  });
+  clearUnusedBits();
+}
+
+bool BitVector::all() const
+{
+  const size_type numFullWords = m_Size / k_BitsPerWord;
+  const word_type* words = m_Words.data();
+  if(!std::all_of(words, words + numFullWords, [](word_type word) { return word == ~word_type(0); }))
+  {
+    return false;
+  }
+  const size_type numTailBits = m_Size % k_BitsPerWord;
+  return numTailBits == 0 || words[numFullWords] == (~word_type(0) >> (k_BitsPerWord - numTailBits));
+}
+
+BitVector& BitVector::operator&=(const BitVector& rhs)
+{
+  CheckSameSize(*this, rhs);
+  word_type* words = m_Words.data();
+  CombineWords(words, rhs.m_Words.data(), m_Words.size(), [](word_type a, word_type b) { return a & b; });
+  return *this;
+}
+
+BitVector& BitVector::operator|=(const BitVector& rhs)
+{
+  CheckSameSize(*this, rhs);
+  word_type* words = m_Words.data();
+  CombineWords(words, rhs.m_Words.data(), m_Words.size(), [](word_type a, word_type b) { return a | b; });
+  return *this;
+}
+
+BitVector& BitVector::operator^=(const BitVector& rhs)
+{
+  CheckSameSize(*this, rhs);
+  word_type* words = m_Words.data();
+  CombineWords(words, rhs.m_Words.data(), m_Words.size(), [](word_type a, word_type b) { return a ^ b; });
+  return *this;
+}
+
+void BitVector::clearUnusedBits()
+{
+  const size_type numTailBits = m_Size % k_BitsPerWord;
+  if(numTailBits > 0)
+  {
+    m_Words[m_Words.size() - 1] &= ~word_type(0) >> (k_BitsPerWord - numTailBits);
+  }
+}
+} // namespace NX::Common
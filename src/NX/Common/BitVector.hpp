@@ -0,0 +1,647 @@
+#pragma once
+
+#include "NX/Common/Bit.hpp"
+#include "NX/Common/DataVector.hpp"
+#include "NX/Common/MemoryResource.hpp"
+#include "NX/Common/NXCommon_export.hpp"
+#include "NX/Common/Types.hpp"
+
+#include "nonstd/span.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace NX::Common
+{
+namespace detail
+{
+/**
+ * @brief Returns the number of set bits in [words, words + numWords).
+ * @param words
+ * @param numWords
+ * @return uint64
+ */
+NXCOMMON_EXPORT uint64 CountSetBits(const uint64* words, usize numWords);
+
+/**
+ * @brief Packs numValues bytes into ceil(numValues / 64) words. Nonzero bytes become set bits and
+ * the unused high bits of the last word are cleared.
+ * @param values
+ * @param numValues
+ * @param words
+ */
+NXCOMMON_EXPORT void PackBits(const uint8* values, usize numValues, uint64* words);
+
+/**
+ * @brief Unpacks the first numValues bits of words into bytes that are either 0 or 1.
+ * @param words
+ * @param numValues
+ * @param values
+ */
+NXCOMMON_EXPORT void UnpackBits(const uint64* words, usize numValues, uint8* values);
+} // namespace detail
+
+/**
+ * @class BitVector
+ * @brief BitVector stores booleans one bit each in 64 bit words, using 1/8 the memory of a DataVector<bool>.
+ * Elements are accessed through proxy references. Bulk operations work a word at a time and large vectors are
+ * processed in parallel. The unused bits of the last word are always zero.
+ */
+class NXCOMMON_EXPORT BitVector
+{
+public:
+  using word_type = uint64;
+  using size_type = uint64;
+  using value_type = bool;
+  using const_reference = bool;
+
+  static inline constexpr size_type k_BitsPerWord = 64;
+
+  /**
+   * @brief Proxy that refers to a single bit.
+   */
+  class Reference
+  {
+  public:
+    Reference(word_type* word, word_type mask)
+    : m_Word(word)
+    , m_Mask(mask)
+    {
+    }
+
+    Reference(const Reference&) = default;
+
+    ~Reference() = default;
+
+    Reference& operator=(bool value)
+    {
+      if(value)
+      {
+        *m_Word |= m_Mask;
+      }
+      else
+      {
+        *m_Word &= ~m_Mask;
+      }
+      return *this;
+    }
+
+    /**
+     * @brief Assigns the value of the referenced bit, not the reference itself.
+     */
+    Reference& operator=(const Reference& other)
+    {
+      return *this = static_cast<bool>(other);
+    }
+
+    operator bool() const
+    {
+      return (*m_Word & m_Mask) != 0;
+    }
+
+    bool operator~() const
+    {
+      return !static_cast<bool>(*this);
+    }
+
+    /**
+     * @brief Inverts the referenced bit.
+     * @return Reference&
+     */
+    Reference& flip()
+    {
+      *m_Word ^= m_Mask;
+      return *this;
+    }
+
+  private:
+    word_type* m_Word = nullptr;
+    word_type m_Mask = 0;
+  };
+
+  using reference = Reference;
+
+  /**
+   * @brief Random access iterator over the bits. Dereferences to a Reference, or to bool if IsConst.
+   */
+  template <bool IsConst>
+  class BitIterator
+  {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = bool;
+    using difference_type = int64;
+    using pointer = void;
+    using reference = std::conditional_t<IsConst, bool, Reference>;
+    using word_pointer = std::conditional_t<IsConst, const word_type*, word_type*>;
+
+    BitIterator() = default;
+
+    BitIterator(word_pointer words, size_type index)
+    : m_Words(words)
+    , m_Index(index)
+    {
+    }
+
+    /**
+     * @brief Converts an iterator to a const iterator.
+     */
+    template <bool OtherConst, class = std::enable_if_t<IsConst && !OtherConst>>
+    BitIterator(const BitIterator<OtherConst>& other)
+    : m_Words(other.words())
+    , m_Index(other.index())
+    {
+    }
+
+    word_pointer words() const
+    {
+      return m_Words;
+    }
+
+    size_type index() const
+    {
+      return m_Index;
+    }
+
+    reference operator*() const
+    {
+      if constexpr(IsConst)
+      {
+        return ((m_Words[m_Index / k_BitsPerWord] >> (m_Index % k_BitsPerWord)) & 1) != 0;
+      }
+      else
+      {
+        return Reference(m_Words + m_Index / k_BitsPerWord, word_type(1) << (m_Index % k_BitsPerWord));
+      }
+    }
+
+    reference operator[](difference_type offset) const
+    {
+      return *(*this + offset);
+    }
+
+    BitIterator& operator++()
+    {
+      m_Index++;
+      return *this;
+    }
+
+    BitIterator operator++(int)
+    {
+      BitIterator iter = *this;
+      m_Index++;
+      return iter;
+    }
+
+    BitIterator& operator--()
+    {
+      m_Index--;
+      return *this;
+    }
+
+    BitIterator operator--(int)
+    {
+      BitIterator iter = *this;
+      m_Index--;
+      return iter;
+    }
+
+    BitIterator& operator+=(difference_type offset)
+    {
+      m_Index += offset;
+      return *this;
+    }
+
+    BitIterator& operator-=(difference_type offset)
+    {
+      m_Index -= offset;
+      return *this;
+    }
+
+    BitIterator operator+(difference_type offset) const
+    {
+      return BitIterator(m_Words, m_Index + offset);
+    }
+
+    friend BitIterator operator+(difference_type offset, const BitIterator& iter)
+    {
+      return iter + offset;
+    }
+
+    BitIterator operator-(difference_type offset) const
+    {
+      return BitIterator(m_Words, m_Index - offset);
+    }
+
+    difference_type operator-(const BitIterator& rhs) const
+    {
+      return static_cast<difference_type>(m_Index) - static_cast<difference_type>(rhs.m_Index);
+    }
+
+    bool operator==(const BitIterator& rhs) const
+    {
+      return m_Index == rhs.m_Index;
+    }
+
+    bool operator!=(const BitIterator& rhs) const
+    {
+      return m_Index != rhs.m_Index;
+    }
+
+    bool operator<(const BitIterator& rhs) const
+    {
+      return m_Index < rhs.m_Index;
+    }
+
+    bool operator>(const BitIterator& rhs) const
+    {
+      return m_Index > rhs.m_Index;
+    }
+
+    bool operator<=(const BitIterator& rhs) const
+    {
+      return m_Index <= rhs.m_Index;
+    }
+
+    bool operator>=(const BitIterator& rhs) const
+    {
+      return m_Index >= rhs.m_Index;
+    }
+
+  private:
+    word_pointer m_Words = nullptr;
+    size_type m_Index = 0;
+  };
+
+  using iterator = BitIterator<false>;
+  using const_iterator = BitIterator<true>;
+
+  /**
+   * @brief Returns the number of words needed to store numBits bits.
+   * @param numBits
+   * @return size_type
+   */
+  static constexpr size_type NumWords(size_type numBits)
+  {
+    return (numBits + k_BitsPerWord - 1) / k_BitsPerWord;
+  }
+
+  /**
+   * @brief Packs values into a new BitVector.
+   * @param values
+   * @param resource
+   * @return BitVector
+   */
+  static BitVector Pack(nonstd::span<const bool> values, MemoryResource* resource = GetDefaultMemoryResource());
+
+  /**
+   * @brief Packs values into a new BitVector. Nonzero bytes become set bits.
+   * @param values
+   * @param resource
+   * @return BitVector
+   */
+  static BitVector Pack(nonstd::span<const uint8> values, MemoryResource* resource = GetDefaultMemoryResource());
+
+  BitVector()
+  : BitVector(0)
+  {
+  }
+
+  /**
+   * @brief Constructs a BitVector with numBits bits that are all set to value.
+   * @param numBits
+   * @param value
+   * @param resource
+   */
+  explicit BitVector(size_type numBits, bool value = false, MemoryResource* resource = GetDefaultMemoryResource());
+
+  BitVector(const BitVector&) = default;
+  BitVector(BitVector&&) noexcept = default;
+
+  BitVector& operator=(const BitVector&) = default;
+  BitVector& operator=(BitVector&&) noexcept = default;
+
+  ~BitVector() noexcept = default;
+
+  /**
+   * @brief Returns the number of bits.
+   * @return size_type
+   */
+  size_type size() const
+  {
+    return m_Size;
+  }
+
+  /**
+   * @brief Returns true if there are no bits.
+   * @return bool
+   */
+  bool empty() const
+  {
+    return m_Size == 0;
+  }
+
+  /**
+   * @brief Returns the number of words the bits are stored in.
+   * @return size_type
+   */
+  size_type numWords() const
+  {
+    return m_Words.size();
+  }
+
+  /**
+   * @brief Returns the underlying words. Bit i is stored in bit i % 64 of word i / 64.
+   * @return nonstd::span<const word_type>
+   */
+  nonstd::span<const word_type> words() const
+  {
+    return m_Words.createSpan();
+  }
+
+  /**
+   * @brief Returns the MemoryResource the words are allocated from.
+   * @return MemoryResource*
+   */
+  MemoryResource* memoryResource() const
+  {
+    return m_Words.memoryResource();
+  }
+
+  /**
+   * @brief Resizes the BitVector. Bits added by growing are set to value.
+   * @param numBits
+   * @param value
+   */
+  void resize(size_type numBits, bool value = false);
+
+  /**
+   * @brief Unpacks the bits into destination. Throws std::invalid_argument if the sizes differ.
+   * @param destination
+   */
+  void unpack(nonstd::span<bool> destination) const;
+
+  /**
+   * @brief Unpacks the bits into destination as 0 or 1. Throws std::invalid_argument if the sizes differ.
+   * @param destination
+   */
+  void unpack(nonstd::span<uint8> destination) const;
+
+  /**
+   * @brief Returns the value of the bit at index.
+   * @param index
+   * @return bool
+   */
+  bool test(size_type index) const
+  {
+    return ((m_Words[index / k_BitsPerWord] >> (index % k_BitsPerWord)) & 1) != 0;
+  }
+
+  reference operator[](size_type index)
+  {
+    return Reference(m_Words.data() + index / k_BitsPerWord, word_type(1) << (index % k_BitsPerWord));
+  }
+
+  const_reference operator[](size_type index) const
+  {
+    return test(index);
+  }
+
+  /**
+   * @brief Returns the value of the bit at index. Throws std::runtime_error if index is out of bounds.
+   * @param index
+   * @return bool
+   */
+  bool at(size_type index) const
+  {
+    if(index >= m_Size)
+    {
+      throw std::runtime_error("Cannot reference bit out of BitVector bounds");
+    }
+    return test(index);
+  }
+
+  /**
+   * @brief Sets every bit.
+   */
+  void set();
+
+  /**
+   * @brief Sets the bit at index to value.
+   * @param index
+   * @param value
+   */
+  void set(size_type index, bool value = true)
+  {
+    (*this)[index] = value;
+  }
+
+  /**
+   * @brief Sets the bits in [begin, end) to value a word at a time.
+   * Throws std::out_of_range if begin > end or end > size().
+   * @param begin
+   * @param end
+   * @param value
+   */
+  void setRange(size_type begin, size_type end, bool value);
+
+  /**
+   * @brief Clears every bit.
+   */
+  void reset();
+
+  /**
+   * @brief Clears the bit at index.
+   * @param index
+   */
+  void reset(size_type index)
+  {
+    (*this)[index] = false;
+  }
+
+  /**
+   * @brief Inverts every bit.
+   */
+  void flip();
+
+  /**
+   * @brief Inverts the bit at index.
+   * @param index
+   */
+  void flip(size_type index)
+  {
+    (*this)[index].flip();
+  }
+
+  /**
+   * @brief Returns the number of set bits.
+   * @return size_type
+   */
+  size_type count() const
+  {
+    return detail::CountSetBits(m_Words.data(), m_Words.size());
+  }
+
+  /**
+   * @brief Returns true if any bit is set.
+   * @return bool
+   */
+  bool any() const
+  {
+    return std::any_of(m_Words.begin(), m_Words.end(), [](word_type word) { return word != 0; });
+  }
+
+  /**
+   * @brief Returns true if no bit is set.
+   * @return bool
+   */
+  bool none() const
+  {
+    return !any();
+  }
+
+  /**
+   * @brief Returns true if every bit is set. Returns true if the BitVector is empty.
+   * @return bool
+   */
+  bool all() const;
+
+  /**
+   * @brief Returns the index of the first set bit, or size() if no bit is set.
+   * @return size_type
+   */
+  size_type findFirst() const
+  {
+    return findFrom(0);
+  }
+
+  /**
+   * @brief Returns the index of the first set bit after index, or size() if there is none.
+   * @param index
+   * @return size_type
+   */
+  size_type findNext(size_type index) const
+  {
+    return index < m_Size ? findFrom(index + 1) : m_Size;
+  }
+
+  /**
+   * @brief Bitwise operations combine the bits of two BitVectors of the same size.
+   * Throws std::invalid_argument if the sizes differ.
+   */
+  BitVector& operator&=(const BitVector& rhs);
+  BitVector& operator|=(const BitVector& rhs);
+  BitVector& operator^=(const BitVector& rhs);
+
+  BitVector operator~() const
+  {
+    BitVector result = *this;
+    result.flip();
+    return result;
+  }
+
+  bool operator==(const BitVector& rhs) const
+  {
+    return m_Size == rhs.m_Size && std::equal(m_Words.begin(), m_Words.end(), rhs.m_Words.begin());
+  }
+
+  bool operator!=(const BitVector& rhs) const
+  {
+    return !(*this == rhs);
+  }
+
+  iterator begin()
+  {
+    return iterator(m_Words.data(), 0);
+  }
+
+  iterator end()
+  {
+    return iterator(m_Words.data(), m_Size);
+  }
+
+  const_iterator begin() const
+  {
+    return const_iterator(m_Words.data(), 0);
+  }
+
+  const_iterator end() const
+  {
+    return const_iterator(m_Words.data(), m_Size);
+  }
+
+  const_iterator cbegin() const
+  {
+    return begin();
+  }
+
+  const_iterator cend() const
+  {
+    return end();
+  }
+
+private:
+  BitVector(DataVector<word_type>&& words, size_type numBits)
+  : m_Words(std::move(words))
+  , m_Size(numBits)
+  {
+  }
+
+  /**
+   * @brief Returns the index of the first set bit at or after index, or size() if there is none.
+   * Skips clear words a word at a time and locates the bit within a word with a trailing zero count.
+   * @param index
+   * @return size_type
+   */
+  size_type findFrom(size_type index) const
+  {
+    if(index >= m_Size)
+    {
+      return m_Size;
+    }
+    const word_type* words = m_Words.data();
+    const size_type numWords = m_Words.size();
+    size_type wordIndex = index / k_BitsPerWord;
+    word_type word = words[wordIndex] & (~word_type(0) << (index % k_BitsPerWord));
+    while(word == 0)
+    {
+      wordIndex++;
+      if(wordIndex == numWords)
+      {
+        return m_Size;
+      }
+      word = words[wordIndex];
+    }
+    return wordIndex * k_BitsPerWord + static_cast<size_type>(countr_zero(word));
+  }
+
+  /**
+   * @brief Clears the bits of the last word past size().
+   */
+  void clearUnusedBits();
+
+  DataVector<word_type> m_Words;
+  size_type m_Size = 0;
+};
+
+inline BitVector operator&(BitVector lhs, const BitVector& rhs)
+{
+  lhs &= rhs;
+  return lhs;
+}
+
+inline BitVector operator|(BitVector lhs, const BitVector& rhs)
+{
+  lhs |= rhs;
+  return lhs;
+}
+
+inline BitVector operator^(BitVector lhs, const BitVector& rhs)
+{
+  lhs ^= rhs;
+  return lhs;
+}
+} // namespace NX::Common
@@ -0,0 +1,163 @@
+#include "NX/Common/Byteswap.hpp"
+
+#include "NX/Common/Bit.hpp"
+#include "NX/Common/CpuFeatures.hpp"
+#include "NX/Common/ParallelDataAlgorithm.hpp"
+
+#if defined(NXCOMMON_ARCH_X86)
+#include <immintrin.h>
+#endif
+
+#include <array>
+#include <cstring>
+
+namespace NX::Common::detail
+{
+namespace
+{
+/**
+ * @brief Buffers smaller than this many bytes are byteswapped on the calling thread.
+ */
+constexpr usize k_ParallelThresholdBytes = 1ull << 20;
+
+/**
+ * @brief Number of bytes each parallel task byteswaps. Sized to stay resident in L2.
+ */
+constexpr usize k_ParallelGrainBytes = 1ull << 18;
+
+using KernelFunc = void (*)(const std::byte*, std::byte*, usize);
+
+template <usize Size>
+struct UnsignedOfSize;
+
+template <>
+struct UnsignedOfSize<2>
+{
+  using type = uint16;
+};
+
+template <>
+struct UnsignedOfSize<4>
+{
+  using type = uint32;
+};
+
+template <>
+struct UnsignedOfSize<8>
+{
+  using type = uint64;
+};
+
+template <usize Size>
+void ScalarKernel(const std::byte* source, std::byte* destination, usize count)
+{
+  using UnsignedT = typename UnsignedOfSize<Size>::type;
+  for(usize i = 0; i < count; i++)
+  {
+    UnsignedT value = 0;
+    std::memcpy(&value, source + i * Size, Size);
+    value = byteswap(value);
+    std::memcpy(destination + i * Size, &value, Size);
+  }
+}
+
+#if defined(NXCOMMON_ARCH_X86)
+/**
+ * @brief Builds the pshufb control mask that reverses the bytes of each Size byte element across a 32 byte register.
+ * _mm256_shuffle_epi8 shuffles within each 16 byte lane so the same pattern works for both widths.
+ */
+template <usize Size>
+constexpr std::array<uint8, 32> MakeShuffleMask()
+{
+  std::array<uint8, 32> mask = {};
+  for(usize i = 0; i < mask.size(); i++)
+  {
+    mask[i] = static_cast<uint8>((i % 16) / Size * Size + (Size - 1 - i % Size));
+  }
+  return mask;
+}
+
+template <usize Size>
+inline constexpr std::array<uint8, 32> k_ShuffleMask = MakeShuffleMask<Size>();
+
+template <usize Size>
+NXCOMMON_TARGET("ssse3") void Ssse3Kernel(const std::byte* source, std::byte* destination, usize count)
+{
+  const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(k_ShuffleMask<Size>.data()));
+  const usize numBytes = count * Size;
+  usize offset = 0;
+  for(; offset + 16 <= numBytes; offset += 16)
+  {
+    const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + offset));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + offset), _mm_shuffle_epi8(values, mask));
+  }
+  ScalarKernel<Size>(source + offset, destination + offset, (numBytes - offset) / Size);
+}
+
+template <usize Size>
+NXCOMMON_TARGET("avx2") void Avx2Kernel(const std::byte* source, std::byte* destination, usize count)
+{
+  const __m256i mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(k_ShuffleMask<Size>.data()));
+  const usize numBytes = count * Size;
+  usize offset = 0;
+  for(; offset + 64 <= numBytes; offset += 64)
+  {
+    const __m256i first = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + offset));
+    const __m256i second = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + offset + 32));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + offset), _mm256_shuffle_epi8(first, mask));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(destination + offset + 32), _mm256_shuffle_epi8(second, mask));
+  }
+  Ssse3Kernel<Size>(source + offset, destination + offset, (numBytes - offset) / Size);
+}
+#endif
+
+template <usize Size>
+KernelFunc SelectKernel()
+{
+#if defined(NXCOMMON_ARCH_X86)
+  const CpuFeatures& features = GetCpuFeatures();
+  if(features.avx2)
+  {
+    return Avx2Kernel<Size>;
+  }
+  if(features.ssse3)
+  {
+    return Ssse3Kernel<Size>;
+  }
+#endif
+  return ScalarKernel<Size>;
+}
+
+template <usize Size>
+void BulkByteswapN(const void* source, void* destination, usize count)
+{
+  static const KernelFunc kernel = SelectKernel<Size>();
+
+  const auto* sourceBytes = static_cast<const std::byte*>(source);
+  auto* destinationBytes = static_cast<std::byte*>(destination);
+
+  ParallelDataAlgorithm algorithm(Range(0, count));
+  algorithm.setGrain(k_ParallelGrainBytes / Size);
+  algorithm.setParallelizationEnabled(count * Size >= k_ParallelThresholdBytes);
+  algorithm.execute([sourceBytes, destinationBytes](const Range& range) {
+    const usize offset = range.min() * Size;
+    kernel(sourceBytes + offset, destinationBytes + offset, range.size());
+  });
+}
+} // namespace
+
+void BulkByteswap16(const void* source, void* destination, usize count)
+{
+  BulkByteswapN<2>(source, destination, count);
+}
+
+void BulkByteswap32(const void* source, void* destination, usize count)
+{
+  BulkByteswapN<4>(source, destination, count);
+}
+
+void BulkByteswap64(const void* source, void* destination, usize count)
+{
+  BulkByteswapN<8>(source, destination, count);
+}
+} // namespace NX::Common::detail
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "NX/Common/NXCommon_export.hpp"
+#include "NX/Common/Types.hpp"
+
+#include "nonstd/span.hpp"
+
+#include <stdexcept>
+#include <type_traits>
+
+namespace NX::Common
+{
+namespace detail
+{
+/**
+ * @brief Byteswaps count 2, 4 or 8 byte values from source into destination. source and destination
+ * may be the same buffer but must not otherwise overlap. Neither needs to be aligned.
+ * Uses the widest SIMD shuffle supported by the processor and splits large buffers across threads through
+ * ParallelDataAlgorithm.
+ */
+NXCOMMON_EXPORT void BulkByteswap16(const void* source, void* destination, usize count);
+NXCOMMON_EXPORT void BulkByteswap32(const void* source, void* destination, usize count);
+NXCOMMON_EXPORT void BulkByteswap64(const void* source, void* destination, usize count);
+
+template <class T>
+void BulkByteswapImpl(const T* source, T* destination, usize count)
+{
+  static_assert(std::is_arithmetic_v<T>, "BulkByteswap only works on arithmetic types");
+  if constexpr(sizeof(T) == sizeof(uint8))
+  {
+    if(source != destination)
+    {
+      for(usize i = 0; i < count; i++)
+      {
+        destination[i] = source[i];
+      }
+    }
+  }
+  else if constexpr(sizeof(T) == sizeof(uint16))
+  {
+    BulkByteswap16(source, destination, count);
+  }
+  else if constexpr(sizeof(T) == sizeof(uint32))
+  {
+    BulkByteswap32(source, destination, count);
+  }
+  else if constexpr(sizeof(T) == sizeof(uint64))
+  {
+    BulkByteswap64(source, destination, count);
+  }
+}
+} // namespace detail
+
+/**
+ * @brief Byteswaps every value in the span in place. This is the bulk equivalent of calling byteswap() on each element.
+ * @tparam T
+ * @param values
+ */
+template <class T>
+void BulkByteswap(nonstd::span<T> values)
+{
+  detail::BulkByteswapImpl<T>(values.data(), values.data(), values.size());
+}
+
+/**
+ * @brief Writes the byteswapped values of source into destination. The spans must be the same size and must not overlap.
+ * Throws std::invalid_argument if the sizes differ.
+ * @tparam T
+ * @param source
+ * @param destination
+ */
+template <class T>
+void BulkByteswap(nonstd::span<const std::remove_cv_t<T>> source, nonstd::span<T> destination)
+{
+  if(source.size() != destination.size())
+  {
+    throw std::invalid_argument("BulkByteswap: Source and destination must be the same size");
+  }
+  detail::BulkByteswapImpl<T>(source.data(), destination.data(), source.size());
+}
+} // namespace NX::Common
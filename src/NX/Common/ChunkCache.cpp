@@ -0,0 +1,381 @@
+#include "NX/Common/ChunkCache.hpp"
+
+#include "NX/Common/AlignedSpan.hpp"
+#include "NX/Common/DataVectorStream.hpp"
+#include "NX/Common/MemoryResource.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <cerrno>
+#include <cstdlib>
+#include <unistd.h>
+#endif
+
+namespace NX::Common
+{
+namespace
+{
+#ifdef _WIN32
+int CreateScratchFile(const std::filesystem::path& directory)
+{
+  for(int attempt = 0; attempt < 100; attempt++)
+  {
+    wchar_t name[] = L"NXChunksXXXXXX";
+    if(_wmktemp_s(name, std::size(name)) != 0)
+    {
+      break;
+    }
+    const std::filesystem::path path = directory / name;
+    const int fileDescriptor = _wopen(path.c_str(), _O_RDWR | _O_CREAT | _O_EXCL | _O_BINARY | _O_TEMPORARY, _S_IREAD | _S_IWRITE);
+    if(fileDescriptor >= 0)
+    {
+      return fileDescriptor;
+    }
+  }
+  throw std::runtime_error(fmt::format("ScratchFileChunkStore: Unable to create a scratch file in '{}'", directory.string()));
+}
+
+void SeekTo(int fileDescriptor, uint64 offset)
+{
+  if(_lseeki64(fileDescriptor, static_cast<int64>(offset), SEEK_SET) < 0)
+  {
+    throw std::runtime_error(fmt::format("ScratchFileChunkStore: Unable to seek to offset {}", offset));
+  }
+}
+
+void CloseScratchFile(int fileDescriptor)
+{
+  _close(fileDescriptor);
+}
+#else
+int CreateScratchFile(const std::filesystem::path& directory)
+{
+  std::string path = (directory / "NXChunksXXXXXX").string();
+  const int fileDescriptor = ::mkstemp(path.data());
+  if(fileDescriptor < 0)
+  {
+    throw std::runtime_error(fmt::format("ScratchFileChunkStore: Unable to create a scratch file in '{}': {}", directory.string(), std::strerror(errno)));
+  }
+  // The file lives on as long as the descriptor is open and is reclaimed by the OS however the process exits
+  ::unlink(path.c_str());
+  return fileDescriptor;
+}
+
+void SeekTo(int fileDescriptor, uint64 offset)
+{
+  if(::lseek(fileDescriptor, static_cast<off_t>(offset), SEEK_SET) < 0)
+  {
+    throw std::runtime_error(fmt::format("ScratchFileChunkStore: Unable to seek to offset {}: {}", offset, std::strerror(errno)));
+  }
+}
+
+void CloseScratchFile(int fileDescriptor)
+{
+  ::close(fileDescriptor);
+}
+#endif
+
+void ThrowIfInvalid(const Result<>& result)
+{
+  if(result.invalid())
+  {
+    throw std::runtime_error(fmt::format("ScratchFileChunkStore: {}", result.errors().front().message));
+  }
+}
+} // namespace
+
+ChunkStore::~ChunkStore() noexcept = default;
+
+ScratchFileChunkStore::ScratchFileChunkStore(const std::filesystem::path& directory, usize chunkBytes, usize numChunks)
+: m_FileDescriptor(CreateScratchFile(directory))
+, m_ChunkBytes(chunkBytes)
+, m_Written(numChunks, false)
+{
+}
+
+ScratchFileChunkStore::~ScratchFileChunkStore() noexcept
+{
+  CloseScratchFile(m_FileDescriptor);
+}
+
+void ScratchFileChunkStore::readChunk(usize chunkIndex, nonstd::span<std::byte> buffer)
+{
+  if(!m_Written[chunkIndex])
+  {
+    std::fill(buffer.begin(), buffer.end(), std::byte{0});
+    return;
+  }
+  SeekTo(m_FileDescriptor, static_cast<uint64>(chunkIndex) * m_ChunkBytes);
+  ThrowIfInvalid(detail::ReadBytes(m_FileDescriptor, buffer.data(), buffer.size()));
+}
+
+void ScratchFileChunkStore::writeChunk(usize chunkIndex, nonstd::span<const std::byte> buffer)
+{
+  SeekTo(m_FileDescriptor, static_cast<uint64>(chunkIndex) * m_ChunkBytes);
+  ThrowIfInvalid(detail::WriteBytes(m_FileDescriptor, buffer.data(), buffer.size()));
+  if(!m_Written[chunkIndex])
+  {
+    m_Written[chunkIndex] = true;
+    m_NumWritten++;
+  }
+}
+
+usize ScratchFileChunkStore::storedBytes() const
+{
+  return m_NumWritten * m_ChunkBytes;
+}
+
+ChunkCache::ChunkCache(std::unique_ptr<ChunkStore> store, usize chunkBytes, usize numChunks, usize memoryBudget)
+: m_Store(std::move(store))
+, m_ChunkBytes(chunkBytes)
+, m_MemoryBudget(memoryBudget)
+, m_MaxResidentChunks(std::max<usize>(memoryBudget / std::max<usize>(chunkBytes, 1), 1))
+, m_Entries(numChunks)
+{
+  if(m_Store == nullptr)
+  {
+    throw std::runtime_error("ChunkCache: Chunk store cannot be null");
+  }
+}
+
+ChunkCache::~ChunkCache() noexcept
+{
+  MemoryResource* resource = GetDefaultMemoryResource();
+  for(Entry& entry : m_Entries)
+  {
+    if(entry.data != nullptr)
+    {
+      resource->deallocate(entry.data, m_ChunkBytes, k_CacheLineSize);
+    }
+  }
+  for(std::byte* buffer : m_FreeBuffers)
+  {
+    resource->deallocate(buffer, m_ChunkBytes, k_CacheLineSize);
+  }
+}
+
+std::byte* ChunkCache::pin(usize chunkIndex, bool write)
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  Entry& entry = m_Entries.at(chunkIndex);
+  // Another thread is moving the chunk between memory and the store
+  m_Condition.wait(lock, [&entry] { return entry.state == State::Evicted || entry.state == State::Resident; });
+  if(entry.state == State::Evicted)
+  {
+    load(lock, chunkIndex, entry);
+  }
+  else if(entry.pinCount == 0)
+  {
+    m_LruList.erase(entry.lruPosition);
+  }
+  entry.pinCount++;
+  entry.dirty = entry.dirty || write;
+  return entry.data;
+}
+
+void ChunkCache::unpin(usize chunkIndex) noexcept
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  unpinLocked(chunkIndex, m_Entries[chunkIndex]);
+}
+
+void ChunkCache::flush()
+{
+  std::unique_lock<std::mutex> lock(m_Mutex);
+  for(usize i = 0; i < m_Entries.size(); i++)
+  {
+    Entry& entry = m_Entries[i];
+    if(entry.state != State::Resident || !entry.dirty)
+    {
+      continue;
+    }
+    // Pinned while the lock is released so that the chunk cannot be evicted during the write
+    if(entry.pinCount == 0)
+    {
+      m_LruList.erase(entry.lruPosition);
+    }
+    entry.pinCount++;
+    try
+    {
+      writeBack(lock, i, entry);
+    } catch(...)
+    {
+      unpinLocked(i, entry);
+      throw;
+    }
+    // A chunk pinned elsewhere may still be modified after being flushed
+    entry.dirty = entry.dirty || entry.pinCount > 1;
+    unpinLocked(i, entry);
+  }
+}
+
+usize ChunkCache::chunkBytes() const
+{
+  return m_ChunkBytes;
+}
+
+usize ChunkCache::numChunks() const
+{
+  return m_Entries.size();
+}
+
+usize ChunkCache::memoryBudget() const
+{
+  return m_MemoryBudget;
+}
+
+usize ChunkCache::residentBytes() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_NumResident * m_ChunkBytes;
+}
+
+usize ChunkCache::numLoads() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_NumLoads;
+}
+
+usize ChunkCache::numWriteBacks() const
+{
+  std::lock_guard<std::mutex> lock(m_Mutex);
+  return m_NumWriteBacks;
+}
+
+usize ChunkCache::storedBytes() const
+{
+  std::lock_guard<std::mutex> storeLock(m_StoreMutex);
+  return m_Store->storedBytes();
+}
+
+void ChunkCache::load(std::unique_lock<std::mutex>& lock, usize chunkIndex, Entry& entry)
+{
+  // Threads pinning the same chunk wait for the load instead of starting their own
+  entry.state = State::Loading;
+  std::byte* buffer = nullptr;
+  try
+  {
+    buffer = acquireBuffer(lock);
+    lock.unlock();
+    {
+      std::lock_guard<std::mutex> storeLock(m_StoreMutex);
+      m_Store->readChunk(chunkIndex, {buffer, m_ChunkBytes});
+    }
+    lock.lock();
+  } catch(...)
+  {
+    if(!lock.owns_lock())
+    {
+      lock.lock();
+    }
+    if(buffer != nullptr)
+    {
+      releaseBuffer(buffer);
+    }
+    entry.state = State::Evicted;
+    m_Condition.notify_all();
+    throw;
+  }
+  entry.data = buffer;
+  entry.state = State::Resident;
+  m_NumLoads++;
+  m_Condition.notify_all();
+}
+
+std::byte* ChunkCache::acquireBuffer(std::unique_lock<std::mutex>& lock)
+{
+  // Make room first so that a chunk evicted here can donate its buffer
+  evictIfNeeded(lock);
+  std::byte* buffer = nullptr;
+  if(m_FreeBuffers.empty())
+  {
+    buffer = static_cast<std::byte*>(GetDefaultMemoryResource()->allocate(m_ChunkBytes, k_CacheLineSize));
+  }
+  else
+  {
+    buffer = m_FreeBuffers.back();
+    m_FreeBuffers.pop_back();
+  }
+  m_NumResident++;
+  return buffer;
+}
+
+void ChunkCache::releaseBuffer(std::byte* buffer) noexcept
+{
+  m_NumResident--;
+  // Spare buffers are only kept while they fit in the budget alongside the resident chunks
+  if(m_NumResident + m_FreeBuffers.size() < m_MaxResidentChunks)
+  {
+    m_FreeBuffers.push_back(buffer);
+  }
+  else
+  {
+    GetDefaultMemoryResource()->deallocate(buffer, m_ChunkBytes, k_CacheLineSize);
+  }
+}
+
+void ChunkCache::evictIfNeeded(std::unique_lock<std::mutex>& lock)
+{
+  while(m_NumResident >= m_MaxResidentChunks && !m_LruList.empty())
+  {
+    const usize chunkIndex = m_LruList.front();
+    m_LruList.pop_front();
+    Entry& entry = m_Entries[chunkIndex];
+    if(entry.dirty)
+    {
+      entry.state = State::WritingBack;
+      try
+      {
+        writeBack(lock, chunkIndex, entry);
+      } catch(...)
+      {
+        entry.state = State::Resident;
+        entry.lruPosition = m_LruList.insert(m_LruList.begin(), chunkIndex);
+        m_Condition.notify_all();
+        throw;
+      }
+    }
+    entry.state = State::Evicted;
+    releaseBuffer(std::exchange(entry.data, nullptr));
+    m_Condition.notify_all();
+  }
+}
+
+void ChunkCache::writeBack(std::unique_lock<std::mutex>& lock, usize chunkIndex, Entry& entry)
+{
+  // Cleared before the write so that pinning the chunk for writing meanwhile marks it modified again
+  entry.dirty = false;
+  lock.unlock();
+  try
+  {
+    std::lock_guard<std::mutex> storeLock(m_StoreMutex);
+    m_Store->writeChunk(chunkIndex, {entry.data, m_ChunkBytes});
+  } catch(...)
+  {
+    lock.lock();
+    entry.dirty = true;
+    throw;
+  }
+  lock.lock();
+  m_NumWriteBacks++;
+}
+
+void ChunkCache::unpinLocked(usize chunkIndex, Entry& entry) noexcept
+{
+  entry.pinCount--;
+  if(entry.pinCount == 0)
+  {
+    entry.lruPosition = m_LruList.insert(m_LruList.end(), chunkIndex);
+  }
+}
+} // namespace NX::Common
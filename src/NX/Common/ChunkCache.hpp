@@ -0,0 +1,224 @@
+#pragma once
+
+#include "NX/Common/NXCommon_export.hpp"
+#include "NX/Common/Types.hpp"
+
+#include "nonstd/span.hpp"
+
+#include <condition_variable>
+#include <filesystem>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace NX::Common
+{
+/**
+ * @class ChunkStore
+ * @brief ChunkStore is the backing storage of a ChunkCache. It holds a fixed number of equally sized chunks of bytes
+ * that are not resident in memory. Chunks that were never written read back as zeros.
+ * Implementations report failures by throwing std::runtime_error. A ChunkCache calls its store from one thread at a
+ * time, but without holding the lock that guards its resident chunks.
+ */
+class NXCOMMON_EXPORT ChunkStore
+{
+public:
+  ChunkStore() = default;
+
+  ChunkStore(const ChunkStore&) = delete;
+  ChunkStore(ChunkStore&&) noexcept = delete;
+
+  ChunkStore& operator=(const ChunkStore&) = delete;
+  ChunkStore& operator=(ChunkStore&&) noexcept = delete;
+
+  virtual ~ChunkStore() noexcept;
+
+  /**
+   * @brief Fills buffer with the stored contents of the chunk.
+   * @param chunkIndex
+   * @param buffer Exactly one chunk in size
+   */
+  virtual void readChunk(usize chunkIndex, nonstd::span<std::byte> buffer) = 0;
+
+  /**
+   * @brief Replaces the stored contents of the chunk with buffer.
+   * @param chunkIndex
+   * @param buffer Exactly one chunk in size
+   */
+  virtual void writeChunk(usize chunkIndex, nonstd::span<const std::byte> buffer) = 0;
+
+  /**
+   * @brief Returns the number of bytes the stored chunks currently occupy.
+   * @return usize
+   */
+  virtual usize storedBytes() const = 0;
+};
+
+/**
+ * @class ScratchFileChunkStore
+ * @brief ScratchFileChunkStore keeps chunks at fixed offsets in an anonymous scratch file that is deleted
+ * when the store is destroyed, even if the process exits abnormally on platforms that allow it.
+ */
+class NXCOMMON_EXPORT ScratchFileChunkStore : public ChunkStore
+{
+public:
+  /**
+   * @brief Creates the scratch file in directory. Throws std::runtime_error if it cannot be created.
+   * @param directory
+   * @param chunkBytes
+   * @param numChunks
+   */
+  ScratchFileChunkStore(const std::filesystem::path& directory, usize chunkBytes, usize numChunks);
+
+  ~ScratchFileChunkStore() noexcept override;
+
+  void readChunk(usize chunkIndex, nonstd::span<std::byte> buffer) override;
+
+  void writeChunk(usize chunkIndex, nonstd::span<const std::byte> buffer) override;
+
+  usize storedBytes() const override;
+
+private:
+  int m_FileDescriptor = -1;
+  usize m_ChunkBytes = 0;
+  std::vector<bool> m_Written;
+  usize m_NumWritten = 0;
+};
+
+/**
+ * @class ChunkCache
+ * @brief ChunkCache keeps a bounded number of chunks from a ChunkStore resident in memory. Chunks are loaded on demand
+ * and, once no longer pinned, evicted in least recently used order when the memory budget is exceeded. Modified chunks
+ * are written back to the store when evicted or flushed. All member functions are thread safe. Chunks are read and
+ * written outside the cache's lock, so pinning a resident chunk never waits for the store; only threads that pin
+ * a chunk which is being loaded or evicted wait for that transfer to finish.
+ */
+class NXCOMMON_EXPORT ChunkCache
+{
+public:
+  /**
+   * @brief Constructs a cache holding at most max(memoryBudget / chunkBytes, 1) unpinned chunks in memory.
+   * Buffers kept for reuse after an eviction count against the same limit.
+   * @param store
+   * @param chunkBytes
+   * @param numChunks
+   * @param memoryBudget Number of bytes of chunk data that may be resident at once
+   */
+  ChunkCache(std::unique_ptr<ChunkStore> store, usize chunkBytes, usize numChunks, usize memoryBudget);
+
+  ChunkCache(const ChunkCache&) = delete;
+  ChunkCache(ChunkCache&&) noexcept = delete;
+
+  ChunkCache& operator=(const ChunkCache&) = delete;
+  ChunkCache& operator=(ChunkCache&&) noexcept = delete;
+
+  /**
+   * @brief Releases every resident chunk without writing it back since the store is destroyed along with the cache.
+   */
+  ~ChunkCache() noexcept;
+
+  /**
+   * @brief Makes the chunk resident and prevents it from being evicted until a matching unpin().
+   * If write is true the chunk is marked as modified. Pinned chunks do not count against the budget's eviction
+   * decisions, so pinning more chunks than the budget allows temporarily exceeds it.
+   * Throws std::runtime_error if the chunk cannot be loaded.
+   * @param chunkIndex
+   * @param write
+   * @return std::byte* The chunk's data, aligned to a cache line
+   */
+  std::byte* pin(usize chunkIndex, bool write);
+
+  /**
+   * @brief Releases a pin obtained from pin().
+   * @param chunkIndex
+   */
+  void unpin(usize chunkIndex) noexcept;
+
+  /**
+   * @brief Writes every modified resident chunk back to the store. Throws std::runtime_error on failure.
+   */
+  void flush();
+
+  /**
+   * @brief Returns the size of each chunk in bytes.
+   * @return usize
+   */
+  usize chunkBytes() const;
+
+  /**
+   * @brief Returns the number of chunks.
+   * @return usize
+   */
+  usize numChunks() const;
+
+  /**
+   * @brief Returns the memory budget in bytes.
+   * @return usize
+   */
+  usize memoryBudget() const;
+
+  /**
+   * @brief Returns the number of bytes of chunk data currently resident.
+   * @return usize
+   */
+  usize residentBytes() const;
+
+  /**
+   * @brief Returns the number of times a chunk was loaded from the store.
+   * @return usize
+   */
+  usize numLoads() const;
+
+  /**
+   * @brief Returns the number of times a modified chunk was written back to the store.
+   * @return usize
+   */
+  usize numWriteBacks() const;
+
+  /**
+   * @brief Returns the number of bytes held by the store. Flush first for an up to date value.
+   * @return usize
+   */
+  usize storedBytes() const;
+
+private:
+  enum class State : uint8
+  {
+    Evicted,
+    Loading,
+    Resident,
+    WritingBack
+  };
+
+  struct Entry
+  {
+    std::byte* data = nullptr;
+    usize pinCount = 0;
+    State state = State::Evicted;
+    bool dirty = false;
+    std::list<usize>::iterator lruPosition;
+  };
+
+  void load(std::unique_lock<std::mutex>& lock, usize chunkIndex, Entry& entry);
+  std::byte* acquireBuffer(std::unique_lock<std::mutex>& lock);
+  void releaseBuffer(std::byte* buffer) noexcept;
+  void evictIfNeeded(std::unique_lock<std::mutex>& lock);
+  void writeBack(std::unique_lock<std::mutex>& lock, usize chunkIndex, Entry& entry);
+  void unpinLocked(usize chunkIndex, Entry& entry) noexcept;
+
+  mutable std::mutex m_Mutex;
+  std::condition_variable m_Condition;
+  mutable std::mutex m_StoreMutex;
+  std::unique_ptr<ChunkStore> m_Store;
+  usize m_ChunkBytes = 0;
+  usize m_MemoryBudget = 0;
+  usize m_MaxResidentChunks = 0;
+  usize m_NumResident = 0;
+  usize m_NumLoads = 0;
+  usize m_NumWriteBacks = 0;
+  std::vector<Entry> m_Entries;
+  std::list<usize> m_LruList;
+  std::vector<std::byte*> m_FreeBuffers;
+};
+} // namespace NX::Common
@@ -0,0 +1,372 @@
+#pragma once
+
+#include "NX/Common/ChunkCache.hpp"
+#include "NX/Common/CompressedChunkStore.hpp"
+#include "NX/Common/Types.hpp"
+
+#include "nonstd/span.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+namespace NX::Common
+{
+/**
+ * @class ChunkedDataVector
+ * @brief ChunkedDataVector is an array that splits its elements into fixed size chunks held by a ChunkCache, so that
+ * only as many chunks as fit in a memory budget are resident at once and the rest live in a ChunkStore such as a
+ * scratch file. Peak memory is therefore set by the budget rather than the size of the array.
+ * Compressed() instead keeps the chunks compressed in memory with only a small hot cache held uncompressed.
+ *
+ * Kernels should iterate chunk by chunk through acquireChunk() or forEachChunk(), which hand out spans over resident
+ * chunks. getValue() and setValue() go through the cache for every element and are only meant for sparse access.
+ * @tparam T
+ */
+template <class T>
+class ChunkedDataVector
+{
+public:
+  static_assert(std::is_trivially_copyable_v<T>, "ChunkedDataVector: chunks are stored as raw bytes so T must be trivially copyable");
+
+  using value_type = T;
+  using size_type = uint64;
+
+  static inline constexpr usize k_DefaultChunkBytes = 1ull << 20;
+  static inline constexpr usize k_DefaultMemoryBudget = 256ull << 20;
+  static inline constexpr usize k_DefaultHotCacheBytes = 16ull << 20;
+
+  /**
+   * @class Chunk
+   * @brief Chunk keeps one chunk resident for as long as it exists and gives access to its elements.
+   * @tparam U T or const T
+   */
+  template <class U>
+  class Chunk
+  {
+  public:
+    Chunk(const Chunk&) = delete;
+    Chunk& operator=(const Chunk&) = delete;
+
+    Chunk(Chunk&& other) noexcept
+    : m_Cache(std::exchange(other.m_Cache, nullptr))
+    , m_ChunkIndex(other.m_ChunkIndex)
+    , m_Offset(other.m_Offset)
+    , m_Span(other.m_Span)
+    {
+    }
+
+    Chunk& operator=(Chunk&& rhs) noexcept
+    {
+      if(this != &rhs)
+      {
+        release();
+        m_Cache = std::exchange(rhs.m_Cache, nullptr);
+        m_ChunkIndex = rhs.m_ChunkIndex;
+        m_Offset = rhs.m_Offset;
+        m_Span = rhs.m_Span;
+      }
+      return *this;
+    }
+
+    ~Chunk() noexcept
+    {
+      release();
+    }
+
+    /**
+     * @brief Returns the elements of the chunk. The last chunk may hold fewer than chunkSize() elements.
+     * @return nonstd::span<U>
+     */
+    nonstd::span<U> span() const
+    {
+      return m_Span;
+    }
+
+    /**
+     * @brief Returns the index of the chunk.
+     * @return usize
+     */
+    usize chunkIndex() const
+    {
+      return m_ChunkIndex;
+    }
+
+    /**
+     * @brief Returns the index of the first element of the chunk within the ChunkedDataVector.
+     * @return size_type
+     */
+    size_type offset() const
+    {
+      return m_Offset;
+    }
+
+  private:
+    friend class ChunkedDataVector;
+
+    Chunk(ChunkCache* cache, usize chunkIndex, size_type offset, nonstd::span<U> span)
+    : m_Cache(cache)
+    , m_ChunkIndex(chunkIndex)
+    , m_Offset(offset)
+    , m_Span(span)
+    {
+    }
+
+    void release() noexcept
+    {
+      if(m_Cache != nullptr)
+      {
+        m_Cache->unpin(m_ChunkIndex);
+        m_Cache = nullptr;
+      }
+    }
+
+    ChunkCache* m_Cache = nullptr;
+    usize m_ChunkIndex = 0;
+    size_type m_Offset = 0;
+    nonstd::span<U> m_Span;
+  };
+
+  /**
+   * @brief Constructs a zero initialized ChunkedDataVector whose chunks are kept in a scratch file in scratchDirectory.
+   * Throws std::runtime_error if the scratch file cannot be created.
+   * @param numElements
+   * @param memoryBudget Number of bytes of chunk data that may be resident at once
+   * @param chunkSize Number of elements per chunk
+   * @param scratchDirectory
+   */
+  explicit ChunkedDataVector(size_type numElements, usize memoryBudget = k_DefaultMemoryBudget, size_type chunkSize = DefaultChunkSize(),
+                             const std::filesystem::path& scratchDirectory = std::filesystem::temp_directory_path())
+  : ChunkedDataVector(numElements, chunkSize, [&scratchDirectory](usize chunkBytes, usize numChunks) { return std::make_unique<ScratchFileChunkStore>(scratchDirectory, chunkBytes, numChunks); },
+                      memoryBudget)
+  {
+  }
+
+  /**
+   * @brief Constructs a zero initialized ChunkedDataVector whose chunks are kept in the store returned by makeStore,
+   * which is called with the number of bytes per chunk and the number of chunks.
+   * @tparam StoreFactory
+   * @param numElements
+   * @param chunkSize Number of elements per chunk
+   * @param makeStore
+   * @param memoryBudget Number of bytes of chunk data that may be resident at once
+   */
+  template <class StoreFactory, class = std::enable_if_t<std::is_invocable_v<StoreFactory, usize, usize>>>
+  ChunkedDataVector(size_type numElements, size_type chunkSize, StoreFactory&& makeStore, usize memoryBudget = k_DefaultMemoryBudget)
+  : m_Size(numElements)
+  , m_ChunkSize(chunkSize)
+  {
+    if(m_ChunkSize == 0)
+    {
+      throw std::runtime_error("ChunkedDataVector: Chunk size cannot be 0");
+    }
+    const usize chunkBytes = m_ChunkSize * sizeof(value_type);
+    const usize numChunks = (m_Size + m_ChunkSize - 1) / m_ChunkSize;
+    m_Cache = std::make_unique<ChunkCache>(makeStore(chunkBytes, numChunks), chunkBytes, numChunks, memoryBudget);
+  }
+
+  /**
+   * @brief Returns a zero initialized ChunkedDataVector whose chunks are kept compressed in memory by a
+   * CompressedChunkStore. Up to hotCacheBytes of recently used chunks are held uncompressed.
+   * @param numElements
+   * @param hotCacheBytes
+   * @param chunkSize Number of elements per chunk
+   * @return ChunkedDataVector
+   */
+  static ChunkedDataVector Compressed(size_type numElements, usize hotCacheBytes = k_DefaultHotCacheBytes, size_type chunkSize = DefaultChunkSize())
+  {
+    return ChunkedDataVector(
+        numElements, chunkSize, [](usize, usize numChunks) { return std::make_unique<CompressedChunkStore>(sizeof(value_type), numChunks); }, hotCacheBytes);
+  }
+
+  ChunkedDataVector(const ChunkedDataVector&) = delete;
+  ChunkedDataVector(ChunkedDataVector&&) noexcept = default;
+
+  ChunkedDataVector& operator=(const ChunkedDataVector&) = delete;
+  ChunkedDataVector& operator=(ChunkedDataVector&&) noexcept = default;
+
+  ~ChunkedDataVector() noexcept = default;
+
+  /**
+   * @brief Returns the number of elements per chunk used when none is given, about k_DefaultChunkBytes worth.
+   * @return size_type
+   */
+  static constexpr size_type DefaultChunkSize()
+  {
+    return std::max<size_type>(k_DefaultChunkBytes / sizeof(value_type), 1);
+  }
+
+  /**
+   * @brief Returns the number of elements.
+   * @return size_type
+   */
+  size_type size() const
+  {
+    return m_Size;
+  }
+
+  /**
+   * @brief Returns the number of elements per chunk.
+   * @return size_type
+   */
+  size_type chunkSize() const
+  {
+    return m_ChunkSize;
+  }
+
+  /**
+   * @brief Returns the number of chunks.
+   * @return usize
+   */
+  usize numChunks() const
+  {
+    return m_Cache->numChunks();
+  }
+
+  /**
+   * @brief Returns the number of elements in the chunk. Every chunk but the last holds chunkSize() elements.
+   * @param chunkIndex
+   * @return size_type
+   */
+  size_type chunkElementCount(usize chunkIndex) const
+  {
+    return std::min(m_ChunkSize, m_Size - chunkIndex * m_ChunkSize);
+  }
+
+  /**
+   * @brief Returns the number of bytes the elements occupy uncompressed.
+   * @return usize
+   */
+  usize uncompressedBytes() const
+  {
+    return m_Size * sizeof(value_type);
+  }
+
+  /**
+   * @brief Returns the number of bytes held by the chunk store, which is the compressed size for compressed
+   * storage. Chunks that were never written back are not counted; call flush() first for an exact figure.
+   * @return usize
+   */
+  usize storedBytes() const
+  {
+    return m_Cache->storedBytes();
+  }
+
+  /**
+   * @brief Returns the cache holding the chunks, for statistics such as residentBytes().
+   * @return const ChunkCache&
+   */
+  const ChunkCache& cache() const
+  {
+    return *m_Cache;
+  }
+
+  /**
+   * @brief Makes the chunk resident and returns a handle that allows modifying it. The chunk is written back to
+   * the store when it is evicted after the handle is destroyed.
+   * @param chunkIndex
+   * @return Chunk<T>
+   */
+  Chunk<T> acquireChunk(usize chunkIndex)
+  {
+    auto* data = reinterpret_cast<T*>(m_Cache->pin(chunkIndex, true));
+    return Chunk<T>(m_Cache.get(), chunkIndex, chunkIndex * m_ChunkSize, {data, chunkElementCount(chunkIndex)});
+  }
+
+  /**
+   * @brief Makes the chunk resident and returns a handle that allows reading it.
+   * @param chunkIndex
+   * @return Chunk<const T>
+   */
+  Chunk<const T> acquireChunk(usize chunkIndex) const
+  {
+    const auto* data = reinterpret_cast<const T*>(m_Cache->pin(chunkIndex, false));
+    return Chunk<const T>(m_Cache.get(), chunkIndex, chunkIndex * m_ChunkSize, {data, chunkElementCount(chunkIndex)});
+  }
+
+  /**
+   * @brief Calls func(nonstd::span<T> chunk, size_type offset) for every chunk in order, keeping one chunk resident at a time.
+   * @tparam Func
+   * @param func
+   */
+  template <class Func>
+  void forEachChunk(Func&& func)
+  {
+    for(usize i = 0; i < numChunks(); i++)
+    {
+      Chunk<T> chunk = acquireChunk(i);
+      func(chunk.span(), chunk.offset());
+    }
+  }
+
+  /**
+   * @brief Calls func(nonstd::span<const T> chunk, size_type offset) for every chunk in order, keeping one chunk resident at a time.
+   * @tparam Func
+   * @param func
+   */
+  template <class Func>
+  void forEachChunk(Func&& func) const
+  {
+    for(usize i = 0; i < numChunks(); i++)
+    {
+      Chunk<const T> chunk = acquireChunk(i);
+      func(chunk.span(), chunk.offset());
+    }
+  }
+
+  /**
+   * @brief Returns the value at index. Throws std::runtime_error if index is out of bounds.
+   * @param index
+   * @return value_type
+   */
+  value_type getValue(size_type index) const
+  {
+    checkIndex(index);
+    return acquireChunk(index / m_ChunkSize).span()[index % m_ChunkSize];
+  }
+
+  /**
+   * @brief Sets the value at index. Throws std::runtime_error if index is out of bounds.
+   * @param index
+   * @param value
+   */
+  void setValue(size_type index, const value_type& value)
+  {
+    checkIndex(index);
+    acquireChunk(index / m_ChunkSize).span()[index % m_ChunkSize] = value;
+  }
+
+  /**
+   * @brief Assigns value to every element.
+   * @param value
+   */
+  void fill(const value_type& value)
+  {
+    forEachChunk([&value](nonstd::span<T> chunk, size_type) { std::fill(chunk.begin(), chunk.end(), value); });
+  }
+
+  /**
+   * @brief Writes every modified resident chunk back to the store.
+   */
+  void flush()
+  {
+    m_Cache->flush();
+  }
+
+private:
+  void checkIndex(size_type index) const
+  {
+    if(index >= m_Size)
+    {
+      throw std::runtime_error("ChunkedDataVector: Index is out of bounds");
+    }
+  }
+
+  size_type m_Size = 0;
+  size_type m_ChunkSize = 0;
+  std::unique_ptr<ChunkCache> m_Cache;
+};
+} // namespace NX::Common
@@ -0,0 +1,253 @@
+#include "NX/Common/CompressedChunkStore.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace NX::Common
+{
+namespace
+{
+/**
+ * @brief Control bytes below this value start a literal of control + 1 bytes. The rest start a run of
+ * control - k_RunControl + k_MinRunLength copies of the following byte.
+ */
+constexpr uint8 k_RunControl = 128;
+constexpr usize k_MinRunLength = 3;
+constexpr usize k_MaxRunLength = 255 - k_RunControl + k_MinRunLength;
+constexpr usize k_MaxLiteralLength = k_RunControl;
+
+/**
+ * @brief Streaming run length encoder. Runs shorter than k_MinRunLength are folded into literals.
+ */
+class RleEncoder
+{
+public:
+  explicit RleEncoder(std::vector<std::byte>& destination)
+  : m_Destination(destination)
+  {
+  }
+
+  void push(std::byte value)
+  {
+    if(m_RunLength > 0 && value == m_RunByte && m_RunLength < k_MaxRunLength)
+    {
+      m_RunLength++;
+      return;
+    }
+    flushRun();
+    m_RunByte = value;
+    m_RunLength = 1;
+  }
+
+  void finish()
+  {
+    flushRun();
+    flushLiteral();
+  }
+
+private:
+  void flushRun()
+  {
+    if(m_RunLength >= k_MinRunLength)
+    {
+      flushLiteral();
+      m_Destination.push_back(static_cast<std::byte>(k_RunControl + m_RunLength - k_MinRunLength));
+      m_Destination.push_back(m_RunByte);
+    }
+    else
+    {
+      for(usize i = 0; i < m_RunLength; i++)
+      {
+        m_Literal[m_LiteralLength++] = m_RunByte;
+        if(m_LiteralLength == k_MaxLiteralLength)
+        {
+          flushLiteral();
+        }
+      }
+    }
+    m_RunLength = 0;
+  }
+
+  void flushLiteral()
+  {
+    if(m_LiteralLength == 0)
+    {
+      return;
+    }
+    m_Destination.push_back(static_cast<std::byte>(m_LiteralLength - 1));
+    m_Destination.insert(m_Destination.end(), m_Literal.begin(), m_Literal.begin() + m_LiteralLength);
+    m_LiteralLength = 0;
+  }
+
+  std::vector<std::byte>& m_Destination;
+  std::byte m_RunByte = std::byte{0};
+  usize m_RunLength = 0;
+  std::array<std::byte, k_MaxLiteralLength> m_Literal = {};
+  usize m_LiteralLength = 0;
+};
+
+/**
+ * @brief Writes bytes in shuffled order, i.e. byte b of every element before byte b + 1 of any element,
+ * followed by the bytes that do not make up a whole element.
+ */
+class UnshuffleWriter
+{
+public:
+  UnshuffleWriter(nonstd::span<std::byte> destination, usize elementSize)
+  : m_Destination(destination)
+  , m_ElementSize(elementSize)
+  , m_NumElements(destination.size() / elementSize)
+  , m_ShuffledBytes(m_NumElements * elementSize)
+  {
+  }
+
+  usize remaining() const
+  {
+    return m_Destination.size() - m_Written;
+  }
+
+  void write(std::byte value, usize count)
+  {
+    for(usize i = 0; i < count; i++)
+    {
+      if(m_Written < m_ShuffledBytes)
+      {
+        m_Destination[m_Element * m_ElementSize + m_Byte] = value;
+        if(++m_Element == m_NumElements)
+        {
+          m_Element = 0;
+          m_Byte++;
+        }
+      }
+      else
+      {
+        m_Destination[m_Written] = value;
+      }
+      m_Written++;
+    }
+  }
+
+private:
+  nonstd::span<std::byte> m_Destination;
+  usize m_ElementSize = 0;
+  usize m_NumElements = 0;
+  usize m_ShuffledBytes = 0;
+  usize m_Written = 0;
+  usize m_Element = 0;
+  usize m_Byte = 0;
+};
+
+void ThrowCorrupt()
+{
+  throw std::runtime_error("ShuffleRleDecompress: Compressed data is corrupt");
+}
+} // namespace
+
+namespace detail
+{
+void ShuffleRleCompress(nonstd::span<const std::byte> source, usize elementSize, std::vector<std::byte>& destination)
+{
+  destination.clear();
+  RleEncoder encoder(destination);
+  const usize numElements = source.size() / elementSize;
+  for(usize b = 0; b < elementSize; b++)
+  {
+    for(usize i = 0; i < numElements; i++)
+    {
+      encoder.push(source[i * elementSize + b]);
+    }
+  }
+  for(usize i = numElements * elementSize; i < source.size(); i++)
+  {
+    encoder.push(source[i]);
+  }
+  encoder.finish();
+}
+
+void ShuffleRleDecompress(nonstd::span<const std::byte> source, usize elementSize, nonstd::span<std::byte> destination)
+{
+  UnshuffleWriter writer(destination, elementSize);
+  usize offset = 0;
+  while(offset < source.size())
+  {
+    const auto control = static_cast<uint8>(source[offset++]);
+    if(control < k_RunControl)
+    {
+      const usize length = usize{control} + 1;
+      if(length > source.size() - offset || length > writer.remaining())
+      {
+        ThrowCorrupt();
+      }
+      for(usize i = 0; i < length; i++)
+      {
+        writer.write(source[offset + i], 1);
+      }
+      offset += length;
+    }
+    else
+    {
+      const usize length = usize{control} - k_RunControl + k_MinRunLength;
+      if(offset == source.size() || length > writer.remaining())
+      {
+        ThrowCorrupt();
+      }
+      writer.write(source[offset++], length);
+    }
+  }
+  if(writer.remaining() != 0)
+  {
+    ThrowCorrupt();
+  }
+}
+} // namespace detail
+
+CompressedChunkStore::CompressedChunkStore(usize elementSize, usize numChunks)
+: m_ElementSize(elementSize)
+, m_Chunks(numChunks)
+{
+}
+
+CompressedChunkStore::~CompressedChunkStore() noexcept = default;
+
+void CompressedChunkStore::readChunk(usize chunkIndex, nonstd::span<std::byte> buffer)
+{
+  const StoredChunk& chunk = m_Chunks[chunkIndex];
+  if(chunk.bytes.empty())
+  {
+    std::fill(buffer.begin(), buffer.end(), std::byte{0});
+    return;
+  }
+  if(!chunk.isCompressed)
+  {
+    std::memcpy(buffer.data(), chunk.bytes.data(), buffer.size());
+    return;
+  }
+  detail::ShuffleRleDecompress(chunk.bytes, m_ElementSize, buffer);
+}
+
+void CompressedChunkStore::writeChunk(usize chunkIndex, nonstd::span<const std::byte> buffer)
+{
+  StoredChunk& chunk = m_Chunks[chunkIndex];
+  m_StoredBytes -= chunk.bytes.size();
+
+  detail::ShuffleRleCompress(buffer, m_ElementSize, m_Scratch);
+  chunk.isCompressed = m_Scratch.size() < buffer.size();
+  if(chunk.isCompressed)
+  {
+    chunk.bytes.assign(m_Scratch.begin(), m_Scratch.end());
+  }
+  else
+  {
+    chunk.bytes.assign(buffer.begin(), buffer.end());
+  }
+  chunk.bytes.shrink_to_fit();
+  m_StoredBytes += chunk.bytes.size();
+}
+
+usize CompressedChunkStore::storedBytes() const
+{
+  return m_StoredBytes;
+}
+} // namespace NX::Common
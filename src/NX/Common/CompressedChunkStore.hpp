@@ -0,0 +1,75 @@
+#pragma once
+
+#include "NX/Common/ChunkCache.hpp"
+#include "NX/Common/NXCommon_export.hpp"
+#include "NX/Common/Types.hpp"
+
+#include "nonstd/span.hpp"
+
+#include <vector>
+
+namespace NX::Common
+{
+namespace detail
+{
+/**
+ * @brief Compresses source, made of elements of elementSize bytes, by grouping the n-th byte of every element together
+ * and run length encoding the result. Grouping makes the mostly constant high order bytes of integer IDs and the
+ * exponent bytes of floats form long runs. Replaces the contents of destination.
+ * @param source
+ * @param elementSize
+ * @param destination
+ */
+NXCOMMON_EXPORT void ShuffleRleCompress(nonstd::span<const std::byte> source, usize elementSize, std::vector<std::byte>& destination);
+
+/**
+ * @brief Reverses ShuffleRleCompress. destination must be exactly the size of the original data.
+ * Throws std::runtime_error if source is not valid compressed data of that size.
+ * @param source
+ * @param elementSize
+ * @param destination
+ */
+NXCOMMON_EXPORT void ShuffleRleDecompress(nonstd::span<const std::byte> source, usize elementSize, nonstd::span<std::byte> destination);
+} // namespace detail
+
+/**
+ * @class CompressedChunkStore
+ * @brief CompressedChunkStore keeps chunks in memory compressed with detail::ShuffleRleCompress. Chunks that do not
+ * compress are kept as is. Combined with a ChunkCache whose budget is a handful of chunks, only the hot chunks are
+ * held uncompressed.
+ */
+class NXCOMMON_EXPORT CompressedChunkStore : public ChunkStore
+{
+public:
+  /**
+   * @brief Constructs a store for numChunks chunks of elements of elementSize bytes.
+   * @param elementSize
+   * @param numChunks
+   */
+  CompressedChunkStore(usize elementSize, usize numChunks);
+
+  ~CompressedChunkStore() noexcept override;
+
+  void readChunk(usize chunkIndex, nonstd::span<std::byte> buffer) override;
+
+  void writeChunk(usize chunkIndex, nonstd::span<const std::byte> buffer) override;
+
+  /**
+   * @brief Returns the number of bytes held by all stored chunks after compression.
+   * @return usize
+   */
+  usize storedBytes() const override;
+
+private:
+  struct StoredChunk
+  {
+    std::vector<std::byte> bytes;
+    bool isCompressed = false;
+  };
+
+  usize m_ElementSize = 0;
+  usize m_StoredBytes = 0;
+  std::vector<StoredChunk> m_Chunks;
+  std::vector<std::byte> m_Scratch;
+};
+} // namespace NX::Common
@@ -0,0 +1,110 @@
+#include "NX/Common/CpuFeatures.hpp"
+
+#include "NX/Common/Types.hpp"
+
+#include <array>
+
+#if defined(NXCOMMON_ARCH_X86)
+#if defined(_MSC_VER)
+#include <immintrin.h>
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+namespace NX::Common
+{
+namespace
+{
+#if defined(NXCOMMON_ARCH_X86)
+std::array<uint32, 4> Cpuid(uint32 leaf, uint32 subleaf)
+{
+  std::array<uint32, 4> registers = {0, 0, 0, 0};
+#if defined(_MSC_VER)
+  std::array<int, 4> values = {0, 0, 0, 0};
+  __cpuidex(values.data(), static_cast<int>(leaf), static_cast<int>(subleaf));
+  for(usize i = 0; i < 4; i++)
+  {
+    registers[i] = static_cast<uint32>(values[i]);
+  }
+#else
+  __cpuid_count(leaf, subleaf, registers[0], registers[1], registers[2], registers[3]);
+#endif
+  return registers;
+}
+
+uint64 ReadXcr0()
+{
+#if defined(_MSC_VER)
+  return _xgetbv(0);
+#else
+  uint32 eax = 0;
+  uint32 edx = 0;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (static_cast<uint64>(edx) << 32) | eax;
+#endif
+}
+
+bool IsBitSet(uint32 value, uint32 bit)
+{
+  return ((value >> bit) & 1u) != 0;
+}
+
+CpuFeatures DetectCpuFeatures()
+{
+  CpuFeatures features;
+
+  const uint32 maxLeaf = Cpuid(0, 0)[0];
+  if(maxLeaf < 1)
+  {
+    return features;
+  }
+
+  const auto leaf1 = Cpuid(1, 0);
+  const uint32 ecx1 = leaf1[2];
+  const uint32 edx1 = leaf1[3];
+
+  features.sse2 = IsBitSet(edx1, 26);
+  features.ssse3 = IsBitSet(ecx1, 9);
+  features.sse41 = IsBitSet(ecx1, 19);
+  features.sse42 = IsBitSet(ecx1, 20);
+  features.popcnt = IsBitSet(ecx1, 23);
+
+  // AVX state has to be enabled by the operating system as well as supported by the processor
+  const bool osxsave = IsBitSet(ecx1, 27);
+  const uint64 xcr0 = osxsave ? ReadXcr0() : 0;
+  const bool ymmEnabled = (xcr0 & 0x6) == 0x6;
+  const bool zmmEnabled = (xcr0 & 0xE6) == 0xE6;
+
+  features.avx = ymmEnabled && IsBitSet(ecx1, 28);
+  features.fma = features.avx && IsBitSet(ecx1, 12);
+
+  if(maxLeaf >= 7)
+  {
+    const auto leaf7 = Cpuid(7, 0);
+    const uint32 ebx7 = leaf7[1];
+
+    features.bmi1 = IsBitSet(ebx7, 3);
+    features.bmi2 = IsBitSet(ebx7, 8);
+    features.avx2 = features.avx && IsBitSet(ebx7, 5);
+    features.avx512f = zmmEnabled && IsBitSet(ebx7, 16);
+    features.avx512bw = features.avx512f && IsBitSet(ebx7, 30);
+  }
+
+  return features;
+}
+#else
+CpuFeatures DetectCpuFeatures()
+{
+  return {};
+}
+#endif
+} // namespace
+
+const CpuFeatures& GetCpuFeatures()
+{
+  static const CpuFeatures features = DetectCpuFeatures();
+  return features;
+}
+} // namespace NX::Common
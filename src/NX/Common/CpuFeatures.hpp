@@ -0,0 +1,45 @@
+#pragma once
+
+#include "NX/Common/NXCommon_export.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define NXCOMMON_ARCH_X86
+#endif
+
+// Allows a single function to be compiled for an instruction set the rest of the translation unit is not built for.
+// MSVC does not need this since its intrinsics are always available.
+#if defined(NXCOMMON_ARCH_X86) && (defined(__GNUC__) || defined(__clang__))
+#define NXCOMMON_TARGET(isa) __attribute__((target(isa)))
+#else
+#define NXCOMMON_TARGET(isa)
+#endif
+
+namespace NX::Common
+{
+/**
+ * @brief CpuFeatures describes the instruction set extensions that are supported by both the
+ * processor and the operating system. Used to select SIMD kernels at runtime.
+ * All members are false on non-x86 processors.
+ */
+struct NXCOMMON_EXPORT CpuFeatures
+{
+  bool sse2 = false;
+  bool ssse3 = false;
+  bool sse41 = false;
+  bool sse42 = false;
+  bool popcnt = false;
+  bool avx = false;
+  bool avx2 = false;
+  bool fma = false;
+  bool bmi1 = false;
+  bool bmi2 = false;
+  bool avx512f = false;
+  bool avx512bw = false;
+};
+
+/**
+ * @brief Returns the CpuFeatures of the current processor. Detection only happens on the first call.
+ * @return const CpuFeatures&
+ */
+NXCOMMON_EXPORT const CpuFeatures& GetCpuFeatures();
+} // namespace NX::Common
@@ -0,0 +1,350 @@
+#include "NX/Common/DataTypeConversion.hpp"
+
+#include "NX/Common/CpuFeatures.hpp"
+#include "NX/Common/DataTypeDispatch.hpp"
+#include "NX/Common/ParallelDataAlgorithm.hpp"
+
+#if defined(NXCOMMON_ARCH_X86)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+
+namespace NX::Common
+{
+namespace
+{
+/**
+ * @brief Arrays with fewer values than this are converted on the calling thread.
+ */
+constexpr usize k_ParallelThreshold = 1ull << 18;
+
+/**
+ * @brief Number of values each parallel task converts.
+ */
+constexpr usize k_ParallelGrain = 1ull << 16;
+
+template <class U, class T>
+U SaturateInteger(T value)
+{
+  if constexpr(std::is_signed_v<T>)
+  {
+    if(value < 0)
+    {
+      if constexpr(!std::is_signed_v<U>)
+      {
+        return 0;
+      }
+      else
+      {
+        return static_cast<int64>(value) < static_cast<int64>(std::numeric_limits<U>::lowest()) ? std::numeric_limits<U>::lowest() : static_cast<U>(value);
+      }
+    }
+  }
+  return static_cast<uint64>(value) > static_cast<uint64>(std::numeric_limits<U>::max()) ? std::numeric_limits<U>::max() : static_cast<U>(value);
+}
+
+template <class U, class T>
+U FloatToInteger(T value, bool round)
+{
+  // Every limit rounds to a float64 at or beyond the limit, so values between the bounds convert without overflow
+  constexpr auto k_Lowest = static_cast<float64>(std::numeric_limits<U>::lowest());
+  constexpr auto k_Max = static_cast<float64>(std::numeric_limits<U>::max());
+  const auto x = static_cast<float64>(value);
+  if(std::isnan(x))
+  {
+    return 0;
+  }
+  if(x <= k_Lowest)
+  {
+    return std::numeric_limits<U>::lowest();
+  }
+  if(x >= k_Max)
+  {
+    return std::numeric_limits<U>::max();
+  }
+  return static_cast<U>(round ? std::nearbyint(x) : x);
+}
+
+/**
+ * @brief Scalar definition of every conversion. The SIMD kernels must produce identical results.
+ */
+template <class U, class T>
+U ConvertValue(T value, ConversionMode mode)
+{
+  if constexpr(std::is_same_v<U, bool>)
+  {
+    return value != T{0};
+  }
+  else if constexpr(std::is_same_v<T, bool> || std::is_floating_point_v<U>)
+  {
+    if constexpr(std::is_same_v<T, float64> && std::is_same_v<U, float32>)
+    {
+      constexpr auto k_Max = static_cast<float64>(std::numeric_limits<float32>::max());
+      if(mode != ConversionMode::Truncate && std::isfinite(value) && std::abs(value) > k_Max)
+      {
+        return static_cast<float32>(std::copysign(k_Max, value));
+      }
+    }
+    return static_cast<U>(value);
+  }
+  else if constexpr(std::is_floating_point_v<T>)
+  {
+    return FloatToInteger<U>(value, mode == ConversionMode::RoundSaturate);
+  }
+  else
+  {
+    return mode == ConversionMode::Truncate ? static_cast<U>(value) : SaturateInteger<U>(value);
+  }
+}
+
+template <class T, class U>
+using KernelFunc = void (*)(const T*, U*, usize, ConversionMode);
+
+template <class T, class U>
+void ScalarKernel(const T* source, U* destination, usize count, ConversionMode mode)
+{
+  if constexpr(std::is_same_v<T, U>)
+  {
+    std::copy(source, source + count, destination);
+  }
+  else
+  {
+    for(usize i = 0; i < count; i++)
+    {
+      destination[i] = ConvertValue<U>(source[i], mode);
+    }
+  }
+}
+
+#if defined(NXCOMMON_ARCH_X86)
+template <class T>
+constexpr bool k_IsSimdInteger = std::is_same_v<T, int8> || std::is_same_v<T, uint8> || std::is_same_v<T, int16> || std::is_same_v<T, uint16> || std::is_same_v<T, int32>;
+
+template <class T>
+constexpr bool k_IsFloat = std::is_same_v<T, float32> || std::is_same_v<T, float64>;
+
+/**
+ * @brief Loads 8 integers and widens them to int32.
+ */
+template <class T>
+NXCOMMON_TARGET("avx2") inline __m256i LoadWidenAvx2(const T* source)
+{
+  if constexpr(std::is_same_v<T, int8>)
+  {
+    return _mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(source)));
+  }
+  else if constexpr(std::is_same_v<T, uint8>)
+  {
+    return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(source)));
+  }
+  else if constexpr(std::is_same_v<T, int16>)
+  {
+    return _mm256_cvtepi16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source)));
+  }
+  else if constexpr(std::is_same_v<T, uint16>)
+  {
+    return _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source)));
+  }
+  else
+  {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source));
+  }
+}
+
+/**
+ * @brief Stores 8 int32 values already clamped to the range of U. The saturating packs are therefore exact.
+ */
+template <class U>
+NXCOMMON_TARGET("avx2") inline void StoreNarrowAvx2(U* destination, __m128i low, __m128i high)
+{
+  if constexpr(std::is_same_v<U, int32>)
+  {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), low);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + 4), high);
+  }
+  else
+  {
+    const __m128i words = std::is_signed_v<U> ? _mm_packs_epi32(low, high) : _mm_packus_epi32(low, high);
+    if constexpr(sizeof(U) == 2)
+    {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), words);
+    }
+    else
+    {
+      const __m128i bytes = std::is_signed_v<U> ? _mm_packs_epi16(words, words) : _mm_packus_epi16(words, words);
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(destination), bytes);
+    }
+  }
+}
+
+template <class T, class U>
+NXCOMMON_TARGET("avx2") void IntegerToFloatAvx2Kernel(const T* source, U* destination, usize count, ConversionMode mode)
+{
+  usize i = 0;
+  for(; i + 8 <= count; i += 8)
+  {
+    const __m256i values = LoadWidenAvx2(source + i);
+    if constexpr(std::is_same_v<U, float32>)
+    {
+      _mm256_storeu_ps(destination + i, _mm256_cvtepi32_ps(values));
+    }
+    else
+    {
+      _mm256_storeu_pd(destination + i, _mm256_cvtepi32_pd(_mm256_castsi256_si128(values)));
+      _mm256_storeu_pd(destination + i + 4, _mm256_cvtepi32_pd(_mm256_extracti128_si256(values, 1)));
+    }
+  }
+  ScalarKernel(source + i, destination + i, count - i, mode);
+}
+
+template <class U, bool Round>
+NXCOMMON_TARGET("avx2") inline __m128i Float64ToInt32Avx2(__m256d values)
+{
+  const __m256d lowest = _mm256_set1_pd(static_cast<float64>(std::numeric_limits<U>::lowest()));
+  const __m256d max = _mm256_set1_pd(static_cast<float64>(std::numeric_limits<U>::max()));
+  // NaN becomes 0, then every limit of U is exact in float64 so clamping keeps the conversion in range
+  values = _mm256_and_pd(values, _mm256_cmp_pd(values, values, _CMP_ORD_Q));
+  values = _mm256_min_pd(_mm256_max_pd(values, lowest), max);
+  return Round ? _mm256_cvtpd_epi32(values) : _mm256_cvttpd_epi32(values);
+}
+
+template <class U, bool Round>
+NXCOMMON_TARGET("avx2") inline __m256i Float32ToInt32Avx2(__m256 values)
+{
+  // INT32_MAX is not representable in float32, so clamp to 2^31 and fix up the lanes that reach it
+  constexpr float32 k_Max = sizeof(U) < 4 ? static_cast<float32>(std::numeric_limits<U>::max()) : 2147483648.0f;
+  const __m256 lowest = _mm256_set1_ps(static_cast<float32>(std::numeric_limits<U>::lowest()));
+  const __m256 max = _mm256_set1_ps(k_Max);
+  values = _mm256_and_ps(values, _mm256_cmp_ps(values, values, _CMP_ORD_Q));
+  values = _mm256_min_ps(_mm256_max_ps(values, lowest), max);
+  __m256i result = Round ? _mm256_cvtps_epi32(values) : _mm256_cvttps_epi32(values);
+  if constexpr(sizeof(U) == 4)
+  {
+    const __m256i overflow = _mm256_castps_si256(_mm256_cmp_ps(values, max, _CMP_GE_OQ));
+    result = _mm256_blendv_epi8(result, _mm256_set1_epi32(std::numeric_limits<int32>::max()), overflow);
+  }
+  return result;
+}
+
+template <class T, class U, bool Round>
+NXCOMMON_TARGET("avx2") void FloatToIntegerAvx2Kernel(const T* source, U* destination, usize count, ConversionMode mode)
+{
+  usize i = 0;
+  for(; i + 8 <= count; i += 8)
+  {
+    if constexpr(std::is_same_v<T, float32>)
+    {
+      const __m256i values = Float32ToInt32Avx2<U, Round>(_mm256_loadu_ps(source + i));
+      StoreNarrowAvx2(destination + i, _mm256_castsi256_si128(values), _mm256_extracti128_si256(values, 1));
+    }
+    else
+    {
+      const __m128i low = Float64ToInt32Avx2<U, Round>(_mm256_loadu_pd(source + i));
+      const __m128i high = Float64ToInt32Avx2<U, Round>(_mm256_loadu_pd(source + i + 4));
+      StoreNarrowAvx2(destination + i, low, high);
+    }
+  }
+  ScalarKernel(source + i, destination + i, count - i, mode);
+}
+
+NXCOMMON_TARGET("avx2") void Float32ToFloat64Avx2Kernel(const float32* source, float64* destination, usize count, ConversionMode mode)
+{
+  usize i = 0;
+  for(; i + 4 <= count; i += 4)
+  {
+    _mm256_storeu_pd(destination + i, _mm256_cvtps_pd(_mm_loadu_ps(source + i)));
+  }
+  ScalarKernel(source + i, destination + i, count - i, mode);
+}
+
+template <bool Saturate>
+NXCOMMON_TARGET("avx2") void Float64ToFloat32Avx2Kernel(const float64* source, float32* destination, usize count, ConversionMode mode)
+{
+  const __m256d max = _mm256_set1_pd(static_cast<float64>(std::numeric_limits<float32>::max()));
+  const __m256d lowest = _mm256_set1_pd(static_cast<float64>(std::numeric_limits<float32>::lowest()));
+  const __m256d infinity = _mm256_set1_pd(std::numeric_limits<float64>::infinity());
+  const __m256d signMask = _mm256_set1_pd(-0.0);
+  usize i = 0;
+  for(; i + 4 <= count; i += 4)
+  {
+    __m256d values = _mm256_loadu_pd(source + i);
+    if constexpr(Saturate)
+    {
+      // The second operand of min and max is returned for NaN, which keeps NaN. Infinities are restored afterwards.
+      const __m256d clamped = _mm256_max_pd(lowest, _mm256_min_pd(max, values));
+      const __m256d isInfinite = _mm256_cmp_pd(_mm256_andnot_pd(signMask, values), infinity, _CMP_EQ_OQ);
+      values = _mm256_blendv_pd(clamped, values, isInfinite);
+    }
+    _mm_storeu_ps(destination + i, _mm256_cvtpd_ps(values));
+  }
+  ScalarKernel(source + i, destination + i, count - i, mode);
+}
+#endif
+
+template <class T, class U>
+KernelFunc<T, U> SelectKernel(ConversionMode mode)
+{
+#if defined(NXCOMMON_ARCH_X86)
+  if(GetCpuFeatures().avx2)
+  {
+    if constexpr(k_IsSimdInteger<T> && k_IsFloat<U>)
+    {
+      return IntegerToFloatAvx2Kernel<T, U>;
+    }
+    else if constexpr(k_IsFloat<T> && k_IsSimdInteger<U>)
+    {
+      // Truncate matches Saturate for floating point sources
+      if(mode == ConversionMode::RoundSaturate)
+      {
+        return FloatToIntegerAvx2Kernel<T, U, true>;
+      }
+      return FloatToIntegerAvx2Kernel<T, U, false>;
+    }
+    else if constexpr(std::is_same_v<T, float32> && std::is_same_v<U, float64>)
+    {
+      return Float32ToFloat64Avx2Kernel;
+    }
+    else if constexpr(std::is_same_v<T, float64> && std::is_same_v<U, float32>)
+    {
+      if(mode == ConversionMode::Truncate)
+      {
+        return Float64ToFloat32Avx2Kernel<false>;
+      }
+      return Float64ToFloat32Avx2Kernel<true>;
+    }
+  }
+#endif
+  return ScalarKernel<T, U>;
+}
+
+struct ConvertFunctor
+{
+  template <class T, class U>
+  void operator()(const void* source, void* destination, usize count, ConversionMode mode) const
+  {
+    static const std::array<KernelFunc<T, U>, 3> kernels = {SelectKernel<T, U>(ConversionMode::Truncate), SelectKernel<T, U>(ConversionMode::Saturate),
+                                                            SelectKernel<T, U>(ConversionMode::RoundSaturate)};
+    const KernelFunc<T, U> kernel = kernels.at(static_cast<usize>(mode));
+
+    const auto* typedSource = static_cast<const T*>(source);
+    auto* typedDestination = static_cast<U*>(destination);
+
+    ParallelDataAlgorithm algorithm(Range(0, count));
+    algorithm.setGrain(k_ParallelGrain);
+    algorithm.setParallelizationEnabled(count >= k_ParallelThreshold);
+    algorithm.execute([typedSource, typedDestination, kernel, mode](const Range& range) {
+      kernel(typedSource + range.min(), typedDestination + range.min(), range.size(), mode);
+    });
+  }
+};
+} // namespace
+
+void ConvertValues(DataType sourceType, const void* source, DataType destinationType, void* destination, usize count, ConversionMode mode)
+{
+  DispatchDataTypes(sourceType, destinationType, ConvertFunctor{}, source, destination, count, mode);
+}
+} // namespace NX::Common
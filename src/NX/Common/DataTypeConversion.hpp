@@ -0,0 +1,60 @@
+#pragma once
+
+#include "NX/Common/NXCommon_export.hpp"
+#include "NX/Common/Types.hpp"
+#include "NX/Common/TypesUtility.hpp"
+
+#include "nonstd/span.hpp"
+
+#include <stdexcept>
+#include <type_traits>
+
+namespace NX::Common
+{
+/**
+ * @brief Controls how ConvertValues handles values the destination type cannot represent.
+ * Every mode converts NaN to 0 when the destination is an integer. A boolean destination is true for any nonzero
+ * value, including NaN, and false only for zero.
+ */
+enum class ConversionMode : uint8
+{
+  Truncate = 0,     ///< Behaves like static_cast. Integers wrap, fractions are discarded and float64 overflows float32 to infinity. Floating point values outside an integer range, for which static_cast is undefined, saturate.
+  Saturate = 1,     ///< Out of range values clamp to the destination's limits and fractions are discarded. Finite float64 values clamp to the finite float32 range.
+  RoundSaturate = 2 ///< Like Saturate but floating point values are rounded to the nearest integer, ties to even, instead of truncated.
+};
+
+/**
+ * @brief Converts count values of sourceType read from source into values of destinationType written to destination.
+ * source and destination must not overlap. Common widening and narrowing conversions between float32, float64 and
+ * 8, 16 and 32 bit integers use AVX2 when available and large arrays are split across threads through
+ * ParallelDataAlgorithm. Throws std::runtime_error if either type is not a valid DataType.
+ * @param sourceType
+ * @param source
+ * @param destinationType
+ * @param destination
+ * @param count
+ * @param mode
+ */
+NXCOMMON_EXPORT void ConvertValues(DataType sourceType, const void* source, DataType destinationType, void* destination, usize count, ConversionMode mode = ConversionMode::Saturate);
+
+/**
+ * @brief Converts every value of source into the value at the same index of destination. The spans must be the same
+ * size and must not overlap. Throws std::invalid_argument if the sizes differ.
+ * See ConvertValues(DataType, const void*, DataType, void*, usize, ConversionMode).
+ * @tparam T Any type of NX::DataType
+ * @tparam U Any type of NX::DataType
+ * @param source
+ * @param destination
+ * @param mode
+ */
+template <class T, class U>
+void ConvertValues(nonstd::span<T> source, nonstd::span<U> destination, ConversionMode mode = ConversionMode::Saturate)
+{
+  static_assert(!std::is_const_v<U>, "ConvertValues: Destination cannot be const");
+  if(source.size() != destination.size())
+  {
+    throw std::invalid_argument("ConvertValues: Source and destination must be the same size");
+  }
+  ConvertValues(GetDataType<std::remove_cv_t<T>>(), source.data(), GetDataType<U>(), destination.data(), source.size(), mode);
+}
+} // namespace NX::Common
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "NX/Common/Types.hpp"
+#include "NX/Common/TypesUtility.hpp"
+
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace NX::Common
+{
+/**
+ * @brief The types associated with each DataType, in the order of the enumerators.
+ */
+using DataTypeList = std::tuple<int8, uint8, int16, uint16, int32, uint32, int64, uint64, float32, float64, bool>;
+
+/**
+ * @brief Number of DataType enumerators.
+ */
+inline constexpr usize k_NumDataTypes = std::tuple_size_v<DataTypeList>;
+
+/**
+ * @brief The type associated with the given DataType. The inverse of GetDataType<T>().
+ * @tparam Type
+ */
+template <DataType Type>
+using DataTypeToType = std::tuple_element_t<static_cast<usize>(Type), DataTypeList>;
+
+namespace detail
+{
+template <usize... I>
+constexpr bool CheckDataTypeList(std::index_sequence<I...>)
+{
+  return ((GetDataType<std::tuple_element_t<I, DataTypeList>>() == static_cast<DataType>(I)) && ...);
+}
+
+static_assert(CheckDataTypeList(std::make_index_sequence<k_NumDataTypes>{}), "DataTypeList must follow the order of DataType");
+
+template <class FuncT, class T, class... ArgsT>
+decltype(auto) InvokeForType(FuncT&& func, ArgsT&&... args)
+{
+  return std::forward<FuncT>(func).template operator()<T>(std::forward<ArgsT>(args)...);
+}
+
+template <class FuncT, class T, class U, class... ArgsT>
+decltype(auto) InvokeForTypes(FuncT&& func, ArgsT&&... args)
+{
+  return std::forward<FuncT>(func).template operator()<T, U>(std::forward<ArgsT>(args)...);
+}
+
+template <class FuncT, class... ArgsT, usize... I>
+decltype(auto) DispatchDataTypeImpl(std::index_sequence<I...>, usize index, FuncT&& func, ArgsT&&... args)
+{
+  using ReturnT = decltype(InvokeForType<FuncT, DataTypeToType<DataType::int8>, ArgsT...>(std::declval<FuncT>(), std::declval<ArgsT>()...));
+  static_assert((std::is_same_v<ReturnT, decltype(InvokeForType<FuncT, DataTypeToType<static_cast<DataType>(I)>, ArgsT...>(std::declval<FuncT>(), std::declval<ArgsT>()...))> && ...),
+                "DispatchDataType: The functor must return the same type for every DataType");
+  using EntryT = ReturnT (*)(FuncT&&, ArgsT&&...);
+  static constexpr EntryT k_Table[] = {&InvokeForType<FuncT, DataTypeToType<static_cast<DataType>(I)>, ArgsT...>...};
+  return k_Table[index](std::forward<FuncT>(func), std::forward<ArgsT>(args)...);
+}
+
+template <class FuncT, class... ArgsT, usize... I>
+decltype(auto) DispatchDataTypesImpl(std::index_sequence<I...>, usize index, FuncT&& func, ArgsT&&... args)
+{
+  using ReturnT = decltype(InvokeForTypes<FuncT, DataTypeToType<DataType::int8>, DataTypeToType<DataType::int8>, ArgsT...>(std::declval<FuncT>(), std::declval<ArgsT>()...));
+  static_assert((std::is_same_v<ReturnT, decltype(InvokeForTypes<FuncT, DataTypeToType<static_cast<DataType>(I / k_NumDataTypes)>, DataTypeToType<static_cast<DataType>(I % k_NumDataTypes)>,
+                                                                 ArgsT...>(std::declval<FuncT>(), std::declval<ArgsT>()...))> &&
+                 ...),
+                "DispatchDataTypes: The functor must return the same type for every pair of DataTypes");
+  using EntryT = ReturnT (*)(FuncT&&, ArgsT&&...);
+  static constexpr EntryT k_Table[] = {
+      &InvokeForTypes<FuncT, DataTypeToType<static_cast<DataType>(I / k_NumDataTypes)>, DataTypeToType<static_cast<DataType>(I % k_NumDataTypes)>, ArgsT...>...};
+  return k_Table[index](std::forward<FuncT>(func), std::forward<ArgsT>(args)...);
+}
+
+inline usize DataTypeIndex(DataType dataType)
+{
+  const auto index = static_cast<usize>(dataType);
+  if(index >= k_NumDataTypes)
+  {
+    throw std::runtime_error("DispatchDataType: Unsupported DataType");
+  }
+  return index;
+}
+} // namespace detail
+
+/**
+ * @brief Calls func.template operator()<T>(args...) where T is the type associated with dataType and returns its result.
+ * The functor is instantiated once for every DataType and the call goes through a constexpr table of those
+ * instantiations instead of a switch. Every instantiation must return the same type.
+ * Throws std::runtime_error if dataType is not a valid DataType.
+ *
+ * struct TypeSize
+ * {
+ *   template <class T>
+ *   usize operator()() const
+ *   {
+ *     return sizeof(T);
+ *   }
+ * };
+ * usize size = DispatchDataType(DataType::float32, TypeSize{});
+ * @tparam FuncT
+ * @tparam ArgsT
+ * @param dataType
+ * @param func
+ * @param args
+ * @return The result of func
+ */
+template <class FuncT, class... ArgsT>
+decltype(auto) DispatchDataType(DataType dataType, FuncT&& func, ArgsT&&... args)
+{
+  return detail::DispatchDataTypeImpl(std::make_index_sequence<k_NumDataTypes>{}, detail::DataTypeIndex(dataType), std::forward<FuncT>(func), std::forward<ArgsT>(args)...);
+}
+
+/**
+ * @brief Calls func.template operator()<T, U>(args...) where T and U are the types associated with firstType and
+ * secondType, for example the source and destination types of a conversion. All k_NumDataTypes * k_NumDataTypes
+ * pairs are instantiated. Every instantiation must return the same type.
+ * Throws std::runtime_error if either type is not a valid DataType.
+ * @tparam FuncT
+ * @tparam ArgsT
+ * @param firstType
+ * @param secondType
+ * @param func
+ * @param args
+ * @return The result of func
+ */
+template <class FuncT, class... ArgsT>
+decltype(auto) DispatchDataTypes(DataType firstType, DataType secondType, FuncT&& func, ArgsT&&... args)
+{
+  const usize index = detail::DataTypeIndex(firstType) * k_NumDataTypes + detail::DataTypeIndex(secondType);
+  return detail::DispatchDataTypesImpl(std::make_index_sequence<k_NumDataTypes * k_NumDataTypes>{}, index, std::forward<FuncT>(func), std::forward<ArgsT>(args)...);
+}
+} // namespace NX::Common
@@ -1,14 +1,98 @@
 #pragma once
 
+#include "NX/Common/AlignedSpan.hpp"
 #include "NX/Common/Bit.hpp"
+#include "NX/Common/Byteswap.hpp"
+#include "NX/Common/MemoryMappedFile.hpp"
+#include "NX/Common/MemoryResource.hpp"
+#include "NX/Common/ParallelDataAlgorithm.hpp"
 #include "NX/Common/Types.hpp"
 
 #include "nonstd/span.hpp"
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <iterator>
 #include <memory>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 
 namespace NX::Common
 {
+/**
+ * @brief Controls how DataVector initializes newly allocated elements.
+ */
+enum class InitializationMode : uint8
+{
+  Value = 0,         ///< Elements are value initialized, i.e. zeroed for arithmetic types.
+  Uninitialized = 1, ///< Elements are default initialized. Arithmetic types are left with indeterminate values that must be overwritten before being read.
+  ParallelFill = 2   ///< Elements are value initialized in parallel so that each page is first touched by a worker thread rather than the allocating thread.
+};
+
+namespace detail
+{
+/**
+ * @brief Number of elements below which DataVector fills are done serially.
+ */
+inline constexpr uint64 k_ParallelFillThreshold = 1ull << 16;
+
+/**
+ * @brief Assigns value to [data, data + size). Large ranges are split across threads through ParallelDataAlgorithm.
+ * @tparam T
+ * @param data
+ * @param size
+ * @param value
+ */
+template <class T>
+void ParallelFill(T* data, uint64 size, const T& value)
+{
+  ParallelDataAlgorithm algorithm(Range(0, size));
+  algorithm.setGrain(k_ParallelFillThreshold / 4);
+  algorithm.setParallelizationEnabled(size >= k_ParallelFillThreshold);
+  algorithm.execute([data, &value](const Range& range) { std::fill(data + range.min(), data + range.max(), value); });
+}
+
+/**
+ * @brief Copies count elements from source to destination. Trivially copyable types are copied as a single block.
+ * The ranges must not overlap.
+ * @tparam T
+ * @param source
+ * @param count
+ * @param destination
+ */
+template <class T>
+void CopyElements(const T* source, uint64 count, T* destination)
+{
+  if constexpr(std::is_trivially_copyable_v<T>)
+  {
+    if(count > 0)
+    {
+      std::memcpy(destination, source, count * sizeof(T));
+    }
+  }
+  else
+  {
+    std::copy(source, source + count, destination);
+  }
+}
+} // namespace detail
+
+/**
+ * @brief Alignment policy for the heap storage of DataVector<T>. Arithmetic types are aligned to a full cache line so
+ * that SIMD kernels can use aligned loads and parallel chunks of whole cache lines never share a line. Specialize
+ * this for other types that benefit from stricter alignment.
+ * @tparam T
+ */
+template <class T>
+struct DataVectorAlignment
+{
+  static inline constexpr usize value = std::is_arithmetic_v<T> ? std::max(k_CacheLineSize, alignof(T)) : alignof(T);
+};
+
 template <typename T>
 class DataVector
 {
@@ -16,6 +100,14 @@ public:
   /////////////////////////////////
   // Begin std::iterator support //
   /////////////////////////////////
+  class ConstIterator;
+
+  /**
+   * @brief Iterator is a thin wrapper around a raw pointer into the DataVector so that standard
+   * algorithms compile to the same loops as they would over T*. When NXCOMMON_ENABLE_CHECKED_ITERATORS
+   * is defined the iterator also stores the bounds of its DataVector and throws std::out_of_range on
+   * invalid dereferences, arithmetic and comparisons.
+   */
   class Iterator
   {
   public:
@@ -28,15 +120,26 @@ public:
     /**
      * @brief Default iterator required for some standard library algorithm implementations.
      */
-    Iterator()
-    : m_DataVector(nullptr)
+    Iterator() = default;
 
+    /**
+     * @brief Constructs an iterator pointing at ptr within [begin, end).
+     * The bounds are only used when NXCOMMON_ENABLE_CHECKED_ITERATORS is defined.
+     * @param ptr
+     * @param begin
+     * @param end
+     */
+    Iterator(pointer ptr, [[maybe_unused]] pointer begin, [[maybe_unused]] pointer end)
+    : m_Ptr(ptr)
+#ifdef NXCOMMON_ENABLE_CHECKED_ITERATORS
+    , m_Begin(begin)
+    , m_End(end)
+#endif
     {
     }
 
-    Iterator(DataVector& DataVector, uint64 index)
-    : m_DataVector(&DataVector)
-    , m_Index(index)
+    Iterator(DataVector& dataVector, uint64 index)
+    : Iterator(dataVector.data() + index, dataVector.data(), dataVector.data() + dataVector.size())
     {
     }
 
@@ -48,41 +151,44 @@ public:
 
     ~Iterator() noexcept = default;
 
-    bool isValid() const
+    Iterator operator+(difference_type offset) const
     {
-      if(m_DataVector == nullptr)
-      {
-        return false;
-      }
-      return m_Index < m_DataVector->size();
+      Iterator iter = *this;
+      iter += offset;
+      return iter;
     }
 
-    Iterator operator+(NX::usize offset) const
+    friend Iterator operator+(difference_type offset, const Iterator& iter)
     {
-      return Iterator(*m_DataVector, m_Index + offset);
+      return iter + offset;
     }
 
-    Iterator operator-(usize offset) const
+    Iterator operator-(difference_type offset) const
     {
-      return Iterator(*m_DataVector, m_Index - offset);
+      Iterator iter = *this;
+      iter -= offset;
+      return iter;
     }
 
-    Iterator& operator+=(usize offset)
+    Iterator& operator+=(difference_type offset)
     {
-      m_Index += offset;
+      m_Ptr += offset;
+      checkInRange();
       return *this;
     }
 
-    Iterator& operator-=(usize offset)
+    Iterator& operator-=(difference_type offset)
     {
-      m_Index -= offset;
+      m_Ptr -= offset;
+      checkInRange();
       return *this;
     }
 
     // prefix
     Iterator& operator++()
     {
-      m_Index++;
+      ++m_Ptr;
+      checkInRange();
       return *this;
     }
 
@@ -90,14 +196,15 @@ public:
     Iterator operator++(int)
     {
       Iterator iter = *this;
-      m_Index++;
+      ++(*this);
       return iter;
     }
 
     // prefix
     Iterator& operator--()
     {
-      m_Index--;
+      --m_Ptr;
+      checkInRange();
       return *this;
     }
 
@@ -105,31 +212,38 @@ public:
     Iterator operator--(int)
     {
       Iterator iter = *this;
-      m_Index--;
+      --(*this);
       return iter;
     }
 
     difference_type operator-(const Iterator& rhs) const
     {
-      return m_Index - rhs.m_Index;
+      checkCompatible(rhs);
+      return m_Ptr - rhs.m_Ptr;
     }
 
     reference operator*() const
     {
-      return (*m_DataVector)[m_Index];
+      checkDereferenceable(m_Ptr);
+      return *m_Ptr;
+    }
+
+    pointer operator->() const
+    {
+      checkDereferenceable(m_Ptr);
+      return m_Ptr;
+    }
+
+    reference operator[](difference_type offset) const
+    {
+      checkDereferenceable(m_Ptr + offset);
+      return m_Ptr[offset];
     }
 
     bool operator==(const Iterator& rhs) const
     {
-      if(!isValid() && !rhs.isValid())
-      {
-        return true;
-      }
-      if(!isValid() || !rhs.isValid())
-      {
-        return false;
-      }
-      return (m_DataVector == rhs.m_DataVector) && (m_Index == rhs.m_Index);
+      checkCompatible(rhs);
+      return m_Ptr == rhs.m_Ptr;
     }
 
     bool operator!=(const Iterator& rhs) const
@@ -139,29 +253,76 @@ public:
 
     bool operator<(const Iterator& rhs) const
     {
-      return m_Index < rhs.m_Index;
+      checkCompatible(rhs);
+      return m_Ptr < rhs.m_Ptr;
     }
 
     bool operator>(const Iterator& rhs) const
     {
-      return m_Index > rhs.m_Index;
+      return rhs < *this;
     }
 
     bool operator<=(const Iterator& rhs) const
     {
-      return m_Index <= rhs.m_Index;
+      return !(rhs < *this);
     }
 
     bool operator>=(const Iterator& rhs) const
     {
-      return m_Index >= rhs.m_Index;
+      return !(*this < rhs);
     }
 
   private:
-    DataVector* m_DataVector = nullptr;
-    uint64 m_Index = 0;
+    friend class ConstIterator;
+
+#ifdef NXCOMMON_ENABLE_CHECKED_ITERATORS
+    void checkInRange() const
+    {
+      if(m_Ptr < m_Begin || m_Ptr > m_End)
+      {
+        throw std::out_of_range("DataVector::Iterator: Iterator moved outside of its DataVector");
+      }
+    }
+
+    void checkDereferenceable(pointer ptr) const
+    {
+      if(ptr < m_Begin || ptr >= m_End)
+      {
+        throw std::out_of_range("DataVector::Iterator: Cannot dereference an iterator outside of its DataVector");
+      }
+    }
+
+    void checkCompatible(const Iterator& rhs) const
+    {
+      if(m_Begin != rhs.m_Begin || m_End != rhs.m_End)
+      {
+        throw std::out_of_range("DataVector::Iterator: Cannot compare iterators from different DataVectors");
+      }
+    }
+#else
+    void checkInRange() const
+    {
+    }
+
+    void checkDereferenceable(pointer) const
+    {
+    }
+
+    void checkCompatible(const Iterator&) const
+    {
+    }
+#endif
+
+    pointer m_Ptr = nullptr;
+#ifdef NXCOMMON_ENABLE_CHECKED_ITERATORS
+    pointer m_Begin = nullptr;
+    pointer m_End = nullptr;
+#endif
   };
 
+  /**
+   * @brief Const counterpart of Iterator. Implicitly constructible from an Iterator.
+   */
   class ConstIterator
   {
   public:
@@ -174,15 +335,35 @@ public:
     /**
      * @brief Default iterator required for some standard library algorithm implementations.
      */
-    ConstIterator()
-    : m_DataVector(nullptr)
+    ConstIterator() = default;
 
+    /**
+     * @brief Constructs an iterator pointing at ptr within [begin, end).
+     * The bounds are only used when NXCOMMON_ENABLE_CHECKED_ITERATORS is defined.
+     * @param ptr
+     * @param begin
+     * @param end
+     */
+    ConstIterator(pointer ptr, [[maybe_unused]] pointer begin, [[maybe_unused]] pointer end)
+    : m_Ptr(ptr)
+#ifdef NXCOMMON_ENABLE_CHECKED_ITERATORS
+    , m_Begin(begin)
+    , m_End(end)
+#endif
     {
     }
 
     ConstIterator(const DataVector& dataVector, uint64 index)
-    : m_DataVector(&dataVector)
-    , m_Index(index)
+    : ConstIterator(dataVector.data() + index, dataVector.data(), dataVector.data() + dataVector.size())
+    {
+    }
+
+    ConstIterator(const Iterator& iter)
+    : m_Ptr(iter.m_Ptr)
+#ifdef NXCOMMON_ENABLE_CHECKED_ITERATORS
+    , m_Begin(iter.m_Begin)
+    , m_End(iter.m_End)
+#endif
     {
     }
 
@@ -194,56 +375,60 @@ public:
 
     ~ConstIterator() noexcept = default;
 
-    bool isValid() const
+    ConstIterator operator+(difference_type offset) const
     {
-      if(m_DataVector == nullptr)
-      {
-        return false;
-      }
-      return m_Index < m_DataVector->size();
+      ConstIterator iter = *this;
+      iter += offset;
+      return iter;
     }
 
-    ConstIterator operator+(usize offset) const
+    friend ConstIterator operator+(difference_type offset, const ConstIterator& iter)
     {
-      return ConstIterator(*m_DataVector, m_Index + offset);
+      return iter + offset;
     }
 
-    ConstIterator operator-(usize offset) const
+    ConstIterator operator-(difference_type offset) const
     {
-      return ConstIterator(*m_DataVector, m_Index - offset);
+      ConstIterator iter = *this;
+      iter -= offset;
+      return iter;
     }
 
-    ConstIterator& operator+=(usize offset)
+    ConstIterator& operator+=(difference_type offset)
     {
-      m_Index += offset;
+      m_Ptr += offset;
+      checkInRange();
       return *this;
     }
 
-    ConstIterator& operator-=(usize offset)
+    ConstIterator& operator-=(difference_type offset)
     {
-      m_Index -= offset;
+      m_Ptr -= offset;
+      checkInRange();
       return *this;
     }
 
     // prefix
     ConstIterator& operator++()
     {
-      m_Index++;
+      ++m_Ptr;
+      checkInRange();
       return *this;
     }
 
     // postfix
     ConstIterator operator++(int)
     {
-      Iterator iter = *this;
-      m_Index++;
+      ConstIterator iter = *this;
+      ++(*this);
       return iter;
     }
 
     // prefix
     ConstIterator& operator--()
     {
-      m_Index--;
+      --m_Ptr;
+      checkInRange();
       return *this;
     }
 
@@ -251,35 +436,38 @@ public:
     ConstIterator operator--(int)
     {
       ConstIterator iter = *this;
-      m_Index--;
+      --(*this);
       return iter;
     }
 
     difference_type operator-(const ConstIterator& rhs) const
     {
-      if(!isValid() && !rhs.isValid())
-      {
-        return 0;
-      }
-      return m_Index - rhs.m_Index;
+      checkCompatible(rhs);
+      return m_Ptr - rhs.m_Ptr;
     }
 
     reference operator*() const
     {
-      return (*m_DataVector)[m_Index];
+      checkDereferenceable(m_Ptr);
+      return *m_Ptr;
+    }
+
+    pointer operator->() const
+    {
+      checkDereferenceable(m_Ptr);
+      return m_Ptr;
+    }
+
+    reference operator[](difference_type offset) const
+    {
+      checkDereferenceable(m_Ptr + offset);
+      return m_Ptr[offset];
     }
 
     bool operator==(const ConstIterator& rhs) const
     {
-      if(!isValid() && !rhs.isValid())
-      {
-        return true;
-      }
-      if(!isValid() || !rhs.isValid())
-      {
-        return false;
-      }
-      return (m_DataVector == rhs.m_DataVector) && (m_Index == rhs.m_Index);
+      checkCompatible(rhs);
+      return m_Ptr == rhs.m_Ptr;
     }
 
     bool operator!=(const ConstIterator& rhs) const
@@ -289,32 +477,76 @@ public:
 
     bool operator<(const ConstIterator& rhs) const
     {
-      return m_Index < rhs.m_Index;
+      checkCompatible(rhs);
+      return m_Ptr < rhs.m_Ptr;
     }
 
     bool operator>(const ConstIterator& rhs) const
     {
-      return m_Index > rhs.m_Index;
+      return rhs < *this;
     }
 
     bool operator<=(const ConstIterator& rhs) const
     {
-      return m_Index <= rhs.m_Index;
+      return !(rhs < *this);
     }
 
     bool operator>=(const ConstIterator& rhs) const
     {
-      return m_Index >= rhs.m_Index;
+      return !(*this < rhs);
     }
 
   private:
-    const DataVector* m_DataVector = nullptr;
-    uint64 m_Index = 0;
+#ifdef NXCOMMON_ENABLE_CHECKED_ITERATORS
+    void checkInRange() const
+    {
+      if(m_Ptr < m_Begin || m_Ptr > m_End)
+      {
+        throw std::out_of_range("DataVector::ConstIterator: Iterator moved outside of its DataVector");
+      }
+    }
+
+    void checkDereferenceable(pointer ptr) const
+    {
+      if(ptr < m_Begin || ptr >= m_End)
+      {
+        throw std::out_of_range("DataVector::ConstIterator: Cannot dereference an iterator outside of its DataVector");
+      }
+    }
+
+    void checkCompatible(const ConstIterator& rhs) const
+    {
+      if(m_Begin != rhs.m_Begin || m_End != rhs.m_End)
+      {
+        throw std::out_of_range("DataVector::ConstIterator: Cannot compare iterators from different DataVectors");
+      }
+    }
+#else
+    void checkInRange() const
+    {
+    }
+
+    void checkDereferenceable(pointer) const
+    {
+    }
+
+    void checkCompatible(const ConstIterator&) const
+    {
+    }
+#endif
+
+    pointer m_Ptr = nullptr;
+#ifdef NXCOMMON_ENABLE_CHECKED_ITERATORS
+    pointer m_Begin = nullptr;
+    pointer m_End = nullptr;
+#endif
   };
   ///////////////////////////////
   // End std::iterator support //
   ///////////////////////////////
 
+  using iterator = Iterator;
+  using const_iterator = ConstIterator;
   using value_type = T;
   using size_type = uint64;
   using reference = value_type&;
@@ -322,6 +554,11 @@ public:
   using pointer = T*;
   using const_pointer = const T*;
 
+  /**
+   * @brief Alignment in bytes of heap storage allocated by the DataVector. See DataVectorAlignment.
+   */
+  static inline constexpr usize k_Alignment = DataVectorAlignment<T>::value;
+
 #if 0
   DataVector()
   : m_Size(0)
@@ -331,13 +568,58 @@ public:
 #endif
 
   /**
-   * @brief Constructs a DataVector with the given number of elements.
+   * @brief Constructs a DataVector with the given number of value initialized elements.
    * @param numElements
    */
   DataVector(size_type numElements)
+  : DataVector(numElements, InitializationMode::Value, GetDefaultMemoryResource())
+  {
+  }
+
+  /**
+   * @brief Constructs a DataVector with the given number of value initialized elements.
+   * The storage is allocated from resource, which must outlive the DataVector.
+   * Only pointers to a MemoryResource select this overload, so DataVector<float32>(10, 0) fills with the value 0
+   * instead of being ambiguous with a null resource.
+   * @tparam Resource
+   * @param numElements
+   * @param resource
+   */
+  template <class Resource, class = std::enable_if_t<std::is_convertible_v<Resource*, MemoryResource*>>>
+  DataVector(size_type numElements, Resource* resource)
+  : DataVector(numElements, InitializationMode::Value, resource)
+  {
+  }
+
+  /**
+   * @brief Constructs a DataVector with the given number of elements initialized according to initMode.
+   * InitializationMode::Uninitialized skips the zeroing pass entirely for callers that overwrite every element.
+   * The storage is allocated from resource, which must outlive the DataVector.
+   * @param numElements
+   * @param initMode
+   * @param resource
+   */
+  DataVector(size_type numElements, InitializationMode initMode, MemoryResource* resource = GetDefaultMemoryResource())
   : m_Size(numElements)
-  , m_Data(std::make_unique<value_type[]>(numElements))
+  , m_Resource(resource)
   {
+    replaceStorage(allocateStorage(numElements), numElements);
+    initialize(0, numElements, initMode);
+  }
+
+  /**
+   * @brief Constructs a DataVector with the given number of elements all set to value.
+   * Large vectors are filled in parallel. The storage is allocated from resource, which must outlive the DataVector.
+   * @param numElements
+   * @param value
+   * @param resource
+   */
+  DataVector(size_type numElements, const value_type& value, MemoryResource* resource = GetDefaultMemoryResource())
+  : m_Size(numElements)
+  , m_Resource(resource)
+  {
+    replaceStorage(allocateStorage(numElements), numElements);
+    detail::ParallelFill(m_Data, m_Size, value);
   }
 
   /**
@@ -348,35 +630,192 @@ public:
    */
   DataVector(size_type numElements, std::unique_ptr<value_type[]> buffer)
   : m_Size(numElements)
-  , m_Data(std::move(buffer))
+  , m_Capacity(numElements)
+  , m_Data(buffer.get())
+  , m_ExternalOwner(std::shared_ptr<value_type[]>(std::move(buffer)))
+  {
+  }
+
+  /**
+   * @brief Constructs a DataVector that takes ownership of a buffer released through a custom deleter,
+   * such as one returned by a C library. The elements are not copied.
+   * The provided number of elements must no larger than the number of elements in the buffer.
+   * @tparam Deleter
+   * @param numElements
+   * @param buffer
+   */
+  template <class Deleter>
+  DataVector(size_type numElements, std::unique_ptr<value_type[], Deleter> buffer)
+  : m_Size(numElements)
+  , m_Capacity(numElements)
+  , m_Data(buffer.get())
+  , m_ExternalOwner(std::shared_ptr<value_type>(buffer.release(), std::move(buffer.get_deleter())))
+  {
+  }
+
+  /**
+   * @brief Constructs a DataVector backed by a memory mapped file. Elements are read directly from the
+   * mapped pages, so nothing is loaded until it is accessed. Writing to the DataVector is only valid if the
+   * file was mapped with MemoryMappedFile::Access::CopyOnWrite or MemoryMappedFile::Access::ReadWrite.
+   * If numElements is not given, as many whole elements as fit after byteOffset are used.
+   * Throws std::runtime_error if the requested elements do not fit in the mapping or are misaligned.
+   * @param mappedFile
+   * @param byteOffset Offset in bytes from the start of the mapping
+   * @param numElements
+   */
+  explicit DataVector(std::shared_ptr<MemoryMappedFile> mappedFile, uint64 byteOffset = 0, std::optional<size_type> numElements = {})
+  : m_MappedFile(std::move(mappedFile))
   {
+    static_assert(std::is_trivially_copyable_v<value_type>, "DataVector: file backed storage requires a trivially copyable type");
+
+    if(m_MappedFile == nullptr)
+    {
+      throw std::runtime_error("DataVector: Memory mapped file cannot be null");
+    }
+    const uint64 mappedSize = m_MappedFile->size();
+    if(byteOffset > mappedSize)
+    {
+      throw std::runtime_error("DataVector: Byte offset is past the end of the memory mapped file");
+    }
+    const size_type availableElements = (mappedSize - byteOffset) / sizeof(value_type);
+    m_Size = numElements.value_or(availableElements);
+    if(m_Size > availableElements)
+    {
+      throw std::runtime_error("DataVector: Requested elements do not fit in the memory mapped file");
+    }
+    m_Capacity = m_Size;
+    if(m_Size == 0)
+    {
+      return;
+    }
+    std::byte* address = m_MappedFile->data() + byteOffset;
+    if(reinterpret_cast<std::uintptr_t>(address) % alignof(value_type) != 0)
+    {
+      throw std::runtime_error("DataVector: Byte offset is not aligned for the value type");
+    }
+    m_Data = reinterpret_cast<pointer>(address);
   }
 
   /**
-   * @brief Constructs a copy of the target DataVector
+   * @brief Constructs a copy of the target DataVector. Like std::pmr containers, the copy allocates from the
+   * default memory resource rather than the resource of other. Copy-on-write storage from another resource, such as
+   * an arena, is copied rather than shared, so the copy may safely outlive the arena.
+   * The copy always uses heap storage, even if the target is file backed.
    * @param other
    */
   DataVector(const DataVector& other)
+  : DataVector(other, GetDefaultMemoryResource())
+  {
+  }
+
+  /**
+   * @brief Constructs a copy of the target DataVector allocated from resource.
+   * If other is copy-on-write, the copy is too. It shares the storage of other if that storage was allocated from
+   * resource until either of them is modified.
+   * @param other
+   * @param resource
+   */
+  DataVector(const DataVector& other, MemoryResource* resource)
   : m_Size(other.m_Size)
-  , m_Data(std::make_unique<value_type[]>(other.m_Size))
+  , m_Resource(resource)
+  , m_CopyOnWrite(other.m_CopyOnWrite)
   {
-    for(size_type i = 0; i < m_Size; i++)
+    if(other.canShareStorage(resource))
     {
-      m_Data.get()[i] = other.m_Data.get()[i];
+      m_Capacity = other.m_Capacity;
+      m_Data = other.m_Data;
+      m_ExternalOwner = other.m_ExternalOwner;
+      return;
     }
+    replaceStorage(copyToNewStorage(other.m_Data, other.m_Size, other.m_Size), other.m_Size);
   }
 
   /**
-   * @brief Move constructor
+   * @brief Move constructor. The memory resource moves along with the storage.
    * @param other
    */
   DataVector(DataVector&& other) noexcept
-  : m_Size(other.m_Size)
-  , m_Data(std::move(other.m_Data))
+  : m_Size(std::exchange(other.m_Size, 0))
+  , m_Capacity(std::exchange(other.m_Capacity, 0))
+  , m_Data(std::exchange(other.m_Data, nullptr))
+  , m_Resource(other.m_Resource)
+  , m_OwnsStorage(std::exchange(other.m_OwnsStorage, false))
+  , m_CopyOnWrite(other.m_CopyOnWrite)
+  , m_ExternalOwner(std::move(other.m_ExternalOwner))
+  , m_MappedFile(std::move(other.m_MappedFile))
+  {
+  }
+
+  ~DataVector() noexcept
+  {
+    releaseStorage();
+  }
+
+  /**
+   * @brief Returns a DataVector that takes ownership of data without copying it. deleter is invoked with data
+   * once the DataVector, or storage it was moved into, is destroyed, reallocated or reassigned.
+   * If allocating the bookkeeping for the deleter throws, deleter is invoked before the exception propagates.
+   * @tparam Deleter Callable with a pointer
+   * @param data
+   * @param numElements
+   * @param deleter
+   * @return DataVector
+   */
+  template <class Deleter>
+  static DataVector Adopt(pointer data, size_type numElements, Deleter deleter)
+  {
+    return DataVector(numElements, data, std::shared_ptr<value_type>(data, std::move(deleter)));
+  }
+
+  /**
+   * @brief Returns a DataVector over data that keeps owner alive for as long as it uses data. This lets a buffer
+   * belonging to another object, such as a decompressor or a Python array, be used without copying it.
+   * @tparam Owner
+   * @param data
+   * @param numElements
+   * @param owner
+   * @return DataVector
+   */
+  template <class Owner>
+  static DataVector Share(pointer data, size_type numElements, std::shared_ptr<Owner> owner)
+  {
+    if(owner == nullptr)
+    {
+      throw std::runtime_error("DataVector: Shared owner cannot be null");
+    }
+    return DataVector(numElements, data, std::shared_ptr<void>(std::move(owner)));
+  }
+
+  /**
+   * @brief Returns a DataVector that refers to data without owning it. The caller must keep data alive for as long
+   * as the DataVector uses it. Growing the DataVector copies the elements to heap storage, after which data is no longer used.
+   * @param data
+   * @param numElements
+   * @return DataVector
+   */
+  static DataVector View(pointer data, size_type numElements)
   {
+    return DataVector(numElements, data, nullptr);
   }
 
-  ~DataVector() noexcept = default;
+  /**
+   * @brief Maps a raw binary file and returns a DataVector backed by it. See MemoryMappedFile for the meaning of each access mode.
+   * Throws std::runtime_error if the file cannot be mapped.
+   * @param path
+   * @param access
+   * @param byteOffset Offset in bytes from the start of the file
+   * @param numElements If not given, as many whole elements as fit after byteOffset are used.
+   * @return DataVector
+   */
+  static DataVector MapFile(const std::filesystem::path& path, MemoryMappedFile::Access access, uint64 byteOffset = 0, std::optional<size_type> numElements = {})
+  {
+    std::optional<uint64> length;
+    if(numElements.has_value())
+    {
+      length = *numElements * sizeof(value_type);
+    }
+    return DataVector(std::make_shared<MemoryMappedFile>(path, access, byteOffset, length), 0, numElements);
+  }
 
   /**
    * @brief Returns the number of elements in the DataVector.
@@ -387,33 +826,200 @@ public:
     return m_Size;
   }
 
+  /**
+   * @brief Returns true if the DataVector is backed by a memory mapped file rather than heap storage.
+   * @return bool
+   */
+  bool isFileBacked() const
+  {
+    return m_MappedFile != nullptr;
+  }
+
+  /**
+   * @brief Returns true if the DataVector refers to storage it neither allocated nor keeps alive. See View().
+   * @return bool
+   */
+  bool isView() const
+  {
+    return m_Data != nullptr && !m_OwnsStorage && m_ExternalOwner == nullptr && m_MappedFile == nullptr;
+  }
+
+  /**
+   * @brief Returns the memory mapped file backing the DataVector or nullptr if it uses heap storage.
+   * @return std::shared_ptr<MemoryMappedFile>
+   */
+  std::shared_ptr<MemoryMappedFile> mappedFile() const
+  {
+    return m_MappedFile;
+  }
+
+  /**
+   * @brief Writes modified values back to the backing file. Does nothing unless the DataVector is backed
+   * by a file mapped with MemoryMappedFile::Access::ReadWrite.
+   */
+  void flush()
+  {
+    if(m_MappedFile != nullptr)
+    {
+      m_MappedFile->flush();
+    }
+  }
+
+  /**
+   * @brief Returns the memory resource heap storage is allocated from.
+   * @return MemoryResource*
+   */
+  MemoryResource* memoryResource() const
+  {
+    return m_Resource;
+  }
+
+  /**
+   * @brief Returns true if copies of the DataVector share its storage until one of them is modified.
+   * @return bool
+   */
+  bool isCopyOnWrite() const
+  {
+    return m_CopyOnWrite;
+  }
+
+  /**
+   * @brief Enables or disables copy-on-write. While enabled, copying the DataVector only increments a reference
+   * count if the copy uses the same memory resource. The non-const data(), operator[], begin(), end(), createSpan(),
+   * fill(), byteswap() and growing resize() first give the DataVector its own copy of shared storage, so pointers,
+   * references and iterators taken from it never write to another copy. Taking the pointer or span once before a loop
+   * or parallel region keeps that check out of the loop; call makeUnique() before handing the DataVector itself to
+   * parallel writers. Copies of a copy-on-write DataVector are copy-on-write.
+   * File backed and view storage is never shared; copying such a DataVector always copies its elements.
+   * While copy-on-write is enabled, storage shared through Share() counts as shared whenever another owner reference exists.
+   * Disabling copy-on-write first makes the storage unique.
+   * @param enabled
+   */
+  void setCopyOnWrite(bool enabled)
+  {
+    if(enabled == m_CopyOnWrite)
+    {
+      return;
+    }
+    if(!enabled)
+    {
+      detach(true);
+      m_CopyOnWrite = false;
+      return;
+    }
+    m_CopyOnWrite = true;
+    shareOwnedStorage();
+  }
+
+  /**
+   * @brief Returns true if the storage is currently shared with another copy-on-write DataVector or external owner.
+   * @return bool
+   */
+  bool isShared() const
+  {
+    return m_CopyOnWrite && m_ExternalOwner.use_count() > 1;
+  }
+
+  /**
+   * @brief Gives the DataVector its own copy of its storage if it is shared copy-on-write storage. Non-const element
+   * access does this as well; calling it up front avoids copying inside a parallel region. Does nothing otherwise.
+   */
+  void makeUnique()
+  {
+    detach(true);
+  }
+
+  /**
+   * @brief Returns the number of elements that can be held without reallocating.
+   * A file backed DataVector has no spare capacity.
+   * @return size_type
+   */
+  size_type capacity() const
+  {
+    return m_Capacity;
+  }
+
   /**
    * @brief Resizes the DataVector and copies existing values where applicable.
+   * Shrinking is done in place. Growing within capacity() is done in place; otherwise the
+   * capacity grows geometrically so repeated growth is amortized linear.
+   * Elements added by growing are initialized according to initMode.
+   * Growing a file backed DataVector, or one over external storage from Adopt(), Share() or View(), moves it to heap
+   * storage even after it was shrunk.
+   * Growing a DataVector with shared copy-on-write storage copies it first.
    * @param numElements
+   * @param initMode
    */
-  void resize(size_type numElements)
+  void resize(size_type numElements, InitializationMode initMode = InitializationMode::Value)
   {
     if(numElements == m_Size)
     {
       return;
     }
 
-    auto newData = std::make_unique<value_type[]>(numElements);
-    for(size_type i = 0; i < m_Size && i < numElements; i++)
+    if(numElements < m_Size)
     {
-      newData.get()[i] = m_Data.get()[i];
+      m_Size = numElements;
+      if(!m_OwnsStorage && !canShareStorage(m_Resource))
+      {
+        // Storage the DataVector did not allocate has no spare capacity, so growing back copies rather than
+        // overwriting elements of the caller's buffer
+        m_Capacity = m_Size;
+      }
+      return;
     }
+
+    if(numElements > m_Capacity || isShared())
+    {
+      reallocate(std::max(numElements, m_Capacity + m_Capacity / 2));
+    }
+    const size_type oldSize = m_Size;
     m_Size = numElements;
-    m_Data = std::move(newData);
+    initialize(oldSize, numElements - oldSize, initMode);
+  }
+
+  /**
+   * @brief Increases capacity() to at least numElements without changing size().
+   * Does nothing if the capacity is already large enough.
+   * @param numElements
+   */
+  void reserve(size_type numElements)
+  {
+    if(numElements > m_Capacity)
+    {
+      reallocate(numElements);
+    }
+  }
+
+  /**
+   * @brief Reallocates heap storage so that capacity() equals size(). Does nothing for file backed storage.
+   */
+  void shrink_to_fit()
+  {
+    if((m_OwnsStorage || canShareStorage(m_Resource)) && m_Capacity > m_Size)
+    {
+      reallocate(m_Size);
+    }
+  }
+
+  /**
+   * @brief Assigns value to every element. Large vectors are filled in parallel.
+   * @param value
+   */
+  void fill(const value_type& value)
+  {
+    detach(false);
+    detail::ParallelFill(m_Data, m_Size, value);
   }
 
   /**
-   * @brief Returns a pointer to the underlying data.
+   * @brief Returns a pointer to the underlying data. Shared copy-on-write storage is copied first.
    * @return pointer
    */
   pointer data()
   {
-    return m_Data.get();
+    detach(true);
+    return m_Data;
   }
 
   /**
@@ -421,17 +1027,18 @@ public:
    */
   const_pointer data() const
   {
-    return m_Data.get();
+    return m_Data;
   }
 
   /**
-   * @brief Returns a reference to the value at the target index.
+   * @brief Returns a reference to the value at the target index. Shared copy-on-write storage is copied first.
    * @param index
    * @return reference
    */
   reference operator[](size_type index)
   {
-    return m_Data.get()[index];
+    detach(true);
+    return m_Data[index];
   }
 
   /**
@@ -441,7 +1048,7 @@ public:
    */
   const_reference operator[](size_type index) const
   {
-    return m_Data.get()[index];
+    return m_Data[index];
   }
 
   /**
@@ -456,7 +1063,7 @@ public:
     {
       throw std::runtime_error("Cannot reference value out of DataVect bounds");
     }
-    return m_Data.get()[index];
+    return m_Data[index];
   }
 
   /**
@@ -464,15 +1071,11 @@ public:
    */
   void byteswap()
   {
-    pointer rawPtr = data();
-    for(value_type& value : *this)
-    {
-      value = NX::Common::byteswap(value);
-    }
+    BulkByteswap(createSpan());
   }
 
   /**
-   * @brief Creates and returns a span wrapping the current data.
+   * @brief Creates and returns a span wrapping the current data. The data is aligned to at least alignment() bytes.
    * @return nonstd::span<T>
    */
   nonstd::span<T> createSpan()
@@ -481,7 +1084,7 @@ public:
   }
 
   /**
-   * @brief Creates and returns a span wrapping the current data.
+   * @brief Creates and returns a span wrapping the current data. The data is aligned to at least alignment() bytes.
    * @return nonstd::span<const T>
    */
   nonstd::span<const T> createSpan() const
@@ -489,13 +1092,53 @@ public:
     return {data(), m_Size};
   }
 
+  /**
+   * @brief Creates and returns a span that carries the alignment of the current data in its type.
+   * Heap storage always satisfies the default of k_Alignment. Throws std::runtime_error if the data is less aligned
+   * than Alignment, which can only happen for file backed storage.
+   * @tparam Alignment
+   * @return AlignedSpan<T, Alignment>
+   */
+  template <usize Alignment = k_Alignment>
+  AlignedSpan<T, Alignment> createAlignedSpan()
+  {
+    return AlignedSpan<T, Alignment>(createSpan());
+  }
+
+  /**
+   * @brief Creates and returns a span that carries the alignment of the current data in its type. See createAlignedSpan().
+   * @tparam Alignment
+   * @return AlignedSpan<const T, Alignment>
+   */
+  template <usize Alignment = k_Alignment>
+  AlignedSpan<const T, Alignment> createAlignedSpan() const
+  {
+    return AlignedSpan<const T, Alignment>(createSpan());
+  }
+
+  /**
+   * @brief Returns the largest power of two, up to k_Alignment, that data() is guaranteed to be a multiple of.
+   * This is always k_Alignment for heap storage.
+   * @return usize
+   */
+  usize alignment() const
+  {
+    if(m_OwnsStorage || m_Data == nullptr)
+    {
+      return k_Alignment;
+    }
+    const auto address = reinterpret_cast<std::uintptr_t>(m_Data);
+    return std::min<usize>(address & (~address + 1), k_Alignment);
+  }
+
   /**
    * @brief Returns an Iterator to the begining of the DataVector.
    * @return Iterator
    */
   Iterator begin()
   {
-    return Iterator(*this, 0);
+    detach(true);
+    return Iterator(m_Data, m_Data, m_Data + m_Size);
   }
 
   /**
@@ -504,7 +1147,8 @@ public:
    */
   Iterator end()
   {
-    return Iterator(*this, size());
+    detach(true);
+    return Iterator(m_Data + m_Size, m_Data, m_Data + m_Size);
   }
 
   /**
@@ -513,7 +1157,7 @@ public:
    */
   ConstIterator begin() const
   {
-    return ConstIterator(*this, 0);
+    return ConstIterator(m_Data, m_Data, m_Data + m_Size);
   }
 
   /**
@@ -522,7 +1166,7 @@ public:
    */
   ConstIterator end() const
   {
-    return ConstIterator(*this, size());
+    return ConstIterator(m_Data + m_Size, m_Data, m_Data + m_Size);
   }
 
   /**
@@ -544,40 +1188,292 @@ public:
   }
 
   /**
-   * @brief Copy operator
+   * @brief Copy operator. The memory resource of the DataVector is kept, and like the copy constructor it only shares
+   * copy-on-write storage of rhs that was allocated from that resource.
    * @param rhs
    * @return DataVector&
    */
   DataVector& operator=(const DataVector& rhs)
   {
+    if(this == &rhs)
+    {
+      return *this;
+    }
+
+    m_CopyOnWrite = rhs.m_CopyOnWrite;
+    if(rhs.canShareStorage(m_Resource))
+    {
+      releaseStorage();
+      m_Size = rhs.m_Size;
+      m_Capacity = rhs.m_Capacity;
+      m_Data = rhs.m_Data;
+      m_ExternalOwner = rhs.m_ExternalOwner;
+      return *this;
+    }
+
+    // Reuse the existing heap buffer when it is large enough. The memory resource is never replaced.
     const size_type newSize = rhs.m_Size;
-    auto newData = std::make_unique<value_type[]>(newSize);
-    for(size_type i = 0; i < newSize; i++)
+    if(!m_OwnsStorage || newSize > m_Capacity)
+    {
+      replaceStorage(copyToNewStorage(rhs.m_Data, newSize, newSize), newSize);
+    }
+    else
     {
-      newData.get()[i] = rhs.m_Data.get()[i];
+      detail::CopyElements(rhs.m_Data, newSize, m_Data);
     }
     m_Size = newSize;
-    m_Data = std::move(newData);
+    if(m_CopyOnWrite)
+    {
+      // A reused buffer was owned outright, so wrap it as the copy constructor's storage would have been
+      shareOwnedStorage();
+    }
 
     return *this;
   }
 
   /**
-   * @brief Move operator
+   * @brief Move operator. The memory resource moves along with the storage.
    * @param rhs
    * @return DataVector&
    */
   DataVector& operator=(DataVector&& rhs) noexcept
   {
-    m_Size = rhs.m_Size;
-    m_Data = std::move(rhs.m_Data);
+    if(this == &rhs)
+    {
+      return *this;
+    }
+
+    releaseStorage();
+    m_Size = std::exchange(rhs.m_Size, 0);
+    m_Capacity = std::exchange(rhs.m_Capacity, 0);
+    m_Data = std::exchange(rhs.m_Data, nullptr);
+    m_Resource = rhs.m_Resource;
+    m_OwnsStorage = std::exchange(rhs.m_OwnsStorage, false);
+    m_CopyOnWrite = rhs.m_CopyOnWrite;
+    m_ExternalOwner = std::move(rhs.m_ExternalOwner);
+    m_MappedFile = std::move(rhs.m_MappedFile);
 
     return *this;
   }
 
 private:
-  size_type m_Size;
-  std::unique_ptr<value_type[]> m_Data = nullptr;
+  /**
+   * @brief Initializes count elements starting at offset according to initMode. The elements must already be default initialized.
+   * @param offset
+   * @param count
+   * @param initMode
+   */
+  void initialize(size_type offset, size_type count, InitializationMode initMode)
+  {
+    switch(initMode)
+    {
+    case InitializationMode::Value:
+      std::fill(m_Data + offset, m_Data + offset + count, value_type{});
+      break;
+    case InitializationMode::Uninitialized:
+      break;
+    case InitializationMode::ParallelFill:
+      detail::ParallelFill(m_Data + offset, count, value_type{});
+      break;
+    }
+  }
+
+  /**
+   * @brief Constructs a DataVector over external storage kept alive by owner, which may be null for a view.
+   * @param numElements
+   * @param data
+   * @param owner
+   */
+  DataVector(size_type numElements, pointer data, std::shared_ptr<void> owner)
+  : m_Size(numElements)
+  , m_Capacity(numElements)
+  , m_Data(data)
+  , m_ExternalOwner(std::move(owner))
+  {
+  }
+
+  /**
+   * @brief Allocates capacity default initialized elements from the memory resource.
+   * Returns nullptr if capacity is 0.
+   * @param capacity
+   * @return pointer
+   */
+  pointer allocateStorage(size_type capacity)
+  {
+    if(capacity == 0)
+    {
+      return nullptr;
+    }
+    auto* storage = static_cast<pointer>(m_Resource->allocate(capacity * sizeof(value_type), k_Alignment));
+    if constexpr(!std::is_trivially_default_constructible_v<value_type>)
+    {
+      try
+      {
+        std::uninitialized_default_construct(storage, storage + capacity);
+      } catch(...)
+      {
+        m_Resource->deallocate(storage, capacity * sizeof(value_type), k_Alignment);
+        throw;
+      }
+    }
+    return storage;
+  }
+
+  /**
+   * @brief Allocates capacity elements and copies the count elements at source into them. The new storage is
+   * released again if copying throws, so nothing leaks before replaceStorage() takes it over.
+   * @param source
+   * @param count Must be at most capacity
+   * @param capacity
+   * @return pointer
+   */
+  pointer copyToNewStorage(const_pointer source, size_type count, size_type capacity)
+  {
+    std::unique_ptr<value_type, StorageDeleter> storage(allocateStorage(capacity), StorageDeleter{m_Resource, capacity});
+    detail::CopyElements(source, count, storage.get());
+    return storage.release();
+  }
+
+  /**
+   * @brief Destroys and deallocates storage previously returned by allocateStorage.
+   * @param resource
+   * @param storage
+   * @param capacity
+   */
+  static void destroyStorage(MemoryResource* resource, pointer storage, size_type capacity) noexcept
+  {
+    std::destroy(storage, storage + capacity);
+    resource->deallocate(storage, capacity * sizeof(value_type), k_Alignment);
+  }
+
+  /**
+   * @brief Releases storage previously returned by allocateStorage, either once the last copy-on-write DataVector
+   * sharing it is done with it or when filling new storage throws.
+   */
+  struct StorageDeleter
+  {
+    MemoryResource* resource = nullptr;
+    size_type capacity = 0;
+
+    void operator()(pointer storage) const noexcept
+    {
+      destroyStorage(resource, storage, capacity);
+    }
+  };
+
+  /**
+   * @brief Wraps storage previously returned by allocateStorage in a reference count for copy-on-write sharing.
+   * If allocating the reference count throws, storage is destroyed before the exception propagates.
+   * @param storage
+   * @param capacity
+   * @return std::shared_ptr<void>
+   */
+  std::shared_ptr<void> makeSharedStorage(pointer storage, size_type capacity) const
+  {
+    return std::shared_ptr<value_type>(storage, StorageDeleter{m_Resource, capacity});
+  }
+
+  /**
+   * @brief Releases the current storage and takes ownership of storage previously returned by allocateStorage.
+   * Copy-on-write DataVectors hold the new storage through a reference count.
+   * @param storage
+   * @param capacity
+   */
+  void replaceStorage(pointer storage, size_type capacity)
+  {
+    std::shared_ptr<void> owner;
+    if(m_CopyOnWrite && storage != nullptr)
+    {
+      owner = makeSharedStorage(storage, capacity);
+    }
+    releaseStorage();
+    m_Data = storage;
+    m_Capacity = capacity;
+    m_OwnsStorage = !m_CopyOnWrite;
+    m_ExternalOwner = std::move(owner);
+  }
+
+  /**
+   * @brief Returns true if copies of the DataVector that allocate from resource may share its storage.
+   * Storage is only shared within one resource so that no copy depends on the lifetime of another resource.
+   * @param resource
+   * @return bool
+   */
+  bool canShareStorage(MemoryResource* resource) const
+  {
+    return m_CopyOnWrite && m_ExternalOwner != nullptr && resource == m_Resource;
+  }
+
+  /**
+   * @brief Moves owned storage behind a reference count so that copy-on-write copies can share it.
+   */
+  void shareOwnedStorage()
+  {
+    if(!m_OwnsStorage || m_Data == nullptr)
+    {
+      return;
+    }
+    // The storage is handed over before wrapping it since makeSharedStorage destroys it on failure,
+    // which leaves the DataVector empty rather than double freeing.
+    m_OwnsStorage = false;
+    const pointer storage = std::exchange(m_Data, nullptr);
+    const size_type capacity = std::exchange(m_Capacity, 0);
+    const size_type size = std::exchange(m_Size, 0);
+    m_ExternalOwner = makeSharedStorage(storage, capacity);
+    m_Data = storage;
+    m_Capacity = capacity;
+    m_Size = size;
+  }
+
+  /**
+   * @brief Gives the DataVector its own copy of its storage if it is shared copy-on-write storage.
+   * @param preserveElements If false the elements are left default initialized because the caller overwrites them all.
+   */
+  void detach(bool preserveElements)
+  {
+    if(!m_CopyOnWrite || m_ExternalOwner.use_count() <= 1)
+    {
+      return;
+    }
+    pointer newData = preserveElements ? copyToNewStorage(m_Data, m_Size, m_Size) : allocateStorage(m_Size);
+    replaceStorage(newData, m_Size);
+  }
+
+  /**
+   * @brief Destroys and deallocates owned storage or drops the reference to external storage.
+   * Leaves size() untouched.
+   */
+  void releaseStorage() noexcept
+  {
+    if(m_OwnsStorage && m_Data != nullptr)
+    {
+      destroyStorage(m_Resource, m_Data, m_Capacity);
+    }
+    m_Data = nullptr;
+    m_Capacity = 0;
+    m_OwnsStorage = false;
+    m_ExternalOwner.reset();
+    m_MappedFile.reset();
+  }
+
+  /**
+   * @brief Moves the elements to newly allocated storage of newCapacity elements. The storage is default
+   * initialized so only elements beyond the copied ones are left for initialize().
+   * @param newCapacity Must be at least size()
+   */
+  void reallocate(size_type newCapacity)
+  {
+    replaceStorage(copyToNewStorage(m_Data, m_Size, newCapacity), newCapacity);
+  }
+
+  size_type m_Size = 0;
+  size_type m_Capacity = 0;
+  pointer m_Data = nullptr;
+  MemoryResource* m_Resource = GetDefaultMemoryResource();
+  bool m_OwnsStorage = false;
+  bool m_CopyOnWrite = false;
+  std::shared_ptr<void> m_ExternalOwner = nullptr;
+  std::shared_ptr<MemoryMappedFile> m_MappedFile = nullptr;
 };
 
 template <typename Iter>
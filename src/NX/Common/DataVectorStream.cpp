@@ -0,0 +1,150 @@
+#include "NX/Common/DataVectorStream.hpp"
+
+#include <fmt/format.h>
+
+#include <cerrno>
+#include <climits>
+#include <cstring>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace NX::Common::detail
+{
+namespace
+{
+constexpr int32 k_ReadError = -9100;
+constexpr int32 k_UnexpectedEndOfFileError = -9101;
+constexpr int32 k_WriteError = -9102;
+
+// Keeps each system call within the range every platform can report back
+constexpr usize k_MaxBytesPerCall = 1ull << 30;
+
+#ifdef _WIN32
+int64 ReadSome(int fileDescriptor, std::byte* destination, usize numBytes)
+{
+  return _read(fileDescriptor, destination, static_cast<unsigned int>(numBytes));
+}
+
+int64 WriteSome(int fileDescriptor, const std::byte* source, usize numBytes)
+{
+  return _write(fileDescriptor, source, static_cast<unsigned int>(numBytes));
+}
+#else
+int64 ReadSome(int fileDescriptor, std::byte* destination, usize numBytes)
+{
+  return ::read(fileDescriptor, destination, numBytes);
+}
+
+int64 WriteSome(int fileDescriptor, const std::byte* source, usize numBytes)
+{
+  return ::write(fileDescriptor, source, numBytes);
+}
+#endif
+} // namespace
+
+Result<> ReadBytes(int fileDescriptor, std::byte* destination, usize numBytes)
+{
+  usize bytesRead = 0;
+  while(bytesRead < numBytes)
+  {
+    const int64 result = ReadSome(fileDescriptor, destination + bytesRead, std::min(numBytes - bytesRead, k_MaxBytesPerCall));
+    if(result < 0)
+    {
+      if(errno == EINTR)
+      {
+        continue;
+      }
+      return MakeErrorResult(k_ReadError, fmt::format("Failed to read from file descriptor {}: {}", fileDescriptor, std::strerror(errno)));
+    }
+    if(result == 0)
+    {
+      return MakeErrorResult(k_UnexpectedEndOfFileError, fmt::format("Reached the end of file descriptor {} after {} of {} bytes", fileDescriptor, bytesRead, numBytes));
+    }
+    bytesRead += static_cast<usize>(result);
+  }
+  return {};
+}
+
+Result<> WriteBytes(int fileDescriptor, const std::byte* source, usize numBytes)
+{
+  usize bytesWritten = 0;
+  while(bytesWritten < numBytes)
+  {
+    const int64 result = WriteSome(fileDescriptor, source + bytesWritten, std::min(numBytes - bytesWritten, k_MaxBytesPerCall));
+    if(result < 0)
+    {
+      if(errno == EINTR)
+      {
+        continue;
+      }
+      return MakeErrorResult(k_WriteError, fmt::format("Failed to write to file descriptor {}: {}", fileDescriptor, std::strerror(errno)));
+    }
+    bytesWritten += static_cast<usize>(result);
+  }
+  return {};
+}
+
+BlockIoThread::BlockIoThread()
+: m_Thread([this]() { run(); })
+{
+}
+
+BlockIoThread::~BlockIoThread() noexcept
+{
+  {
+    std::unique_lock lock(m_Mutex);
+    m_Condition.wait(lock, [this]() { return !m_Busy; });
+    m_Stopping = true;
+  }
+  m_Condition.notify_all();
+  m_Thread.join();
+}
+
+void BlockIoThread::submit(Job job)
+{
+  {
+    std::lock_guard lock(m_Mutex);
+    m_Job = std::move(job);
+    m_Result.reset();
+    m_Busy = true;
+  }
+  m_Condition.notify_all();
+}
+
+Result<> BlockIoThread::wait()
+{
+  std::unique_lock lock(m_Mutex);
+  m_Condition.wait(lock, [this]() { return !m_Busy; });
+  if(!m_Result.has_value())
+  {
+    return {};
+  }
+  Result<> result = std::move(*m_Result);
+  m_Result.reset();
+  return result;
+}
+
+void BlockIoThread::run()
+{
+  std::unique_lock lock(m_Mutex);
+  while(true)
+  {
+    m_Condition.wait(lock, [this]() { return m_Busy || m_Stopping; });
+    if(!m_Busy)
+    {
+      return;
+    }
+    Job job = std::move(m_Job);
+    lock.unlock();
+    Result<> result = job();
+    lock.lock();
+    m_Result = std::move(result);
+    m_Busy = false;
+    m_Condition.notify_all();
+  }
+}
+} // namespace NX::Common::detail
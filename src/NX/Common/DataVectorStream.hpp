@@ -0,0 +1,238 @@
+#pragma once
+
+#include "NX/Common/Bit.hpp"
+#include "NX/Common/Byteswap.hpp"
+#include "NX/Common/DataVector.hpp"
+#include "NX/Common/NXCommon_export.hpp"
+#include "NX/Common/Result.hpp"
+#include "NX/Common/Types.hpp"
+
+#include "nonstd/span.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+
+namespace NX::Common
+{
+/**
+ * @brief Default number of bytes transferred per block by the streaming functions.
+ */
+inline constexpr usize k_DefaultStreamBlockSize = 4ull << 20;
+
+namespace detail
+{
+/**
+ * @brief Reads exactly numBytes from the current position of fileDescriptor, retrying on short reads.
+ * Fails if the end of the file is reached first.
+ * @param fileDescriptor
+ * @param destination
+ * @param numBytes
+ * @return Result<>
+ */
+NXCOMMON_EXPORT Result<> ReadBytes(int fileDescriptor, std::byte* destination, usize numBytes);
+
+/**
+ * @brief Writes exactly numBytes to the current position of fileDescriptor, retrying on short writes.
+ * @param fileDescriptor
+ * @param source
+ * @param numBytes
+ * @return Result<>
+ */
+NXCOMMON_EXPORT Result<> WriteBytes(int fileDescriptor, const std::byte* source, usize numBytes);
+
+/**
+ * @class BlockIoThread
+ * @brief BlockIoThread runs the block reads or writes of one streaming call on a single thread that lives for the
+ * whole call, so each block only costs a hand off instead of a thread creation. At most one job is in flight, which
+ * together with the block being processed on the calling thread double buffers the transfer.
+ */
+class NXCOMMON_EXPORT BlockIoThread
+{
+public:
+  using Job = std::function<Result<>()>;
+
+  BlockIoThread();
+
+  /**
+   * @brief Waits for the job in flight and joins the thread.
+   */
+  ~BlockIoThread() noexcept;
+
+  BlockIoThread(const BlockIoThread&) = delete;
+  BlockIoThread(BlockIoThread&&) = delete;
+  BlockIoThread& operator=(const BlockIoThread&) = delete;
+  BlockIoThread& operator=(BlockIoThread&&) = delete;
+
+  /**
+   * @brief Starts job on the I/O thread. The previous job must have been waited on.
+   * @param job
+   */
+  void submit(Job job);
+
+  /**
+   * @brief Waits for the job in flight and returns its result, or an empty result if there is none.
+   * @return Result<>
+   */
+  Result<> wait();
+
+private:
+  void run();
+
+  std::mutex m_Mutex;
+  std::condition_variable m_Condition;
+  Job m_Job;
+  std::optional<Result<>> m_Result;
+  bool m_Busy = false;
+  bool m_Stopping = false;
+  std::thread m_Thread;
+};
+
+template <class T>
+usize ElementsPerBlock(usize blockSize)
+{
+  return std::max<usize>(blockSize / sizeof(T), 1);
+}
+} // namespace detail
+
+/**
+ * @brief Fills values from the current position of fileDescriptor. If fileEndian differs from the native byte order,
+ * the file is read in blocks of blockSize bytes directly into values and each block is byteswapped in place while the
+ * next block is being read, so no extra copy of the data is ever made.
+ * @tparam T
+ * @param fileDescriptor
+ * @param values
+ * @param fileEndian Byte order of the values stored in the file
+ * @param blockSize
+ * @return Result<>
+ */
+template <class T>
+Result<> ReadRawData(int fileDescriptor, nonstd::span<T> values, endian fileEndian = endian::native, usize blockSize = k_DefaultStreamBlockSize)
+{
+  static_assert(std::is_arithmetic_v<T>, "ReadRawData only works on arithmetic types");
+
+  auto* bytes = reinterpret_cast<std::byte*>(values.data());
+  if(fileEndian == endian::native || sizeof(T) == 1)
+  {
+    return detail::ReadBytes(fileDescriptor, bytes, values.size() * sizeof(T));
+  }
+
+  const usize elementsPerBlock = detail::ElementsPerBlock<T>(blockSize);
+  const usize numElements = values.size();
+  auto readBlock = [fileDescriptor, bytes, numElements, elementsPerBlock](usize start) {
+    const usize count = std::min(elementsPerBlock, numElements - start);
+    return detail::ReadBytes(fileDescriptor, bytes + start * sizeof(T), count * sizeof(T));
+  };
+
+  if(numElements == 0)
+  {
+    return {};
+  }
+  detail::BlockIoThread ioThread;
+  ioThread.submit([&readBlock]() { return readBlock(0); });
+  for(usize start = 0; start < numElements; start += elementsPerBlock)
+  {
+    Result<> readResult = ioThread.wait();
+    if(readResult.invalid())
+    {
+      return readResult;
+    }
+
+    const usize next = start + elementsPerBlock;
+    if(next < numElements)
+    {
+      ioThread.submit([&readBlock, next]() { return readBlock(next); });
+    }
+
+    BulkByteswap(values.subspan(start, std::min(elementsPerBlock, numElements - start)));
+  }
+
+  return {};
+}
+
+/**
+ * @brief Writes values to the current position of fileDescriptor. If fileEndian differs from the native byte order,
+ * each block of blockSize bytes is byteswapped into one of two staging buffers while the previous block is being
+ * written, so at most two blocks of extra memory are used.
+ * @tparam T
+ * @param fileDescriptor
+ * @param values
+ * @param fileEndian Byte order to store the values with in the file
+ * @param blockSize
+ * @return Result<>
+ */
+template <class T>
+Result<> WriteRawData(int fileDescriptor, nonstd::span<const T> values, endian fileEndian = endian::native, usize blockSize = k_DefaultStreamBlockSize)
+{
+  static_assert(std::is_arithmetic_v<T>, "WriteRawData only works on arithmetic types");
+
+  if(fileEndian == endian::native || sizeof(T) == 1)
+  {
+    return detail::WriteBytes(fileDescriptor, reinterpret_cast<const std::byte*>(values.data()), values.size() * sizeof(T));
+  }
+
+  const usize numElements = values.size();
+  const usize elementsPerBlock = std::min(detail::ElementsPerBlock<T>(blockSize), numElements);
+  DataVector<T> stagingBuffers[2] = {DataVector<T>(elementsPerBlock, InitializationMode::Uninitialized), DataVector<T>(elementsPerBlock, InitializationMode::Uninitialized)};
+
+  if(numElements == 0)
+  {
+    return {};
+  }
+  detail::BlockIoThread ioThread;
+  usize bufferIndex = 0;
+  for(usize start = 0; start < numElements; start += elementsPerBlock)
+  {
+    const usize count = std::min(elementsPerBlock, numElements - start);
+    DataVector<T>& staging = stagingBuffers[bufferIndex];
+    BulkByteswap<T>(values.subspan(start, count), staging.createSpan().first(count));
+
+    Result<> writeResult = ioThread.wait();
+    if(writeResult.invalid())
+    {
+      return writeResult;
+    }
+    const auto* stagingBytes = reinterpret_cast<const std::byte*>(staging.data());
+    ioThread.submit([fileDescriptor, stagingBytes, count]() { return detail::WriteBytes(fileDescriptor, stagingBytes, count * sizeof(T)); });
+    bufferIndex = 1 - bufferIndex;
+  }
+
+  return ioThread.wait();
+}
+
+/**
+ * @brief Fills every element of dataVector from the current position of fileDescriptor. See ReadRawData.
+ * Shared copy-on-write storage is made unique first.
+ * @tparam T
+ * @param fileDescriptor
+ * @param dataVector
+ * @param fileEndian Byte order of the values stored in the file
+ * @param blockSize
+ * @return Result<>
+ */
+template <class T>
+Result<> ReadDataVector(int fileDescriptor, DataVector<T>& dataVector, endian fileEndian = endian::native, usize blockSize = k_DefaultStreamBlockSize)
+{
+  dataVector.makeUnique();
+  return ReadRawData(fileDescriptor, dataVector.createSpan(), fileEndian, blockSize);
+}
+
+/**
+ * @brief Writes every element of dataVector to the current position of fileDescriptor. See WriteRawData.
+ * @tparam T
+ * @param fileDescriptor
+ * @param dataVector
+ * @param fileEndian Byte order to store the values with in the file
+ * @param blockSize
+ * @return Result<>
+ */
+template <class T>
+Result<> WriteDataVector(int fileDescriptor, const DataVector<T>& dataVector, endian fileEndian = endian::native, usize blockSize = k_DefaultStreamBlockSize)
+{
+  return WriteRawData(fileDescriptor, dataVector.createSpan(), fileEndian, blockSize);
+}
+} // namespace NX::Common
@@ -0,0 +1,515 @@
+#include "NX/Common/Hash.hpp"
+
+#include "NX/Common/Bit.hpp"
+#include "NX/Common/CpuFeatures.hpp"
+#include "NX/Common/ParallelDataAlgorithm.hpp"
+
+#if defined(NXCOMMON_ARCH_X86)
+#include <immintrin.h>
+#endif
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#include <intrin.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace NX::Common
+{
+namespace
+{
+constexpr uint64 k_Prime32_1 = 0x9E3779B1ull;
+constexpr uint64 k_Prime32_2 = 0x85EBCA77ull;
+constexpr uint64 k_Prime32_3 = 0xC2B2AE3Dull;
+constexpr uint64 k_Prime64_1 = 0x9E3779B185EBCA87ull;
+constexpr uint64 k_Prime64_2 = 0xC2B2AE3D27D4EB4Full;
+constexpr uint64 k_Prime64_3 = 0x165667B19E3779F9ull;
+constexpr uint64 k_Prime64_4 = 0x85EBCA77C2B2AE63ull;
+constexpr uint64 k_Prime64_5 = 0x27D4EB2F165667C5ull;
+
+constexpr usize k_NumLanes = 8;
+constexpr usize k_StripeSize = 64;
+constexpr usize k_StripesPerBlock = 16;
+constexpr usize k_NumSecretWords = 24;
+
+/**
+ * @brief Inputs up to this many bytes are mixed 16 bytes at a time instead of going through the accumulators.
+ */
+constexpr usize k_ShortMaxSize = 240;
+
+// Offsets into the secret. Stripe n of a block uses words [n, n + 8).
+constexpr usize k_ScrambleSecret = 16;
+constexpr usize k_LastStripeSecret = 7;
+constexpr usize k_MergeSecretLow = 1;
+constexpr usize k_MergeSecretHigh = 11;
+
+using Secret = std::array<uint64, k_NumSecretWords>;
+using Accumulators = std::array<uint64, k_NumLanes>;
+
+constexpr Accumulators k_InitialAccumulators = {k_Prime32_3, k_Prime64_1, k_Prime64_2, k_Prime64_3, k_Prime64_4, k_Prime32_2, k_Prime64_5, k_Prime32_1};
+
+constexpr Secret MakeBaseSecret()
+{
+  // splitmix64 so the secret words have no structure
+  Secret secret = {};
+  uint64 state = 0x9E3779B97F4A7C15ull;
+  for(uint64& word : secret)
+  {
+    state += 0x9E3779B97F4A7C15ull;
+    uint64 value = state;
+    value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+    value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+    word = value ^ (value >> 31);
+  }
+  return secret;
+}
+
+constexpr Secret k_BaseSecret = MakeBaseSecret();
+
+Secret MakeSecret(uint64 seed)
+{
+  Secret secret = k_BaseSecret;
+  for(usize i = 0; i < secret.size(); i += 2)
+  {
+    secret[i] += seed;
+    secret[i + 1] -= seed;
+  }
+  return secret;
+}
+
+inline uint64 Read64(const std::byte* data)
+{
+  uint64 value = 0;
+  std::memcpy(&value, data, sizeof(value));
+  if constexpr(endian::native == endian::big)
+  {
+    value = byteswap(value);
+  }
+  return value;
+}
+
+inline uint64 Read32(const std::byte* data)
+{
+  uint32 value = 0;
+  std::memcpy(&value, data, sizeof(value));
+  if constexpr(endian::native == endian::big)
+  {
+    value = byteswap(value);
+  }
+  return value;
+}
+
+/**
+ * @brief Returns the xor of the low and high halves of the 128 bit product.
+ */
+inline uint64 Mul128Fold64(uint64 lhs, uint64 rhs)
+{
+#if defined(__SIZEOF_INT128__)
+  const unsigned __int128 product = static_cast<unsigned __int128>(lhs) * rhs;
+  return static_cast<uint64>(product) ^ static_cast<uint64>(product >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+  uint64 high = 0;
+  const uint64 low = _umul128(lhs, rhs, &high);
+  return low ^ high;
+#else
+  const uint64 lowLow = (lhs & 0xFFFFFFFFull) * (rhs & 0xFFFFFFFFull);
+  const uint64 highLow = (lhs >> 32) * (rhs & 0xFFFFFFFFull);
+  const uint64 lowHigh = (lhs & 0xFFFFFFFFull) * (rhs >> 32);
+  const uint64 highHigh = (lhs >> 32) * (rhs >> 32);
+  const uint64 cross = (lowLow >> 32) + (highLow & 0xFFFFFFFFull) + lowHigh;
+  const uint64 high = highHigh + (highLow >> 32) + (cross >> 32);
+  const uint64 low = (cross << 32) | (lowLow & 0xFFFFFFFFull);
+  return low ^ high;
+#endif
+}
+
+inline uint64 Avalanche(uint64 hash)
+{
+  hash ^= hash >> 37;
+  hash *= 0x165667919E3779F9ull;
+  hash ^= hash >> 32;
+  return hash;
+}
+
+inline uint64 Mix16(const std::byte* data, const uint64* secret)
+{
+  return Mul128Fold64(Read64(data) ^ secret[0], Read64(data + 8) ^ secret[1]);
+}
+
+/**
+ * @brief Hashes inputs of at most k_ShortMaxSize bytes. The low half is the 64 bit hash.
+ */
+Digest128 HashShort(const std::byte* data, usize size, const uint64* secret)
+{
+  if(size <= 16)
+  {
+    uint64 first = 0;
+    uint64 last = 0;
+    if(size >= 8)
+    {
+      first = Read64(data);
+      last = Read64(data + size - 8);
+    }
+    else if(size >= 4)
+    {
+      first = Read32(data);
+      last = Read32(data + size - 4);
+    }
+    else if(size > 0)
+    {
+      first = (std::to_integer<uint64>(data[0]) << 16) | (std::to_integer<uint64>(data[size / 2]) << 8) | std::to_integer<uint64>(data[size - 1]);
+    }
+    return {Avalanche(Mul128Fold64(first ^ secret[0], last ^ secret[1]) + size * k_Prime64_1), Avalanche(Mul128Fold64(first ^ secret[2], last ^ secret[3]) + size * k_Prime64_2)};
+  }
+
+  uint64 low = size * k_Prime64_1;
+  uint64 high = size * k_Prime64_2;
+  // Every full 16 bytes before the last 16, which overlap the previous chunk when size is not a multiple of 16
+  const usize numChunks = (size - 1) / 16;
+  for(usize i = 0; i < numChunks; i++)
+  {
+    low += Mix16(data + 16 * i, secret + i);
+    high += Mix16(data + 16 * i, secret + 8 + i);
+  }
+  low += Mix16(data + size - 16, secret + 15);
+  high += Mix16(data + size - 16, secret + 22);
+  return {Avalanche(low), Avalanche(high)};
+}
+
+using AccumulateFunc = void (*)(uint64*, const std::byte*, usize, const uint64*);
+using ScrambleFunc = void (*)(uint64*, const uint64*);
+
+/**
+ * @brief Folds numStripes stripes into the accumulators, stripe n using the secret words [n, n + 8).
+ * Each lane adds the 64 bit product of the low and high halves of data ^ secret to itself and the raw data to its
+ * neighbor, which keeps the input from cancelling out when the product is zero.
+ */
+void AccumulateScalar(uint64* accumulators, const std::byte* data, usize numStripes, const uint64* secret)
+{
+  for(usize stripe = 0; stripe < numStripes; stripe++)
+  {
+    for(usize lane = 0; lane < k_NumLanes; lane++)
+    {
+      const uint64 value = Read64(data + stripe * k_StripeSize + lane * 8);
+      const uint64 key = value ^ secret[stripe + lane];
+      accumulators[lane ^ 1] += value;
+      accumulators[lane] += (key & 0xFFFFFFFFull) * (key >> 32);
+    }
+  }
+}
+
+void ScrambleScalar(uint64* accumulators, const uint64* secret)
+{
+  for(usize lane = 0; lane < k_NumLanes; lane++)
+  {
+    uint64 value = accumulators[lane];
+    value ^= value >> 47;
+    value ^= secret[lane];
+    value *= k_Prime32_1;
+    accumulators[lane] = value;
+  }
+}
+
+#if defined(NXCOMMON_ARCH_X86)
+NXCOMMON_TARGET("sse2") void AccumulateSse2(uint64* accumulators, const std::byte* data, usize numStripes, const uint64* secret)
+{
+  __m128i lanes[4];
+  for(usize i = 0; i < 4; i++)
+  {
+    lanes[i] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(accumulators + 2 * i));
+  }
+  for(usize stripe = 0; stripe < numStripes; stripe++)
+  {
+    for(usize i = 0; i < 4; i++)
+    {
+      const __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + stripe * k_StripeSize + 16 * i));
+      const __m128i keys = _mm_xor_si128(values, _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret + stripe + 2 * i)));
+      const __m128i product = _mm_mul_epu32(keys, _mm_shuffle_epi32(keys, _MM_SHUFFLE(0, 3, 0, 1)));
+      const __m128i swapped = _mm_shuffle_epi32(values, _MM_SHUFFLE(1, 0, 3, 2));
+      lanes[i] = _mm_add_epi64(lanes[i], _mm_add_epi64(product, swapped));
+    }
+  }
+  for(usize i = 0; i < 4; i++)
+  {
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(accumulators + 2 * i), lanes[i]);
+  }
+}
+
+/**
+ * @brief Multiplies by the 32 bit prime as two 32x32 bit products since there is no 64 bit multiply.
+ */
+NXCOMMON_TARGET("sse2") void ScrambleSse2(uint64* accumulators, const uint64* secret)
+{
+  const __m128i prime = _mm_set1_epi32(static_cast<int32>(k_Prime32_1));
+  for(usize i = 0; i < 4; i++)
+  {
+    __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(accumulators + 2 * i));
+    value = _mm_xor_si128(value, _mm_srli_epi64(value, 47));
+    value = _mm_xor_si128(value, _mm_loadu_si128(reinterpret_cast<const __m128i*>(secret + 2 * i)));
+    const __m128i productLow = _mm_mul_epu32(value, prime);
+    const __m128i productHigh = _mm_mul_epu32(_mm_shuffle_epi32(value, _MM_SHUFFLE(0, 3, 0, 1)), prime);
+    value = _mm_add_epi64(productLow, _mm_slli_epi64(productHigh, 32));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(accumulators + 2 * i), value);
+  }
+}
+
+NXCOMMON_TARGET("avx2") void AccumulateAvx2(uint64* accumulators, const std::byte* data, usize numStripes, const uint64* secret)
+{
+  __m256i lanes[2];
+  for(usize i = 0; i < 2; i++)
+  {
+    lanes[i] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(accumulators + 4 * i));
+  }
+  for(usize stripe = 0; stripe < numStripes; stripe++)
+  {
+    for(usize i = 0; i < 2; i++)
+    {
+      const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + stripe * k_StripeSize + 32 * i));
+      const __m256i keys = _mm256_xor_si256(values, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(secret + stripe + 4 * i)));
+      const __m256i product = _mm256_mul_epu32(keys, _mm256_shuffle_epi32(keys, _MM_SHUFFLE(0, 3, 0, 1)));
+      const __m256i swapped = _mm256_shuffle_epi32(values, _MM_SHUFFLE(1, 0, 3, 2));
+      lanes[i] = _mm256_add_epi64(lanes[i], _mm256_add_epi64(product, swapped));
+    }
+  }
+  for(usize i = 0; i < 2; i++)
+  {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(accumulators + 4 * i), lanes[i]);
+  }
+}
+#endif
+
+struct Kernels
+{
+  AccumulateFunc accumulate = AccumulateScalar;
+  ScrambleFunc scramble = ScrambleScalar;
+};
+
+Kernels SelectKernels()
+{
+  Kernels kernels;
+#if defined(NXCOMMON_ARCH_X86)
+  const CpuFeatures& features = GetCpuFeatures();
+  if(features.sse2)
+  {
+    kernels.accumulate = AccumulateSse2;
+    kernels.scramble = ScrambleSse2;
+  }
+  if(features.avx2)
+  {
+    kernels.accumulate = AccumulateAvx2;
+  }
+#endif
+  return kernels;
+}
+
+const Kernels& GetKernels()
+{
+  static const Kernels kernels = SelectKernels();
+  return kernels;
+}
+
+/**
+ * @brief Folds numStripes stripes into the accumulators, scrambling them after every k_StripesPerBlock stripes.
+ * stripeInBlock carries the position within the current block between calls.
+ */
+void ConsumeStripes(uint64* accumulators, usize& stripeInBlock, const std::byte* data, usize numStripes, const uint64* secret)
+{
+  const Kernels& kernels = GetKernels();
+  while(numStripes > 0)
+  {
+    const usize count = std::min(numStripes, k_StripesPerBlock - stripeInBlock);
+    kernels.accumulate(accumulators, data, count, secret + stripeInBlock);
+    data += count * k_StripeSize;
+    numStripes -= count;
+    stripeInBlock += count;
+    if(stripeInBlock == k_StripesPerBlock)
+    {
+      kernels.scramble(accumulators, secret + k_ScrambleSecret);
+      stripeInBlock = 0;
+    }
+  }
+}
+
+uint64 MergeAccumulators(const uint64* accumulators, const uint64* secret, uint64 start)
+{
+  uint64 result = start;
+  for(usize i = 0; i < k_NumLanes; i += 2)
+  {
+    result += Mul128Fold64(accumulators[i] ^ secret[i], accumulators[i + 1] ^ secret[i + 1]);
+  }
+  return Avalanche(result);
+}
+
+/**
+ * @brief Folds in the final 64 bytes of the input, which may overlap stripes that were already consumed, and merges
+ * the accumulators into the 64 and 128 bit hashes.
+ */
+Digest128 FinishLong(Accumulators accumulators, const std::byte* lastStripe, const uint64* secret, uint64 totalSize)
+{
+  GetKernels().accumulate(accumulators.data(), lastStripe, 1, secret + k_LastStripeSecret);
+  return {MergeAccumulators(accumulators.data(), secret + k_MergeSecretLow, totalSize * k_Prime64_1),
+          MergeAccumulators(accumulators.data(), secret + k_MergeSecretHigh, ~(totalSize * k_Prime64_2))};
+}
+
+Digest128 HashBytes(const void* data, usize size, uint64 seed)
+{
+  const auto* bytes = static_cast<const std::byte*>(data);
+  const Secret secret = MakeSecret(seed);
+  if(size <= k_ShortMaxSize)
+  {
+    return HashShort(bytes, size, secret.data());
+  }
+  Accumulators accumulators = k_InitialAccumulators;
+  usize stripeInBlock = 0;
+  ConsumeStripes(accumulators.data(), stripeInBlock, bytes, (size - 1) / k_StripeSize, secret.data());
+  return FinishLong(accumulators, bytes + size - k_StripeSize, secret.data(), size);
+}
+
+/**
+ * @brief Hashes each k_HashTreeChunkBytes chunk in parallel, then hashes the little endian chunk hashes followed by
+ * the total size.
+ */
+template <bool Is128>
+Digest128 TreeHashBytes(const void* data, usize size, uint64 seed)
+{
+  if(size <= k_HashTreeChunkBytes)
+  {
+    return HashBytes(data, size, seed);
+  }
+
+  const auto* bytes = static_cast<const std::byte*>(data);
+  constexpr usize k_WordsPerChunk = Is128 ? 2 : 1;
+  const usize numChunks = (size + k_HashTreeChunkBytes - 1) / k_HashTreeChunkBytes;
+  std::vector<uint64> words(numChunks * k_WordsPerChunk + 1);
+  ParallelDataAlgorithm algorithm(Range(0, numChunks));
+  algorithm.setGrain(1);
+  algorithm.execute([bytes, size, chunkWords = words.data()](const Range& chunks) {
+    for(usize chunk = chunks.min(); chunk < chunks.max(); chunk++)
+    {
+      const usize offset = chunk * k_HashTreeChunkBytes;
+      const Digest128 hash = HashBytes(bytes + offset, std::min(k_HashTreeChunkBytes, size - offset), 0);
+      chunkWords[chunk * k_WordsPerChunk] = hash.low;
+      if constexpr(Is128)
+      {
+        chunkWords[chunk * k_WordsPerChunk + 1] = hash.high;
+      }
+    }
+  });
+  words.back() = size;
+  if constexpr(endian::native == endian::big)
+  {
+    for(uint64& word : words)
+    {
+      word = byteswap(word);
+    }
+  }
+  return HashBytes(words.data(), words.size() * sizeof(uint64), seed);
+}
+} // namespace
+
+namespace detail
+{
+uint64 HashBytes64(const void* data, usize size, uint64 seed)
+{
+  return HashBytes(data, size, seed).low;
+}
+
+Digest128 HashBytes128(const void* data, usize size, uint64 seed)
+{
+  return HashBytes(data, size, seed);
+}
+
+uint64 TreeHashBytes64(const void* data, usize size, uint64 seed)
+{
+  return TreeHashBytes<false>(data, size, seed).low;
+}
+
+Digest128 TreeHashBytes128(const void* data, usize size, uint64 seed)
+{
+  return TreeHashBytes<true>(data, size, seed);
+}
+} // namespace detail
+
+Hasher::Hasher(uint64 seed)
+{
+  reset(seed);
+}
+
+void Hasher::reset(uint64 seed)
+{
+  m_Accumulators = k_InitialAccumulators;
+  m_Secret = MakeSecret(seed);
+  m_TotalSize = 0;
+  m_BufferedSize = 0;
+  m_StripeInBlock = 0;
+}
+
+void Hasher::update(const void* data, usize size)
+{
+  if(size == 0)
+  {
+    return;
+  }
+  const auto* bytes = static_cast<const std::byte*>(data);
+  m_TotalSize += size;
+  if(m_BufferedSize + size <= k_BufferSize)
+  {
+    std::memcpy(m_Buffer.data() + m_BufferedSize, bytes, size);
+    m_BufferedSize += size;
+    return;
+  }
+
+  // More data follows the buffer so all of its stripes can be consumed. The final stripe is always left for digest.
+  const usize numFillBytes = k_BufferSize - m_BufferedSize;
+  std::memcpy(m_Buffer.data() + m_BufferedSize, bytes, numFillBytes);
+  bytes += numFillBytes;
+  size -= numFillBytes;
+  ConsumeStripes(m_Accumulators.data(), m_StripeInBlock, m_Buffer.data(), k_BufferSize / k_StripeSize, m_Secret.data());
+  std::memcpy(m_LastStripe.data(), m_Buffer.data() + k_BufferSize - k_StripeSize, k_StripeSize);
+
+  if(size > k_BufferSize)
+  {
+    const usize numStripes = (size - 1) / k_StripeSize;
+    ConsumeStripes(m_Accumulators.data(), m_StripeInBlock, bytes, numStripes, m_Secret.data());
+    bytes += numStripes * k_StripeSize;
+    size -= numStripes * k_StripeSize;
+    std::memcpy(m_LastStripe.data(), bytes - k_StripeSize, k_StripeSize);
+  }
+
+  std::memcpy(m_Buffer.data(), bytes, size);
+  m_BufferedSize = size;
+}
+
+uint64 Hasher::digest64() const
+{
+  return digest128().low;
+}
+
+Digest128 Hasher::digest128() const
+{
+  if(m_TotalSize <= k_ShortMaxSize)
+  {
+    return HashShort(m_Buffer.data(), m_BufferedSize, m_Secret.data());
+  }
+
+  Accumulators accumulators = m_Accumulators;
+  usize stripeInBlock = m_StripeInBlock;
+  ConsumeStripes(accumulators.data(), stripeInBlock, m_Buffer.data(), (m_BufferedSize - 1) / k_StripeSize, m_Secret.data());
+
+  // The last 64 bytes may start in the stripe consumed before the buffered bytes
+  std::array<std::byte, k_StripeSize> lastStripe = {};
+  if(m_BufferedSize >= k_StripeSize)
+  {
+    std::memcpy(lastStripe.data(), m_Buffer.data() + m_BufferedSize - k_StripeSize, k_StripeSize);
+  }
+  else
+  {
+    const usize numPreviousBytes = k_StripeSize - m_BufferedSize;
+    std::memcpy(lastStripe.data(), m_LastStripe.data() + m_BufferedSize, numPreviousBytes);
+    std::memcpy(lastStripe.data() + numPreviousBytes, m_Buffer.data(), m_BufferedSize);
+  }
+  return FinishLong(accumulators, lastStripe.data(), m_Secret.data(), m_TotalSize);
+}
+} // namespace NX::Common
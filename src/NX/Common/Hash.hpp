@@ -0,0 +1,199 @@
+#pragma once
+
+#include "NX/Common/DataVector.hpp"
+#include "NX/Common/NXCommon_export.hpp"
+#include "NX/Common/Types.hpp"
+
+#include "nonstd/span.hpp"
+
+#include <array>
+#include <type_traits>
+
+namespace NX::Common
+{
+/**
+ * @brief 128 bit hash value.
+ */
+struct Digest128
+{
+  uint64 low = 0;
+  uint64 high = 0;
+
+  bool operator==(const Digest128& rhs) const
+  {
+    return low == rhs.low && high == rhs.high;
+  }
+
+  bool operator!=(const Digest128& rhs) const
+  {
+    return !(*this == rhs);
+  }
+};
+
+/**
+ * @brief Size of the chunks that TreeHash64 and TreeHash128 hash independently. Fixed so that tree hashes do not depend
+ * on the number of threads.
+ */
+inline constexpr usize k_HashTreeChunkBytes = 1ull << 20;
+
+namespace detail
+{
+NXCOMMON_EXPORT uint64 HashBytes64(const void* data, usize size, uint64 seed);
+NXCOMMON_EXPORT Digest128 HashBytes128(const void* data, usize size, uint64 seed);
+NXCOMMON_EXPORT uint64 TreeHashBytes64(const void* data, usize size, uint64 seed);
+NXCOMMON_EXPORT Digest128 TreeHashBytes128(const void* data, usize size, uint64 seed);
+} // namespace detail
+
+/**
+ * @class Hasher
+ * @brief Hasher computes Hash64 and Hash128 of data that arrives in pieces. The digests of a Hasher fed the same bytes
+ * in any number of update() calls equal the one shot hashes of those bytes.
+ */
+class NXCOMMON_EXPORT Hasher
+{
+public:
+  /**
+   * @brief Constructs a Hasher that has not seen any data.
+   * @param seed
+   */
+  explicit Hasher(uint64 seed = 0);
+
+  ~Hasher() noexcept = default;
+
+  Hasher(const Hasher&) = default;
+  Hasher(Hasher&&) noexcept = default;
+
+  Hasher& operator=(const Hasher&) = default;
+  Hasher& operator=(Hasher&&) noexcept = default;
+
+  /**
+   * @brief Discards all data seen so far and starts over with seed.
+   * @param seed
+   */
+  void reset(uint64 seed = 0);
+
+  /**
+   * @brief Appends size bytes to the hashed data.
+   * @param data
+   * @param size
+   */
+  void update(const void* data, usize size);
+
+  /**
+   * @brief Appends the bytes of values to the hashed data.
+   * @param values
+   */
+  template <class T>
+  void update(nonstd::span<T> values)
+  {
+    static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be hashed as bytes");
+    update(values.data(), values.size_bytes());
+  }
+
+  /**
+   * @brief Returns the 64 bit hash of the data seen so far. More data can be appended afterwards.
+   * @return uint64
+   */
+  uint64 digest64() const;
+
+  /**
+   * @brief Returns the 128 bit hash of the data seen so far. More data can be appended afterwards.
+   * @return Digest128
+   */
+  Digest128 digest128() const;
+
+private:
+  static inline constexpr usize k_NumLanes = 8;
+  static inline constexpr usize k_NumSecretWords = 24;
+  static inline constexpr usize k_StripeSize = 64;
+  static inline constexpr usize k_BufferSize = 4 * k_StripeSize;
+
+  std::array<uint64, k_NumLanes> m_Accumulators = {};
+  std::array<uint64, k_NumSecretWords> m_Secret = {};
+  std::array<std::byte, k_BufferSize> m_Buffer = {};
+  std::array<std::byte, k_StripeSize> m_LastStripe = {};
+  uint64 m_TotalSize = 0;
+  usize m_BufferedSize = 0;
+  usize m_StripeInBlock = 0;
+};
+
+/**
+ * @brief Returns a fast non-cryptographic 64 bit hash of the bytes of values. The construction follows XXH3: 64 byte
+ * stripes are folded into eight accumulators with 32x32 bit multiplies, vectorized with SSE2 or AVX2 where available,
+ * but the values differ from the reference XXH3. Hashes are identical on every platform.
+ * @param values
+ * @param seed
+ * @return uint64
+ */
+template <class T>
+uint64 Hash64(nonstd::span<T> values, uint64 seed = 0)
+{
+  static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be hashed as bytes");
+  return detail::HashBytes64(values.data(), values.size_bytes(), seed);
+}
+
+template <class T>
+uint64 Hash64(const DataVector<T>& values, uint64 seed = 0)
+{
+  return Hash64(values.createSpan(), seed);
+}
+
+/**
+ * @brief Returns a fast non-cryptographic 128 bit hash of the bytes of values. See Hash64.
+ * @param values
+ * @param seed
+ * @return Digest128
+ */
+template <class T>
+Digest128 Hash128(nonstd::span<T> values, uint64 seed = 0)
+{
+  static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be hashed as bytes");
+  return detail::HashBytes128(values.data(), values.size_bytes(), seed);
+}
+
+template <class T>
+Digest128 Hash128(const DataVector<T>& values, uint64 seed = 0)
+{
+  return Hash128(values.createSpan(), seed);
+}
+
+/**
+ * @brief Returns a 64 bit hash of the bytes of values that is computed in parallel. Each k_HashTreeChunkBytes chunk is
+ * hashed with Hash64 and the root is the hash of the chunk hashes, so the result depends only on the data and seed.
+ * Data that fits in a single chunk hashes to the same value as Hash64.
+ * @param values
+ * @param seed
+ * @return uint64
+ */
+template <class T>
+uint64 TreeHash64(nonstd::span<T> values, uint64 seed = 0)
+{
+  static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be hashed as bytes");
+  return detail::TreeHashBytes64(values.data(), values.size_bytes(), seed);
+}
+
+template <class T>
+uint64 TreeHash64(const DataVector<T>& values, uint64 seed = 0)
+{
+  return TreeHash64(values.createSpan(), seed);
+}
+
+/**
+ * @brief Returns a 128 bit hash of the bytes of values that is computed in parallel. See TreeHash64.
+ * @param values
+ * @param seed
+ * @return Digest128
+ */
+template <class T>
+Digest128 TreeHash128(nonstd::span<T> values, uint64 seed = 0)
+{
+  static_assert(std::is_trivially_copyable_v<T>, "Only trivially copyable values can be hashed as bytes");
+  return detail::TreeHashBytes128(values.data(), values.size_bytes(), seed);
+}
+
+template <class T>
+Digest128 TreeHash128(const DataVector<T>& values, uint64 seed = 0)
+{
+  return TreeHash128(values.createSpan(), seed);
+}
+} // namespace NX::Common
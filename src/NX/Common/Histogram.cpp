@@ -0,0 +1,331 @@
+#include "NX/Common/Histogram.hpp"
+
+#include "NX/Common/CpuFeatures.hpp"
+#include "NX/Common/ParallelDataAlgorithm.hpp"
+
+#if defined(NXCOMMON_ARCH_X86)
+#include <immintrin.h>
+#endif
+
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace NX::Common
+{
+namespace
+{
+/**
+ * @brief Inputs smaller than this many values are counted on the calling thread.
+ */
+constexpr usize k_ParallelThreshold = 1ull << 16;
+
+/**
+ * @brief Number of values each parallel task counts.
+ */
+constexpr usize k_ParallelGrain = 1ull << 14;
+
+/**
+ * @brief 8 bit values are counted into this many interleaved tables so that runs of equal values do not
+ * serialize on a single counter.
+ */
+constexpr usize k_NumByteTables = 4;
+
+/**
+ * @brief Every kernel counts into numBins() + 1 slots where the last slot collects values outside the bins.
+ */
+usize NumSlots(const HistogramBins& bins)
+{
+  return bins.numBins() + 1;
+}
+
+/**
+ * @brief Returns the smallest input for which counting per distinct value pays for mapping every possible value to a bin.
+ */
+template <class T>
+constexpr usize DirectThreshold()
+{
+  return sizeof(T) == 1 ? 1ull << 10 : 1ull << 18;
+}
+
+template <class T>
+constexpr bool k_IsDirectIndexable = std::is_integral_v<T> && sizeof(T) <= 2;
+
+template <class T>
+void ScalarKernel(const T* data, usize size, const HistogramBins& bins, uint64* counts)
+{
+  for(usize i = 0; i < size; i++)
+  {
+    counts[bins.binIndex(static_cast<float64>(data[i]))]++;
+  }
+}
+
+#if defined(NXCOMMON_ARCH_X86)
+template <class T>
+NXCOMMON_TARGET("avx2") inline void LoadAvx2(const T* data, __m256d& low, __m256d& high)
+{
+  if constexpr(std::is_same_v<T, float32>)
+  {
+    const __m256 values = _mm256_loadu_ps(data);
+    low = _mm256_cvtps_pd(_mm256_castps256_ps128(values));
+    high = _mm256_cvtps_pd(_mm256_extractf128_ps(values, 1));
+  }
+  else
+  {
+    __m256i values;
+    if constexpr(std::is_same_v<T, uint8>)
+    {
+      values = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(data)));
+    }
+    else
+    {
+      values = _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(data)));
+    }
+    low = _mm256_cvtepi32_pd(_mm256_castsi256_si128(values));
+    high = _mm256_cvtepi32_pd(_mm256_extracti128_si256(values, 1));
+  }
+}
+
+/**
+ * @brief Vector form of HistogramBins::binIndex for uniform bins. Performs the same double precision operations so
+ * both agree on values next to the edges.
+ */
+NXCOMMON_TARGET("avx2") inline __m128i BinIndicesAvx2(__m256d values, __m256d min, __m256d max, __m256d scale, __m256d lastBin, __m256d outside)
+{
+  const __m256d inside = _mm256_and_pd(_mm256_cmp_pd(values, min, _CMP_GE_OQ), _mm256_cmp_pd(values, max, _CMP_LE_OQ));
+  __m256d index = _mm256_min_pd(_mm256_mul_pd(_mm256_sub_pd(values, min), scale), lastBin);
+  index = _mm256_blendv_pd(outside, index, inside);
+  return _mm256_cvttpd_epi32(index);
+}
+
+template <class T>
+NXCOMMON_TARGET("avx2") void UniformAvx2Kernel(const T* data, usize size, const HistogramBins& bins, uint64* counts)
+{
+  const __m256d min = _mm256_set1_pd(bins.min());
+  const __m256d max = _mm256_set1_pd(bins.max());
+  const __m256d scale = _mm256_set1_pd(bins.scale());
+  const __m256d lastBin = _mm256_set1_pd(static_cast<float64>(bins.numBins() - 1));
+  const __m256d outside = _mm256_set1_pd(static_cast<float64>(bins.numBins()));
+
+  alignas(32) int32 indices[8];
+  usize i = 0;
+  for(; i + 8 <= size; i += 8)
+  {
+    __m256d low;
+    __m256d high;
+    LoadAvx2(data + i, low, high);
+    _mm_store_si128(reinterpret_cast<__m128i*>(indices), BinIndicesAvx2(low, min, max, scale, lastBin, outside));
+    _mm_store_si128(reinterpret_cast<__m128i*>(indices + 4), BinIndicesAvx2(high, min, max, scale, lastBin, outside));
+    for(int32 index : indices)
+    {
+      counts[index]++;
+    }
+  }
+  ScalarKernel(data + i, size - i, bins, counts);
+}
+#endif
+
+template <class T>
+using KernelFunc = void (*)(const T*, usize, const HistogramBins&, uint64*);
+
+template <class T>
+KernelFunc<T> SelectKernel(const HistogramBins& bins)
+{
+#if defined(NXCOMMON_ARCH_X86)
+  // Indices go through int32 lanes
+  static const bool hasAvx2 = GetCpuFeatures().avx2;
+  constexpr bool hasSimdLoad = std::is_same_v<T, float32> || std::is_same_v<T, uint8> || std::is_same_v<T, uint16>;
+  if constexpr(hasSimdLoad)
+  {
+    if(hasAvx2 && bins.isUniform() && bins.numBins() < static_cast<usize>(std::numeric_limits<int32>::max()))
+    {
+      return UniformAvx2Kernel<T>;
+    }
+  }
+#endif
+  return ScalarKernel<T>;
+}
+
+/**
+ * @brief Calls count(begin, end, counts) over [0, size) and returns the sum of the counts. Each parallel chunk counts
+ * into its own numSlots counters which are summed as chunks are joined. Chunks are kept to about k_ChunksPerThread
+ * per thread so that copying and joining the counters stays small next to the counting.
+ */
+template <class CountFunc>
+std::vector<uint64> CountParallel(usize size, usize numSlots, CountFunc&& count)
+{
+  const Range range(0, size);
+  ParallelDataAlgorithm algorithm(range);
+  algorithm.setGrain(std::max(k_ParallelGrain, detail::AutomaticGrain(range)));
+  algorithm.setParallelizationEnabled(size >= k_ParallelThreshold);
+  return algorithm.reduce(
+      std::vector<uint64>(numSlots, 0),
+      [&count](const Range& subRange, std::vector<uint64> counts) {
+        count(subRange.min(), subRange.max(), counts.data());
+        return counts;
+      },
+      [](std::vector<uint64> lhs, const std::vector<uint64>& rhs) {
+        for(usize i = 0; i < lhs.size(); i++)
+        {
+          lhs[i] += rhs[i];
+        }
+        return lhs;
+      });
+}
+
+Histogram MakeHistogram(std::vector<uint64> slots)
+{
+  Histogram histogram;
+  histogram.numOutOfRange = slots.back();
+  slots.pop_back();
+  histogram.counts = std::move(slots);
+  return histogram;
+}
+
+/**
+ * @brief Counts how often every possible value occurs, then adds each count to the bin of its value.
+ */
+template <class T>
+Histogram ComputeDirectHistogram(const T* data, usize size, const HistogramBins& bins)
+{
+  using UnsignedT = std::make_unsigned_t<std::conditional_t<std::is_same_v<T, bool>, uint8, T>>;
+  constexpr usize k_NumValues = usize{std::numeric_limits<UnsignedT>::max()} + 1;
+  constexpr usize k_NumTables = sizeof(T) == 1 ? k_NumByteTables : 1;
+
+  std::vector<uint64> valueCounts = CountParallel(size, k_NumValues * k_NumTables, [data](usize begin, usize end, uint64* counts) {
+    for(usize i = begin; i < end; i++)
+    {
+      counts[(i % k_NumTables) * k_NumValues + static_cast<UnsignedT>(data[i])]++;
+    }
+  });
+
+  std::vector<uint64> slots(NumSlots(bins), 0);
+  for(usize value = 0; value < k_NumValues; value++)
+  {
+    uint64 count = 0;
+    for(usize table = 0; table < k_NumTables; table++)
+    {
+      count += valueCounts[table * k_NumValues + value];
+    }
+    if(count != 0)
+    {
+      slots[bins.binIndex(static_cast<float64>(static_cast<T>(static_cast<UnsignedT>(value))))] += count;
+    }
+  }
+  return MakeHistogram(std::move(slots));
+}
+
+template <class T>
+Histogram ComputeHistogramImpl(const T* data, usize size, const HistogramBins& bins)
+{
+  if constexpr(k_IsDirectIndexable<T>)
+  {
+    if(size >= DirectThreshold<T>())
+    {
+      return ComputeDirectHistogram(data, size, bins);
+    }
+  }
+
+  const KernelFunc<T> kernel = SelectKernel<T>(bins);
+  return MakeHistogram(CountParallel(size, NumSlots(bins), [data, &bins, kernel](usize begin, usize end, uint64* counts) { kernel(data + begin, end - begin, bins, counts); }));
+}
+} // namespace
+
+HistogramBins HistogramBins::Uniform(usize numBins, float64 min, float64 max)
+{
+  if(numBins == 0)
+  {
+    throw std::runtime_error("HistogramBins: Number of bins cannot be 0");
+  }
+  if(!std::isfinite(min) || !std::isfinite(max) || !(min < max) || !std::isfinite(max - min))
+  {
+    throw std::runtime_error("HistogramBins: Range must be finite and increasing");
+  }
+  HistogramBins bins;
+  bins.m_NumBins = numBins;
+  bins.m_Min = min;
+  bins.m_Max = max;
+  bins.m_Scale = static_cast<float64>(numBins) / (max - min);
+  bins.m_LastBin = static_cast<float64>(numBins - 1);
+  return bins;
+}
+
+HistogramBins HistogramBins::FromEdges(std::vector<float64> edges)
+{
+  if(edges.size() < 2)
+  {
+    throw std::runtime_error("HistogramBins: At least 2 edges are required");
+  }
+  for(usize i = 0; i < edges.size(); i++)
+  {
+    if(!std::isfinite(edges[i]) || (i > 0 && !(edges[i - 1] < edges[i])))
+    {
+      throw std::runtime_error("HistogramBins: Edges must be finite and strictly increasing");
+    }
+  }
+  HistogramBins bins;
+  bins.m_NumBins = edges.size() - 1;
+  bins.m_Min = edges.front();
+  bins.m_Max = edges.back();
+  bins.m_Edges = std::move(edges);
+  return bins;
+}
+
+namespace detail
+{
+Histogram ComputeHistogram(const int8* data, usize size, const HistogramBins& bins)
+{
+  return ComputeHistogramImpl(data, size, bins);
+}
+
+Histogram ComputeHistogram(const uint8* data, usize size, const HistogramBins& bins)
+{
+  return ComputeHistogramImpl(data, size, bins);
+}
+
+Histogram ComputeHistogram(const int16* data, usize size, const HistogramBins& bins)
+{
+  return ComputeHistogramImpl(data, size, bins);
+}
+
+Histogram ComputeHistogram(const uint16* data, usize size, const HistogramBins& bins)
+{
+  return ComputeHistogramImpl(data, size, bins);
+}
+
+Histogram ComputeHistogram(const int32* data, usize size, const HistogramBins& bins)
+{
+  return ComputeHistogramImpl(data, size, bins);
+}
+
+Histogram ComputeHistogram(const uint32* data, usize size, const HistogramBins& bins)
+{
+  return ComputeHistogramImpl(data, size, bins);
+}
+
+Histogram ComputeHistogram(const int64* data, usize size, const HistogramBins& bins)
+{
+  return ComputeHistogramImpl(data, size, bins);
+}
+
+Histogram ComputeHistogram(const uint64* data, usize size, const HistogramBins& bins)
+{
+  return ComputeHistogramImpl(data, size, bins);
+}
+
+Histogram ComputeHistogram(const float32* data, usize size, const HistogramBins& bins)
+{
+  return ComputeHistogramImpl(data, size, bins);
+}
+
+Histogram ComputeHistogram(const float64* data, usize size, const HistogramBins& bins)
+{
+  return ComputeHistogramImpl(data, size, bins);
+}
+
+Histogram ComputeHistogram(const bool* data, usize size, const HistogramBins& bins)
+{
+  return ComputeHistogramImpl(data, size, bins);
+}
+} // namespace detail
+} // namespace NX::Common
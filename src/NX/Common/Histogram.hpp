@@ -0,0 +1,179 @@
+#pragma once
+
+#include "NX/Common/DataVector.hpp"
+#include "NX/Common/NXCommon_export.hpp"
+#include "NX/Common/Types.hpp"
+
+#include "nonstd/span.hpp"
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+namespace NX::Common
+{
+/**
+ * @class HistogramBins
+ * @brief HistogramBins describes the bins of a histogram, either numBins bins of equal width spanning [min, max]
+ * or bins between explicit edges. Like numpy, every bin is half open except the last which also holds its upper edge.
+ */
+class NXCOMMON_EXPORT HistogramBins
+{
+public:
+  /**
+   * @brief Returns numBins bins of equal width spanning [min, max]. Throws std::runtime_error if numBins is 0
+   * or the range is not finite and increasing.
+   * @param numBins
+   * @param min
+   * @param max
+   * @return HistogramBins
+   */
+  static HistogramBins Uniform(usize numBins, float64 min, float64 max);
+
+  /**
+   * @brief Returns edges.size() - 1 bins where bin i spans [edges[i], edges[i + 1]). Throws std::runtime_error
+   * if there are fewer than 2 edges or they are not finite and strictly increasing.
+   * @param edges
+   * @return HistogramBins
+   */
+  static HistogramBins FromEdges(std::vector<float64> edges);
+
+  /**
+   * @brief Returns the number of bins.
+   * @return usize
+   */
+  usize numBins() const
+  {
+    return m_NumBins;
+  }
+
+  /**
+   * @brief Returns the lower edge of the first bin.
+   * @return float64
+   */
+  float64 min() const
+  {
+    return m_Min;
+  }
+
+  /**
+   * @brief Returns the upper edge of the last bin.
+   * @return float64
+   */
+  float64 max() const
+  {
+    return m_Max;
+  }
+
+  /**
+   * @brief Returns true if the bins are of equal width.
+   * @return bool
+   */
+  bool isUniform() const
+  {
+    return m_Edges.empty();
+  }
+
+  /**
+   * @brief Returns the explicit edges. Empty for uniform bins.
+   * @return const std::vector<float64>&
+   */
+  const std::vector<float64>& edges() const
+  {
+    return m_Edges;
+  }
+
+  /**
+   * @brief Returns the number of bins per unit of value for uniform bins.
+   * @return float64
+   */
+  float64 scale() const
+  {
+    return m_Scale;
+  }
+
+  /**
+   * @brief Returns the index of the bin holding value, or numBins() if value is outside the bins or NaN.
+   * Uniform bins compute the index as (value - min) * scale() truncated, which may differ from the exact edge
+   * by rounding for values within an ulp of it.
+   * @param value
+   * @return usize
+   */
+  usize binIndex(float64 value) const
+  {
+    if(!(value >= m_Min && value <= m_Max))
+    {
+      return m_NumBins;
+    }
+    if(isUniform())
+    {
+      return static_cast<usize>(std::min((value - m_Min) * m_Scale, m_LastBin));
+    }
+    const auto upper = std::upper_bound(m_Edges.cbegin(), m_Edges.cend(), value);
+    return std::min(static_cast<usize>(upper - m_Edges.cbegin()) - 1, m_NumBins - 1);
+  }
+
+private:
+  HistogramBins() = default;
+
+  usize m_NumBins = 0;
+  float64 m_Min = 0.0;
+  float64 m_Max = 0.0;
+  float64 m_Scale = 0.0;
+  float64 m_LastBin = 0.0;
+  std::vector<float64> m_Edges;
+};
+
+/**
+ * @brief Histogram holds the number of values that fell in each bin.
+ */
+struct Histogram
+{
+  std::vector<uint64> counts;
+  uint64 numOutOfRange = 0; ///< Number of values outside the bins, including NaNs.
+};
+
+namespace detail
+{
+NXCOMMON_EXPORT Histogram ComputeHistogram(const int8* data, usize size, const HistogramBins& bins);
+NXCOMMON_EXPORT Histogram ComputeHistogram(const uint8* data, usize size, const HistogramBins& bins);
+NXCOMMON_EXPORT Histogram ComputeHistogram(const int16* data, usize size, const HistogramBins& bins);
+NXCOMMON_EXPORT Histogram ComputeHistogram(const uint16* data, usize size, const HistogramBins& bins);
+NXCOMMON_EXPORT Histogram ComputeHistogram(const int32* data, usize size, const HistogramBins& bins);
+NXCOMMON_EXPORT Histogram ComputeHistogram(const uint32* data, usize size, const HistogramBins& bins);
+NXCOMMON_EXPORT Histogram ComputeHistogram(const int64* data, usize size, const HistogramBins& bins);
+NXCOMMON_EXPORT Histogram ComputeHistogram(const uint64* data, usize size, const HistogramBins& bins);
+NXCOMMON_EXPORT Histogram ComputeHistogram(const float32* data, usize size, const HistogramBins& bins);
+NXCOMMON_EXPORT Histogram ComputeHistogram(const float64* data, usize size, const HistogramBins& bins);
+NXCOMMON_EXPORT Histogram ComputeHistogram(const bool* data, usize size, const HistogramBins& bins);
+} // namespace detail
+
+/**
+ * @brief Counts the values falling in each bin. Large inputs are split across threads through ParallelDataAlgorithm
+ * into chunks that count into private bins, which are summed as the chunks are joined. Uniform bins over float32, uint8 and uint16 compute bin
+ * indices with AVX2 when available. Large inputs of 8 and 16 bit integers are counted per distinct value first and
+ * mapped to bins afterwards, which makes the cost independent of the bins.
+ * @tparam T Any type of NX::DataType
+ * @param values
+ * @param bins
+ * @return Histogram
+ */
+template <class T>
+Histogram ComputeHistogram(nonstd::span<T> values, const HistogramBins& bins)
+{
+  return detail::ComputeHistogram(values.data(), values.size(), bins);
+}
+
+/**
+ * @brief Counts the values falling in each bin. See ComputeHistogram(nonstd::span<T>, const HistogramBins&).
+ * @tparam T
+ * @param values
+ * @param bins
+ * @return Histogram
+ */
+template <class T>
+Histogram ComputeHistogram(const DataVector<T>& values, const HistogramBins& bins)
+{
+  return ComputeHistogram(values.createSpan(), bins);
+}
+} // namespace NX::Common
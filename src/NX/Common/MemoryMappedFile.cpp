@@ -0,0 +1,318 @@
+#include "NX/Common/MemoryMappedFile.hpp"
+
+#include <fmt/format.h>
+
+#include <stdexcept>
+#include <utility>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#include <windows.h>
+#else
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace NX::Common
+{
+namespace
+{
+#ifdef _WIN32
+uint64 GetAllocationGranularity()
+{
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return info.dwAllocationGranularity;
+}
+
+using ErrorCode = DWORD;
+
+ErrorCode GetLastErrorCode()
+{
+  return GetLastError();
+}
+
+std::string GetErrorString(ErrorCode error)
+{
+  return fmt::format("Windows error {}", error);
+}
+#else
+uint64 GetAllocationGranularity()
+{
+  return static_cast<uint64>(sysconf(_SC_PAGESIZE));
+}
+
+using ErrorCode = int;
+
+ErrorCode GetLastErrorCode()
+{
+  return errno;
+}
+
+std::string GetErrorString(ErrorCode error)
+{
+  return std::strerror(error);
+}
+#endif
+
+/**
+ * @brief Describes the error of the last failed system call. Calls that clean up after a failure overwrite the error,
+ * so those paths save GetLastErrorCode() first and use GetErrorString.
+ */
+std::string GetLastErrorString()
+{
+  return GetErrorString(GetLastErrorCode());
+}
+} // namespace
+
+MemoryMappedFile::MemoryMappedFile(const std::filesystem::path& path, Access access, uint64 offset, std::optional<uint64> length)
+: m_Access(access)
+{
+  std::error_code errorCode;
+  const uint64 fileSize = std::filesystem::file_size(path, errorCode);
+  if(errorCode)
+  {
+    throw std::runtime_error(fmt::format("MemoryMappedFile: Unable to query the size of '{}': {}", path.string(), errorCode.message()));
+  }
+  if(offset > fileSize)
+  {
+    throw std::runtime_error(fmt::format("MemoryMappedFile: Offset {} is past the end of '{}' ({} bytes)", offset, path.string(), fileSize));
+  }
+  const uint64 size = length.value_or(fileSize - offset);
+  if(size > fileSize - offset)
+  {
+    throw std::runtime_error(fmt::format("MemoryMappedFile: Region [{}, {}) is past the end of '{}' ({} bytes)", offset, offset + size, path.string(), fileSize));
+  }
+  if(size == 0)
+  {
+    return;
+  }
+
+  // The mapping itself has to start on an allocation boundary so map from the preceding boundary and hide the difference.
+  const uint64 granularity = GetAllocationGranularity();
+  const uint64 alignedOffset = offset - (offset % granularity);
+  m_PageOffset = offset - alignedOffset;
+  m_MappedSize = size + m_PageOffset;
+
+#ifdef _WIN32
+  const DWORD desiredAccess = access == Access::ReadWrite ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ;
+  HANDLE fileHandle = CreateFileW(path.c_str(), desiredAccess, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if(fileHandle == INVALID_HANDLE_VALUE)
+  {
+    throw std::runtime_error(fmt::format("MemoryMappedFile: Unable to open '{}': {}", path.string(), GetLastErrorString()));
+  }
+
+  DWORD protection = PAGE_READONLY;
+  DWORD viewAccess = FILE_MAP_READ;
+  if(access == Access::CopyOnWrite)
+  {
+    protection = PAGE_WRITECOPY;
+    viewAccess = FILE_MAP_COPY;
+  }
+  else if(access == Access::ReadWrite)
+  {
+    protection = PAGE_READWRITE;
+    viewAccess = FILE_MAP_WRITE;
+  }
+
+  HANDLE mappingHandle = CreateFileMappingW(fileHandle, nullptr, protection, 0, 0, nullptr);
+  const ErrorCode mappingError = GetLastErrorCode();
+  CloseHandle(fileHandle);
+  if(mappingHandle == nullptr)
+  {
+    throw std::runtime_error(fmt::format("MemoryMappedFile: Unable to create a file mapping for '{}': {}", path.string(), GetErrorString(mappingError)));
+  }
+
+  void* address = MapViewOfFile(mappingHandle, viewAccess, static_cast<DWORD>(alignedOffset >> 32), static_cast<DWORD>(alignedOffset & 0xFFFFFFFFull), static_cast<SIZE_T>(m_MappedSize));
+  const ErrorCode mapError = GetLastErrorCode();
+  // The view keeps the mapping object alive
+  CloseHandle(mappingHandle);
+  if(address == nullptr)
+  {
+    throw std::runtime_error(fmt::format("MemoryMappedFile: Unable to map '{}': {}", path.string(), GetErrorString(mapError)));
+  }
+#else
+  const int openFlags = access == Access::ReadWrite ? O_RDWR : O_RDONLY;
+  const int fileDescriptor = ::open(path.c_str(), openFlags);
+  if(fileDescriptor < 0)
+  {
+    throw std::runtime_error(fmt::format("MemoryMappedFile: Unable to open '{}': {}", path.string(), GetLastErrorString()));
+  }
+
+  const int protection = access == Access::ReadOnly ? PROT_READ : (PROT_READ | PROT_WRITE);
+  const int mapFlags = access == Access::ReadWrite ? MAP_SHARED : MAP_PRIVATE;
+  void* address = ::mmap(nullptr, static_cast<size_t>(m_MappedSize), protection, mapFlags, fileDescriptor, static_cast<off_t>(alignedOffset));
+  const ErrorCode mapError = GetLastErrorCode();
+  // The mapping keeps its own reference to the file
+  ::close(fileDescriptor);
+  if(address == MAP_FAILED)
+  {
+    throw std::runtime_error(fmt::format("MemoryMappedFile: Unable to map '{}': {}", path.string(), GetErrorString(mapError)));
+  }
+#endif
+
+  m_MappedAddress = static_cast<std::byte*>(address);
+}
+
+MemoryMappedFile::MemoryMappedFile(MemoryMappedFile&& other) noexcept
+: m_MappedAddress(std::exchange(other.m_MappedAddress, nullptr))
+, m_MappedSize(std::exchange(other.m_MappedSize, 0))
+, m_PageOffset(std::exchange(other.m_PageOffset, 0))
+, m_Access(other.m_Access)
+{
+}
+
+MemoryMappedFile& MemoryMappedFile::operator=(MemoryMappedFile&& rhs) noexcept
+{
+  if(this != &rhs)
+  {
+    unmap();
+    m_MappedAddress = std::exchange(rhs.m_MappedAddress, nullptr);
+    m_MappedSize = std::exchange(rhs.m_MappedSize, 0);
+    m_PageOffset = std::exchange(rhs.m_PageOffset, 0);
+    m_Access = rhs.m_Access;
+  }
+  return *this;
+}
+
+MemoryMappedFile::~MemoryMappedFile() noexcept
+{
+  unmap();
+}
+
+MemoryMappedFile MemoryMappedFile::Create(const std::filesystem::path& path, uint64 size)
+{
+#ifdef _WIN32
+  HANDLE fileHandle = CreateFileW(path.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if(fileHandle == INVALID_HANDLE_VALUE)
+  {
+    throw std::runtime_error(fmt::format("MemoryMappedFile: Unable to create '{}': {}", path.string(), GetLastErrorString()));
+  }
+  LARGE_INTEGER newSize;
+  newSize.QuadPart = static_cast<LONGLONG>(size);
+  const bool resized = SetFilePointerEx(fileHandle, newSize, nullptr, FILE_BEGIN) && SetEndOfFile(fileHandle);
+  const ErrorCode resizeError = GetLastErrorCode();
+  CloseHandle(fileHandle);
+  if(!resized)
+  {
+    throw std::runtime_error(fmt::format("MemoryMappedFile: Unable to resize '{}' to {} bytes: {}", path.string(), size, GetErrorString(resizeError)));
+  }
+#else
+  const int fileDescriptor = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+  if(fileDescriptor < 0)
+  {
+    throw std::runtime_error(fmt::format("MemoryMappedFile: Unable to create '{}': {}", path.string(), GetLastErrorString()));
+  }
+  const bool resized = ::ftruncate(fileDescriptor, static_cast<off_t>(size)) == 0;
+  const ErrorCode resizeError = GetLastErrorCode();
+  ::close(fileDescriptor);
+  if(!resized)
+  {
+    throw std::runtime_error(fmt::format("MemoryMappedFile: Unable to resize '{}' to {} bytes: {}", path.string(), size, GetErrorString(resizeError)));
+  }
+#endif
+
+  return MemoryMappedFile(path, Access::ReadWrite, 0, size);
+}
+
+std::byte* MemoryMappedFile::data() noexcept
+{
+  return m_MappedAddress == nullptr ? nullptr : m_MappedAddress + m_PageOffset;
+}
+
+const std::byte* MemoryMappedFile::data() const noexcept
+{
+  return m_MappedAddress == nullptr ? nullptr : m_MappedAddress + m_PageOffset;
+}
+
+uint64 MemoryMappedFile::size() const noexcept
+{
+  return m_MappedSize - m_PageOffset;
+}
+
+MemoryMappedFile::Access MemoryMappedFile::access() const noexcept
+{
+  return m_Access;
+}
+
+bool MemoryMappedFile::isWritable() const noexcept
+{
+  return m_Access != Access::ReadOnly;
+}
+
+void MemoryMappedFile::flush()
+{
+  if(m_MappedAddress == nullptr || m_Access != Access::ReadWrite)
+  {
+    return;
+  }
+#ifdef _WIN32
+  if(!FlushViewOfFile(m_MappedAddress, static_cast<SIZE_T>(m_MappedSize)))
+#else
+  if(::msync(m_MappedAddress, static_cast<size_t>(m_MappedSize), MS_SYNC) != 0)
+#endif
+  {
+    throw std::runtime_error(fmt::format("MemoryMappedFile: Unable to flush mapped pages: {}", GetLastErrorString()));
+  }
+}
+
+void MemoryMappedFile::advise(Advice advice) noexcept
+{
+  if(m_MappedAddress == nullptr)
+  {
+    return;
+  }
+#ifdef _WIN32
+  if(advice == Advice::WillNeed)
+  {
+    WIN32_MEMORY_RANGE_ENTRY entry;
+    entry.VirtualAddress = m_MappedAddress;
+    entry.NumberOfBytes = static_cast<SIZE_T>(m_MappedSize);
+    PrefetchVirtualMemory(GetCurrentProcess(), 1, &entry, 0);
+  }
+#else
+  int posixAdvice = MADV_NORMAL;
+  switch(advice)
+  {
+  case Advice::Normal:
+    posixAdvice = MADV_NORMAL;
+    break;
+  case Advice::Sequential:
+    posixAdvice = MADV_SEQUENTIAL;
+    break;
+  case Advice::Random:
+    posixAdvice = MADV_RANDOM;
+    break;
+  case Advice::WillNeed:
+    posixAdvice = MADV_WILLNEED;
+    break;
+  }
+  ::madvise(m_MappedAddress, static_cast<size_t>(m_MappedSize), posixAdvice);
+#endif
+}
+
+void MemoryMappedFile::unmap() noexcept
+{
+  if(m_MappedAddress == nullptr)
+  {
+    return;
+  }
+#ifdef _WIN32
+  UnmapViewOfFile(m_MappedAddress);
+#else
+  ::munmap(m_MappedAddress, static_cast<size_t>(m_MappedSize));
+#endif
+  m_MappedAddress = nullptr;
+  m_MappedSize = 0;
+  m_PageOffset = 0;
+}
+} // namespace NX::Common
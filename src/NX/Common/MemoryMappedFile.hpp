@@ -0,0 +1,112 @@
+#pragma once
+
+#include "NX/Common/NXCommon_export.hpp"
+#include "NX/Common/Types.hpp"
+
+#include <filesystem>
+#include <optional>
+
+namespace NX::Common
+{
+/**
+ * @class MemoryMappedFile
+ * @brief MemoryMappedFile maps a region of a file into the address space of the process.
+ * Pages are only read from disk when they are first touched, so opening a very large
+ * file is effectively free. Used by DataVector to provide file backed storage.
+ */
+class NXCOMMON_EXPORT MemoryMappedFile
+{
+public:
+  enum class Access : uint8
+  {
+    ReadOnly = 0,    ///< Pages may only be read. Writing through the mapping is undefined behavior.
+    CopyOnWrite = 1, ///< Pages may be written, but changes are private to the mapping and never reach the file.
+    ReadWrite = 2    ///< Pages may be written and changes are shared with the file.
+  };
+
+  enum class Advice : uint8
+  {
+    Normal = 0,
+    Sequential = 1,
+    Random = 2,
+    WillNeed = 3
+  };
+
+  /**
+   * @brief Maps [offset, offset + length) of an existing file. If length is not given, the remainder of the file is mapped.
+   * Throws std::runtime_error if the file cannot be opened or mapped.
+   * @param path
+   * @param access
+   * @param offset Byte offset into the file. Does not need to be page aligned.
+   * @param length
+   */
+  MemoryMappedFile(const std::filesystem::path& path, Access access, uint64 offset = 0, std::optional<uint64> length = {});
+
+  MemoryMappedFile(const MemoryMappedFile&) = delete;
+  MemoryMappedFile(MemoryMappedFile&& other) noexcept;
+
+  MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+  MemoryMappedFile& operator=(MemoryMappedFile&& rhs) noexcept;
+
+  ~MemoryMappedFile() noexcept;
+
+  /**
+   * @brief Creates (or truncates) the file at path, resizes it to size bytes and maps it with Access::ReadWrite.
+   * Throws std::runtime_error on failure.
+   * @param path
+   * @param size
+   * @return MemoryMappedFile
+   */
+  static MemoryMappedFile Create(const std::filesystem::path& path, uint64 size);
+
+  /**
+   * @brief Returns a pointer to the first mapped byte. Returns nullptr if the mapped region is empty.
+   * @return std::byte*
+   */
+  std::byte* data() noexcept;
+
+  /**
+   * @brief Returns a const pointer to the first mapped byte. Returns nullptr if the mapped region is empty.
+   * @return const std::byte*
+   */
+  const std::byte* data() const noexcept;
+
+  /**
+   * @brief Returns the number of mapped bytes.
+   * @return uint64
+   */
+  uint64 size() const noexcept;
+
+  /**
+   * @brief Returns the access mode the file was mapped with.
+   * @return Access
+   */
+  Access access() const noexcept;
+
+  /**
+   * @brief Returns true if the mapped pages may be written to.
+   * @return bool
+   */
+  bool isWritable() const noexcept;
+
+  /**
+   * @brief Synchronously writes modified pages back to the file. Does nothing unless the access mode is Access::ReadWrite.
+   * Throws std::runtime_error on failure.
+   */
+  void flush();
+
+  /**
+   * @brief Hints to the operating system how the mapped region will be accessed. Failures are ignored.
+   * @param advice
+   */
+  void advise(Advice advice) noexcept;
+
+private:
+  void unmap() noexcept;
+
+  std::byte* m_MappedAddress = nullptr;
+  uint64 m_MappedSize = 0;
+  uint64 m_PageOffset = 0;
+  Access m_Access = Access::ReadOnly;
+};
+} // namespace NX::Common
@@ -0,0 +1,305 @@
+#include "NX/Common/MemoryResource.hpp"
+
+#include <algorithm>
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+namespace NX::Common
+{
+namespace
+{
+/**
+ * @brief Forwards to the global aligned operator new and delete.
+ */
+class NewDeleteResource final : public MemoryResource
+{
+public:
+  ~NewDeleteResource() noexcept override = default;
+
+protected:
+  void* doAllocate(usize numBytes, usize alignment) override
+  {
+    if(alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+    {
+      return ::operator new(numBytes, std::align_val_t(alignment));
+    }
+    return ::operator new(numBytes);
+  }
+
+  void doDeallocate(void* ptr, usize numBytes, usize alignment) noexcept override
+  {
+    if(alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+    {
+      ::operator delete(ptr, numBytes, std::align_val_t(alignment));
+      return;
+    }
+    ::operator delete(ptr, numBytes);
+  }
+
+  bool doIsEqual(const MemoryResource& other) const noexcept override
+  {
+    return dynamic_cast<const NewDeleteResource*>(&other) != nullptr;
+  }
+};
+
+/**
+ * @brief Smallest PoolResource size class. Large enough to hold a free list link.
+ */
+constexpr usize k_MinPoolBlockSize = 16;
+
+/**
+ * @brief PoolResource chunks are never aligned to more than a page, so stricter requests go upstream.
+ */
+constexpr usize k_MaxPoolAlignment = 4096;
+
+/**
+ * @brief PoolResource requests at least this many bytes from upstream at a time.
+ */
+constexpr usize k_MinPoolChunkSize = 64ull << 10;
+
+/**
+ * @brief MonotonicArenaResource stops doubling its block size past this point.
+ */
+constexpr usize k_MaxArenaGrowthBlockSize = 1ull << 30;
+
+usize RoundUpToHugePage(usize numBytes) noexcept
+{
+  return (numBytes + HugePageResource::k_HugePageSize - 1) & ~(HugePageResource::k_HugePageSize - 1);
+}
+
+usize CeilLog2(usize value) noexcept
+{
+  usize result = 0;
+  while((usize{1} << result) < value)
+  {
+    result++;
+  }
+  return result;
+}
+} // namespace
+
+MemoryResource::~MemoryResource() noexcept = default;
+
+bool MemoryResource::doIsEqual(const MemoryResource& other) const noexcept
+{
+  return this == &other;
+}
+
+MemoryResource* GetDefaultMemoryResource() noexcept
+{
+  static NewDeleteResource resource;
+  return &resource;
+}
+
+MonotonicArenaResource::MonotonicArenaResource(usize initialBlockSize, MemoryResource* upstream)
+: m_Upstream(upstream)
+, m_InitialBlockSize(std::max(initialBlockSize, sizeof(BlockHeader) * 2))
+, m_NextBlockSize(m_InitialBlockSize)
+{
+}
+
+MonotonicArenaResource::MonotonicArenaResource(void* buffer, usize bufferSize, MemoryResource* upstream)
+: m_Upstream(upstream)
+, m_Current(static_cast<std::byte*>(buffer))
+, m_Remaining(bufferSize)
+, m_InitialBlockSize(std::max(bufferSize, k_DefaultBlockSize))
+, m_NextBlockSize(m_InitialBlockSize)
+, m_InitialBuffer(static_cast<std::byte*>(buffer))
+, m_InitialBufferSize(bufferSize)
+{
+}
+
+MonotonicArenaResource::~MonotonicArenaResource() noexcept
+{
+  release();
+}
+
+void MonotonicArenaResource::release() noexcept
+{
+  while(m_Blocks != nullptr)
+  {
+    BlockHeader* next = m_Blocks->next;
+    m_Upstream->deallocate(m_Blocks, m_Blocks->size, alignof(BlockHeader));
+    m_Blocks = next;
+  }
+  m_Current = m_InitialBuffer;
+  m_Remaining = m_InitialBufferSize;
+  m_NextBlockSize = m_InitialBlockSize;
+}
+
+MemoryResource* MonotonicArenaResource::upstream() const noexcept
+{
+  return m_Upstream;
+}
+
+void* MonotonicArenaResource::doAllocate(usize numBytes, usize alignment)
+{
+  numBytes = std::max<usize>(numBytes, 1);
+
+  void* ptr = m_Current;
+  usize space = m_Remaining;
+  if(ptr == nullptr || std::align(alignment, numBytes, ptr, space) == nullptr)
+  {
+    const usize requiredSize = sizeof(BlockHeader) + alignment + numBytes;
+    const usize blockSize = std::max(m_NextBlockSize, requiredSize);
+    void* memory = m_Upstream->allocate(blockSize, alignof(BlockHeader));
+    m_Blocks = ::new(memory) BlockHeader{m_Blocks, blockSize};
+    m_NextBlockSize = std::min(blockSize * 2, std::max(k_MaxArenaGrowthBlockSize, m_InitialBlockSize));
+
+    ptr = static_cast<std::byte*>(memory) + sizeof(BlockHeader);
+    space = blockSize - sizeof(BlockHeader);
+    std::align(alignment, numBytes, ptr, space);
+  }
+
+  m_Current = static_cast<std::byte*>(ptr) + numBytes;
+  m_Remaining = space - numBytes;
+  return ptr;
+}
+
+void MonotonicArenaResource::doDeallocate(void*, usize, usize) noexcept
+{
+}
+
+PoolResource::PoolResource(usize maxPooledSize, MemoryResource* upstream)
+: m_Upstream(upstream)
+{
+  const usize minLog2 = CeilLog2(k_MinPoolBlockSize);
+  const usize maxLog2 = std::max(CeilLog2(maxPooledSize), minLog2);
+  m_NumSizeClasses = maxLog2 - minLog2 + 1;
+  m_SizeClasses = std::make_unique<SizeClass[]>(m_NumSizeClasses);
+  for(usize i = 0; i < m_NumSizeClasses; i++)
+  {
+    m_SizeClasses[i].blockSize = usize{1} << (minLog2 + i);
+  }
+}
+
+PoolResource::~PoolResource() noexcept
+{
+  release();
+}
+
+void PoolResource::release() noexcept
+{
+  for(usize i = 0; i < m_NumSizeClasses; i++)
+  {
+    SizeClass& sizeClass = m_SizeClasses[i];
+    std::lock_guard<std::mutex> lock(sizeClass.mutex);
+    for(const Chunk& chunk : sizeClass.chunks)
+    {
+      m_Upstream->deallocate(chunk.ptr, chunk.size, chunk.alignment);
+    }
+    sizeClass.chunks.clear();
+    sizeClass.freeList = nullptr;
+  }
+}
+
+MemoryResource* PoolResource::upstream() const noexcept
+{
+  return m_Upstream;
+}
+
+PoolResource::SizeClass* PoolResource::findSizeClass(usize numBytes, usize alignment) noexcept
+{
+  if(alignment > k_MaxPoolAlignment)
+  {
+    return nullptr;
+  }
+  const usize size = std::max({numBytes, alignment, k_MinPoolBlockSize});
+  const usize index = CeilLog2(size) - CeilLog2(k_MinPoolBlockSize);
+  if(index >= m_NumSizeClasses)
+  {
+    return nullptr;
+  }
+  return &m_SizeClasses[index];
+}
+
+void* PoolResource::doAllocate(usize numBytes, usize alignment)
+{
+  SizeClass* sizeClass = findSizeClass(numBytes, alignment);
+  if(sizeClass == nullptr)
+  {
+    return m_Upstream->allocate(numBytes, alignment);
+  }
+
+  std::lock_guard<std::mutex> lock(sizeClass->mutex);
+  if(sizeClass->freeList == nullptr)
+  {
+    // Blocks are laid out back to back in a chunk aligned to the block size, so every block is aligned to its size
+    const usize blockSize = sizeClass->blockSize;
+    const usize chunkSize = std::max(blockSize * 4, k_MinPoolChunkSize);
+    const usize chunkAlignment = std::min(blockSize, k_MaxPoolAlignment);
+    sizeClass->chunks.reserve(sizeClass->chunks.size() + 1);
+    auto* chunk = static_cast<std::byte*>(m_Upstream->allocate(chunkSize, chunkAlignment));
+    sizeClass->chunks.push_back({chunk, chunkSize, chunkAlignment});
+    for(usize offset = chunkSize; offset >= blockSize; offset -= blockSize)
+    {
+      sizeClass->freeList = ::new(chunk + offset - blockSize) FreeBlock{sizeClass->freeList};
+    }
+  }
+
+  FreeBlock* block = sizeClass->freeList;
+  sizeClass->freeList = block->next;
+  return block;
+}
+
+void PoolResource::doDeallocate(void* ptr, usize numBytes, usize alignment) noexcept
+{
+  SizeClass* sizeClass = findSizeClass(numBytes, alignment);
+  if(sizeClass == nullptr)
+  {
+    m_Upstream->deallocate(ptr, numBytes, alignment);
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(sizeClass->mutex);
+  sizeClass->freeList = ::new(ptr) FreeBlock{sizeClass->freeList};
+}
+
+HugePageResource::HugePageResource(usize minHugePageSize, MemoryResource* upstream)
+: m_Upstream(upstream)
+, m_MinHugePageSize(minHugePageSize)
+{
+}
+
+HugePageResource::~HugePageResource() noexcept = default;
+
+MemoryResource* HugePageResource::upstream() const noexcept
+{
+  return m_Upstream;
+}
+
+void* HugePageResource::doAllocate(usize numBytes, usize alignment)
+{
+  if(numBytes < m_MinHugePageSize)
+  {
+    return m_Upstream->allocate(numBytes, alignment);
+  }
+
+  const usize size = RoundUpToHugePage(numBytes);
+  void* ptr = m_Upstream->allocate(size, std::max(alignment, k_HugePageSize));
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+  // Only a hint. Failure just means the kernel has transparent huge pages disabled.
+  ::madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+  return ptr;
+}
+
+void HugePageResource::doDeallocate(void* ptr, usize numBytes, usize alignment) noexcept
+{
+  if(numBytes < m_MinHugePageSize)
+  {
+    m_Upstream->deallocate(ptr, numBytes, alignment);
+    return;
+  }
+  m_Upstream->deallocate(ptr, RoundUpToHugePage(numBytes), std::max(alignment, k_HugePageSize));
+}
+
+bool HugePageResource::doIsEqual(const MemoryResource& other) const noexcept
+{
+  const auto* otherResource = dynamic_cast<const HugePageResource*>(&other);
+  return otherResource != nullptr && otherResource->m_MinHugePageSize == m_MinHugePageSize && m_Upstream->isEqual(*otherResource->m_Upstream);
+}
+} // namespace NX::Common
@@ -0,0 +1,267 @@
+#pragma once
+
+#include "NX/Common/NXCommon_export.hpp"
+#include "NX/Common/Types.hpp"
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace NX::Common
+{
+/**
+ * @class MemoryResource
+ * @brief MemoryResource is the allocation interface used by DataVector. It mirrors std::pmr::memory_resource,
+ * which is not available on every platform NXCommon supports. Derived classes implement doAllocate,
+ * doDeallocate and optionally doIsEqual.
+ */
+class NXCOMMON_EXPORT MemoryResource
+{
+public:
+  static inline constexpr usize k_DefaultAlignment = alignof(std::max_align_t);
+
+  MemoryResource() = default;
+
+  MemoryResource(const MemoryResource&) = default;
+  MemoryResource(MemoryResource&&) noexcept = default;
+
+  MemoryResource& operator=(const MemoryResource&) = default;
+  MemoryResource& operator=(MemoryResource&&) noexcept = default;
+
+  virtual ~MemoryResource() noexcept;
+
+  /**
+   * @brief Allocates at least numBytes with the given alignment. Throws std::bad_alloc on failure.
+   * @param numBytes
+   * @param alignment Must be a power of two
+   * @return void*
+   */
+  void* allocate(usize numBytes, usize alignment = k_DefaultAlignment)
+  {
+    return doAllocate(numBytes, alignment);
+  }
+
+  /**
+   * @brief Returns memory previously returned by allocate with the same numBytes and alignment.
+   * @param ptr
+   * @param numBytes
+   * @param alignment
+   */
+  void deallocate(void* ptr, usize numBytes, usize alignment = k_DefaultAlignment) noexcept
+  {
+    doDeallocate(ptr, numBytes, alignment);
+  }
+
+  /**
+   * @brief Returns true if memory allocated from this resource can be deallocated by other and vice versa.
+   * @param other
+   * @return bool
+   */
+  bool isEqual(const MemoryResource& other) const noexcept
+  {
+    return this == &other || doIsEqual(other);
+  }
+
+protected:
+  virtual void* doAllocate(usize numBytes, usize alignment) = 0;
+
+  virtual void doDeallocate(void* ptr, usize numBytes, usize alignment) noexcept = 0;
+
+  virtual bool doIsEqual(const MemoryResource& other) const noexcept;
+};
+
+/**
+ * @brief Returns the process wide MemoryResource that forwards to the global operator new and delete.
+ * Used by DataVector unless another resource is given.
+ * @return MemoryResource*
+ */
+NXCOMMON_EXPORT MemoryResource* GetDefaultMemoryResource() noexcept;
+
+/**
+ * @class MonotonicArenaResource
+ * @brief MonotonicArenaResource hands out memory by bumping a pointer through blocks obtained from an upstream
+ * resource. deallocate does nothing; all memory is returned at once by release() or destruction, which costs
+ * one upstream deallocation per block regardless of how many allocations were made. Blocks grow geometrically.
+ * Not thread safe.
+ */
+class NXCOMMON_EXPORT MonotonicArenaResource : public MemoryResource
+{
+public:
+  static inline constexpr usize k_DefaultBlockSize = 64ull << 10;
+
+  /**
+   * @brief Constructs an arena whose first upstream block holds at least initialBlockSize bytes.
+   * @param initialBlockSize
+   * @param upstream
+   */
+  explicit MonotonicArenaResource(usize initialBlockSize = k_DefaultBlockSize, MemoryResource* upstream = GetDefaultMemoryResource());
+
+  /**
+   * @brief Constructs an arena that first allocates from buffer, which must outlive the arena, before going upstream.
+   * @param buffer
+   * @param bufferSize
+   * @param upstream
+   */
+  MonotonicArenaResource(void* buffer, usize bufferSize, MemoryResource* upstream = GetDefaultMemoryResource());
+
+  MonotonicArenaResource(const MonotonicArenaResource&) = delete;
+  MonotonicArenaResource(MonotonicArenaResource&&) noexcept = delete;
+
+  MonotonicArenaResource& operator=(const MonotonicArenaResource&) = delete;
+  MonotonicArenaResource& operator=(MonotonicArenaResource&&) noexcept = delete;
+
+  ~MonotonicArenaResource() noexcept override;
+
+  /**
+   * @brief Returns every upstream block and rewinds to the initial buffer, if any.
+   * All memory previously allocated from the arena becomes invalid.
+   */
+  void release() noexcept;
+
+  /**
+   * @brief Returns the upstream resource.
+   * @return MemoryResource*
+   */
+  MemoryResource* upstream() const noexcept;
+
+protected:
+  void* doAllocate(usize numBytes, usize alignment) override;
+
+  void doDeallocate(void* ptr, usize numBytes, usize alignment) noexcept override;
+
+private:
+  struct BlockHeader
+  {
+    BlockHeader* next = nullptr;
+    usize size = 0;
+  };
+
+  MemoryResource* m_Upstream = nullptr;
+  BlockHeader* m_Blocks = nullptr;
+  std::byte* m_Current = nullptr;
+  usize m_Remaining = 0;
+  usize m_InitialBlockSize = 0;
+  usize m_NextBlockSize = 0;
+  std::byte* m_InitialBuffer = nullptr;
+  usize m_InitialBufferSize = 0;
+};
+
+/**
+ * @class PoolResource
+ * @brief PoolResource serves small allocations from power of two size classes. Each size class keeps a free list
+ * of blocks carved from larger upstream chunks, so repeatedly creating and destroying temporaries of similar
+ * sizes never touches the upstream resource after warm up. Allocations larger than maxPooledSize go directly upstream.
+ * Each size class has its own lock so threads allocating different sizes do not contend.
+ */
+class NXCOMMON_EXPORT PoolResource : public MemoryResource
+{
+public:
+  static inline constexpr usize k_DefaultMaxPooledSize = 1ull << 20;
+
+  /**
+   * @brief Constructs a pool with size classes from 16 bytes up to maxPooledSize rounded up to a power of two.
+   * @param maxPooledSize
+   * @param upstream
+   */
+  explicit PoolResource(usize maxPooledSize = k_DefaultMaxPooledSize, MemoryResource* upstream = GetDefaultMemoryResource());
+
+  PoolResource(const PoolResource&) = delete;
+  PoolResource(PoolResource&&) noexcept = delete;
+
+  PoolResource& operator=(const PoolResource&) = delete;
+  PoolResource& operator=(PoolResource&&) noexcept = delete;
+
+  ~PoolResource() noexcept override;
+
+  /**
+   * @brief Returns every chunk to the upstream resource. All memory previously allocated from the pool becomes invalid.
+   * Allocations that were forwarded upstream because of their size are not affected.
+   */
+  void release() noexcept;
+
+  /**
+   * @brief Returns the upstream resource.
+   * @return MemoryResource*
+   */
+  MemoryResource* upstream() const noexcept;
+
+protected:
+  void* doAllocate(usize numBytes, usize alignment) override;
+
+  void doDeallocate(void* ptr, usize numBytes, usize alignment) noexcept override;
+
+private:
+  struct FreeBlock
+  {
+    FreeBlock* next = nullptr;
+  };
+
+  struct Chunk
+  {
+    void* ptr = nullptr;
+    usize size = 0;
+    usize alignment = 0;
+  };
+
+  struct SizeClass
+  {
+    usize blockSize = 0;
+    FreeBlock* freeList = nullptr;
+    std::vector<Chunk> chunks;
+    std::mutex mutex;
+  };
+
+  SizeClass* findSizeClass(usize numBytes, usize alignment) noexcept;
+
+  MemoryResource* m_Upstream = nullptr;
+  usize m_NumSizeClasses = 0;
+  std::unique_ptr<SizeClass[]> m_SizeClasses;
+};
+
+/**
+ * @class HugePageResource
+ * @brief HugePageResource backs allocations of at least minHugePageSize bytes with 2 MiB aligned memory and, on Linux,
+ * asks the kernel to use transparent huge pages for it. A whole volume sweep over such an array then needs one TLB
+ * entry per 2 MiB instead of one per 4 KiB. Smaller allocations are forwarded upstream unchanged.
+ * Large allocations are padded to a multiple of 2 MiB, so this is only worthwhile for arrays much larger than that.
+ */
+class NXCOMMON_EXPORT HugePageResource : public MemoryResource
+{
+public:
+  static inline constexpr usize k_HugePageSize = 2ull << 20;
+  static inline constexpr usize k_DefaultMinHugePageSize = 16ull << 20;
+
+  /**
+   * @brief Constructs a resource that uses huge pages for allocations of at least minHugePageSize bytes.
+   * @param minHugePageSize
+   * @param upstream
+   */
+  explicit HugePageResource(usize minHugePageSize = k_DefaultMinHugePageSize, MemoryResource* upstream = GetDefaultMemoryResource());
+
+  HugePageResource(const HugePageResource&) = delete;
+  HugePageResource(HugePageResource&&) noexcept = delete;
+
+  HugePageResource& operator=(const HugePageResource&) = delete;
+  HugePageResource& operator=(HugePageResource&&) noexcept = delete;
+
+  ~HugePageResource() noexcept override;
+
+  /**
+   * @brief Returns the upstream resource.
+   * @return MemoryResource*
+   */
+  MemoryResource* upstream() const noexcept;
+
+protected:
+  void* doAllocate(usize numBytes, usize alignment) override;
+
+  void doDeallocate(void* ptr, usize numBytes, usize alignment) noexcept override;
+
+  bool doIsEqual(const MemoryResource& other) const noexcept override;
+
+private:
+  MemoryResource* m_Upstream = nullptr;
+  usize m_MinHugePageSize = 0;
+};
+} // namespace NX::Common
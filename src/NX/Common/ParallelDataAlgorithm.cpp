@@ -0,0 +1,65 @@
+#include "NX/Common/ParallelDataAlgorithm.hpp"
+
+#ifdef NXCOMMON_ENABLE_MULTICORE
+#include <tbb/task_arena.h>
+#elif defined(NXCOMMON_ENABLE_THREAD_POOL)
+#include "NX/Common/ThreadPool.hpp"
+#endif
+
+#include <algorithm>
+
+namespace NX::Common::detail
+{
+namespace
+{
+/**
+ * @brief Returns the number of elements a chunk should hold so that size elements make about k_ChunksPerThread chunks
+ * per thread.
+ */
+usize TargetChunkSize(usize size)
+{
+  return std::max<usize>(1, size / (MaxParallelism() * k_ChunksPerThread));
+}
+} // namespace
+
+usize MaxParallelism()
+{
+#ifdef NXCOMMON_ENABLE_MULTICORE
+  return static_cast<usize>(std::max(1, tbb::this_task_arena::max_concurrency()));
+#elif defined(NXCOMMON_ENABLE_THREAD_POOL)
+  return ThreadPool::Global().numThreads();
+#else
+  return 1;
+#endif
+}
+
+usize AutomaticGrain(const Range& range)
+{
+  return TargetChunkSize(range.size());
+}
+
+std::array<usize, 2> AutomaticGrain(const Range2D& range)
+{
+  const usize numCols = std::max<usize>(1, range.numCols());
+  const usize numRows = std::max<usize>(1, range.numRows());
+  const usize chunkSize = TargetChunkSize(numCols * numRows);
+  if(chunkSize >= numCols)
+  {
+    return {numCols, std::min(numRows, chunkSize / numCols)};
+  }
+  return {chunkSize, 1};
+}
+
+std::array<usize, 3> AutomaticGrain(const Range3D& range)
+{
+  const usize numX = std::max<usize>(1, range[1] - range[0]);
+  const usize numY = std::max<usize>(1, range[3] - range[2]);
+  const usize numZ = std::max<usize>(1, range[5] - range[4]);
+  const usize numRowsPerChunk = std::max<usize>(1, TargetChunkSize(numX * numY * numZ) / numX);
+  if(numRowsPerChunk >= numY)
+  {
+    return {numX, numY, std::min(numZ, numRowsPerChunk / numY)};
+  }
+  return {numX, numRowsPerChunk, 1};
+}
+} // namespace NX::Common::detail
@@ -0,0 +1,421 @@
+#pragma once
+
+#include "NX/Common/NXCommon_export.hpp"
+#include "NX/Common/Range.hpp"
+#include "NX/Common/Range2D.hpp"
+#include "NX/Common/Range3D.hpp"
+#include "NX/Common/Types.hpp"
+
+#ifdef NXCOMMON_ENABLE_MULTICORE
+#include <tbb/blocked_range.h>
+#include <tbb/blocked_range2d.h>
+#include <tbb/blocked_range3d.h>
+#include <tbb/parallel_for.h>
+#include <tbb/parallel_reduce.h>
+#include <tbb/partitioner.h>
+#elif defined(NXCOMMON_ENABLE_THREAD_POOL)
+#include "NX/Common/ThreadPool.hpp"
+
+#include <optional>
+#endif
+
+#include <array>
+#include <type_traits>
+#include <utility>
+
+namespace NX::Common
+{
+/**
+ * @brief Controls how the parallel Range algorithms split their range into chunks. Has no effect in single core builds.
+ * The built in ThreadPool backend always splits down to the grain like Simple.
+ */
+enum class Partitioner : uint8
+{
+  Auto = 0,   ///< Splits adaptively as threads run out of work, never below the grain. Best for most work.
+  Simple = 1, ///< Splits every chunk down to the grain. The chunks depend only on the range and grain, so reductions are deterministic.
+  Static = 2  ///< Splits the range evenly across the threads up front. Lowest overhead when every index costs the same. Reductions are deterministic for a fixed thread count.
+};
+
+namespace detail
+{
+/**
+ * @brief Number of chunks per thread the automatic grain aims for, enough for load balancing without much overhead.
+ */
+inline constexpr usize k_ChunksPerThread = 8;
+
+/**
+ * @brief Returns the number of threads the parallel algorithms may use. 1 in single core builds without the ThreadPool
+ * backend.
+ * @return usize
+ */
+NXCOMMON_EXPORT usize MaxParallelism();
+
+/**
+ * @brief Returns the grain that splits range into about k_ChunksPerThread chunks per thread.
+ * @param range
+ * @return usize
+ */
+NXCOMMON_EXPORT usize AutomaticGrain(const Range& range);
+
+/**
+ * @brief Returns the {column, row} grain that splits range into about k_ChunksPerThread chunks per thread.
+ * Rows are only split into columns when there are fewer rows than chunks, so chunks stay contiguous in memory.
+ * @param range
+ * @return std::array<usize, 2>
+ */
+NXCOMMON_EXPORT std::array<usize, 2> AutomaticGrain(const Range2D& range);
+
+/**
+ * @brief Returns the {x, y, z} grain that splits range into about k_ChunksPerThread chunks per thread.
+ * X is never split so that chunks are made of whole rows, then y is split before z.
+ * @param range
+ * @return std::array<usize, 3>
+ */
+NXCOMMON_EXPORT std::array<usize, 3> AutomaticGrain(const Range3D& range);
+
+template <class RangeT>
+struct RangeTraits;
+
+template <>
+struct RangeTraits<Range>
+{
+  using GrainType = usize;
+
+  static usize Size(const Range& range)
+  {
+    return range.size();
+  }
+
+  static bool IsDivisible(const Range& range, usize grain)
+  {
+    return range.size() > grain;
+  }
+
+  static std::pair<Range, Range> Split(const Range& range, usize)
+  {
+    const usize middle = range.min() + range.size() / 2;
+    return {Range(range.min(), middle), Range(middle, range.max())};
+  }
+
+#ifdef NXCOMMON_ENABLE_MULTICORE
+  static tbb::blocked_range<usize> ToTbb(const Range& range, usize grain)
+  {
+    return {range.min(), range.max(), grain};
+  }
+#endif
+};
+
+template <>
+struct RangeTraits<Range2D>
+{
+  using GrainType = std::array<usize, 2>;
+
+  static usize Size(const Range2D& range)
+  {
+    return range.numCols() * range.numRows();
+  }
+
+  static bool IsDivisible(const Range2D& range, const GrainType& grain)
+  {
+    return Size(range) != 0 && (range.numCols() > grain[0] || range.numRows() > grain[1]);
+  }
+
+  /**
+   * @brief Halves the dimension that is the most multiples of its grain, preferring rows on ties, like
+   * tbb::blocked_range2d.
+   */
+  static std::pair<Range2D, Range2D> Split(const Range2D& range, const GrainType& grain)
+  {
+    const usize numCols = range.numCols();
+    const usize numRows = range.numRows();
+    if(numCols > grain[0] && (numRows <= grain[1] || numCols * grain[1] > numRows * grain[0]))
+    {
+      const usize middle = range.minCol() + numCols / 2;
+      return {Range2D(range.minCol(), middle, range.minRow(), range.maxRow()), Range2D(middle, range.maxCol(), range.minRow(), range.maxRow())};
+    }
+    const usize middle = range.minRow() + numRows / 2;
+    return {Range2D(range.minCol(), range.maxCol(), range.minRow(), middle), Range2D(range.minCol(), range.maxCol(), middle, range.maxRow())};
+  }
+
+#ifdef NXCOMMON_ENABLE_MULTICORE
+  static tbb::blocked_range2d<usize, usize> ToTbb(const Range2D& range, const GrainType& grain)
+  {
+    return {range.minRow(), range.maxRow(), grain[1], range.minCol(), range.maxCol(), grain[0]};
+  }
+#endif
+};
+
+template <>
+struct RangeTraits<Range3D>
+{
+  using GrainType = std::array<usize, 3>;
+
+  static usize Size(const Range3D& range)
+  {
+    return (range[1] - range[0]) * (range[3] - range[2]) * (range[5] - range[4]);
+  }
+
+  static bool IsDivisible(const Range3D& range, const GrainType& grain)
+  {
+    return Size(range) != 0 && (range[1] - range[0] > grain[0] || range[3] - range[2] > grain[1] || range[5] - range[4] > grain[2]);
+  }
+
+  /**
+   * @brief Halves the dimension that is the most multiples of its grain, preferring z, then y, on ties.
+   */
+  static std::pair<Range3D, Range3D> Split(const Range3D& range, const GrainType& grain)
+  {
+    usize dimension = 2;
+    usize dimensionSize = 0;
+    for(usize i = 3; i-- > 0;)
+    {
+      const usize size = range[2 * i + 1] - range[2 * i];
+      if(size > grain[i] && (dimensionSize == 0 || size * grain[dimension] > dimensionSize * grain[i]))
+      {
+        dimension = i;
+        dimensionSize = size;
+      }
+    }
+    Range3D::RangeType lower = range.getRange();
+    Range3D::RangeType upper = lower;
+    lower[2 * dimension + 1] = lower[2 * dimension] + dimensionSize / 2;
+    upper[2 * dimension] = lower[2 * dimension + 1];
+    return {Range3D(lower[0], lower[1], lower[2], lower[3], lower[4], lower[5]), Range3D(upper[0], upper[1], upper[2], upper[3], upper[4], upper[5])};
+  }
+
+#ifdef NXCOMMON_ENABLE_MULTICORE
+  static tbb::blocked_range3d<usize> ToTbb(const Range3D& range, const GrainType& grain)
+  {
+    return {range[0], range[1], grain[0], range[2], range[3], grain[1], range[4], range[5], grain[2]};
+  }
+#endif
+};
+
+#if !defined(NXCOMMON_ENABLE_MULTICORE) && defined(NXCOMMON_ENABLE_THREAD_POOL)
+/**
+ * @brief Splits range down to the grain, queuing the upper halves on group and running body on the final lower half in
+ * the calling thread. Thieves therefore take the largest pieces first.
+ */
+template <class RangeT, class Body>
+void ForkJoinFor(TaskGroup& group, RangeT range, const typename RangeTraits<RangeT>::GrainType& grain, const Body& body)
+{
+  while(RangeTraits<RangeT>::IsDivisible(range, grain))
+  {
+    const auto halves = RangeTraits<RangeT>::Split(range, grain);
+    group.run([&group, upper = halves.second, &grain, &body]() { ForkJoinFor(group, upper, grain, body); });
+    range = halves.first;
+  }
+  body(range);
+}
+
+/**
+ * @brief Reduces range by recursive halving down to the grain. The splits depend only on the range and grain, so the
+ * result is deterministic.
+ */
+template <class RangeT, class T, class Body, class Join>
+T ForkJoinReduce(ThreadPool& pool, const RangeT& range, const typename RangeTraits<RangeT>::GrainType& grain, const T& identity, const Body& body, const Join& join)
+{
+  if(!RangeTraits<RangeT>::IsDivisible(range, grain))
+  {
+    return body(range, identity);
+  }
+  const auto halves = RangeTraits<RangeT>::Split(range, grain);
+  std::optional<T> upperValue;
+  TaskGroup group(pool);
+  group.run([&]() { upperValue.emplace(ForkJoinReduce(pool, halves.second, grain, identity, body, join)); });
+  T lowerValue = ForkJoinReduce(pool, halves.first, grain, identity, body, join);
+  group.wait();
+  return join(std::move(lowerValue), std::move(*upperValue));
+}
+#endif
+} // namespace detail
+
+/**
+ * @class ParallelRangeAlgorithm
+ * @brief ParallelRangeAlgorithm runs a body over a Range, Range2D or Range3D, in parallel with TBB when multicore support
+ * is enabled, with the built in ThreadPool when NXCOMMON_ENABLE_THREAD_POOL is defined instead, and serially otherwise.
+ * The body is called with disjoint sub ranges that together cover the range exactly once, so the same body works in
+ * every build. In single core builds or when parallelization is disabled it is called once with the whole range.
+ * @tparam RangeT Range, Range2D or Range3D
+ */
+template <class RangeT>
+class ParallelRangeAlgorithm
+{
+public:
+  using RangeType = RangeT;
+  using GrainType = typename detail::RangeTraits<RangeT>::GrainType;
+
+  ParallelRangeAlgorithm() = default;
+
+  explicit ParallelRangeAlgorithm(const RangeT& range)
+  : m_Range(range)
+  {
+  }
+
+  /**
+   * @brief Returns the range the algorithm runs over.
+   * @return const RangeT&
+   */
+  const RangeT& getRange() const
+  {
+    return m_Range;
+  }
+
+  void setRange(const RangeT& range)
+  {
+    m_Range = range;
+  }
+
+  /**
+   * @brief Returns the grain, the size below which chunks are not split. A zero grain, the default, is chosen
+   * automatically from the range size and the number of threads.
+   * @return GrainType
+   */
+  GrainType getGrain() const
+  {
+    return m_Grain;
+  }
+
+  void setGrain(const GrainType& grain)
+  {
+    m_Grain = grain;
+  }
+
+  Partitioner getPartitioner() const
+  {
+    return m_Partitioner;
+  }
+
+  void setPartitioner(Partitioner partitioner)
+  {
+    m_Partitioner = partitioner;
+  }
+
+  /**
+   * @brief Returns false if the body is to be called once with the whole range even in multicore builds. Useful for
+   * bodies that are not thread safe or work that is known to be too small to split.
+   * @return bool
+   */
+  bool getParallelizationEnabled() const
+  {
+    return m_RunParallel;
+  }
+
+  void setParallelizationEnabled(bool runParallel)
+  {
+    m_RunParallel = runParallel;
+  }
+
+  /**
+   * @brief Returns the grain that execute and reduce use, replacing zeros in the set grain with the automatic grain.
+   * @return GrainType
+   */
+  GrainType effectiveGrain() const
+  {
+    const GrainType automaticGrain = detail::AutomaticGrain(m_Range);
+    if constexpr(std::is_same_v<GrainType, usize>)
+    {
+      return m_Grain == 0 ? automaticGrain : m_Grain;
+    }
+    else
+    {
+      GrainType grain = m_Grain;
+      for(usize i = 0; i < grain.size(); i++)
+      {
+        grain[i] = grain[i] == 0 ? automaticGrain[i] : grain[i];
+      }
+      return grain;
+    }
+  }
+
+  /**
+   * @brief Calls body(subRange) for disjoint sub ranges that cover the range. Sub ranges may run concurrently.
+   * @param body Callable as body(const RangeT&)
+   */
+  template <class Body>
+  void execute(const Body& body) const
+  {
+#ifdef NXCOMMON_ENABLE_MULTICORE
+    const GrainType grain = effectiveGrain();
+    if(m_RunParallel && detail::RangeTraits<RangeT>::IsDivisible(m_Range, grain))
+    {
+      const auto tbbRange = detail::RangeTraits<RangeT>::ToTbb(m_Range, grain);
+      const auto tbbBody = [&body](const auto& subRange) { body(RangeT(subRange)); };
+      switch(m_Partitioner)
+      {
+      case Partitioner::Simple:
+        tbb::parallel_for(tbbRange, tbbBody, tbb::simple_partitioner());
+        return;
+      case Partitioner::Static:
+        tbb::parallel_for(tbbRange, tbbBody, tbb::static_partitioner());
+        return;
+      default:
+        tbb::parallel_for(tbbRange, tbbBody, tbb::auto_partitioner());
+        return;
+      }
+    }
+#elif defined(NXCOMMON_ENABLE_THREAD_POOL)
+    const GrainType grain = effectiveGrain();
+    if(m_RunParallel && detail::RangeTraits<RangeT>::IsDivisible(m_Range, grain))
+    {
+      TaskGroup group(ThreadPool::Global());
+      detail::ForkJoinFor(group, m_Range, grain, body);
+      group.wait();
+      return;
+    }
+#endif
+    body(m_Range);
+  }
+
+  /**
+   * @brief Reduces the range to a single value. Each sub range is reduced with body(subRange, value), which returns
+   * value combined with the contribution of subRange, and partial results are combined with join(lhs, rhs) where lhs
+   * covers the lower indices. With the Simple partitioner, and always with the ThreadPool backend, the chunks and the
+   * order of the joins depend only on the range and grain, so floating point results are reproducible from run to run.
+   * The Static partitioner splits by the number of threads as well, so its results are only reproducible for a fixed
+   * thread count.
+   * @param identity Value that join leaves unchanged, used to start every chunk
+   * @param body Callable as T body(const RangeT&, T)
+   * @param join Callable as T join(T, T)
+   * @return T
+   */
+  template <class T, class Body, class Join>
+  T reduce(const T& identity, const Body& body, [[maybe_unused]] const Join& join) const
+  {
+#ifdef NXCOMMON_ENABLE_MULTICORE
+    const GrainType grain = effectiveGrain();
+    if(m_RunParallel && detail::RangeTraits<RangeT>::IsDivisible(m_Range, grain))
+    {
+      const auto tbbRange = detail::RangeTraits<RangeT>::ToTbb(m_Range, grain);
+      const auto tbbBody = [&body](const auto& subRange, const T& value) { return body(RangeT(subRange), value); };
+      switch(m_Partitioner)
+      {
+      case Partitioner::Simple:
+        return tbb::parallel_deterministic_reduce(tbbRange, identity, tbbBody, join, tbb::simple_partitioner());
+      case Partitioner::Static:
+        return tbb::parallel_deterministic_reduce(tbbRange, identity, tbbBody, join, tbb::static_partitioner());
+      default:
+        return tbb::parallel_reduce(tbbRange, identity, tbbBody, join, tbb::auto_partitioner());
+      }
+    }
+#elif defined(NXCOMMON_ENABLE_THREAD_POOL)
+    const GrainType grain = effectiveGrain();
+    if(m_RunParallel && detail::RangeTraits<RangeT>::IsDivisible(m_Range, grain))
+    {
+      return detail::ForkJoinReduce(ThreadPool::Global(), m_Range, grain, identity, body, join);
+    }
+#endif
+    return body(m_Range, identity);
+  }
+
+private:
+  RangeT m_Range;
+  GrainType m_Grain = {};
+  Partitioner m_Partitioner = Partitioner::Auto;
+  bool m_RunParallel = true;
+};
+
+using ParallelDataAlgorithm = ParallelRangeAlgorithm<Range>;
+using ParallelData2DAlgorithm = ParallelRangeAlgorithm<Range2D>;
+using ParallelData3DAlgorithm = ParallelRangeAlgorithm<Range3D>;
+} // namespace NX::Common
@@ -50,11 +50,17 @@ Range2D::Range2D(size_t colStart, size_t colEnd, size_t rowStart, size_t rowEnd)
 #ifdef NXCOMMON_ENABLE_MULTICORE
 // -----------------------------------------------------------------------------
 Range2D::Range2D(const tbb::blocked_range2d<size_t, size_t>& r)
-: m_Range({{r.rows().begin(), r.cols().begin(), r.rows().end(), r.cols().end()}})
+: m_Range({{r.cols().begin(), r.cols().end(), r.rows().begin(), r.rows().end()}})
 {
 }
 #endif
 
+// -----------------------------------------------------------------------------
+Range2D::RangeType Range2D::getRange() const
+{
+  return m_Range;
+}
+
 // -----------------------------------------------------------------------------
 size_t Range2D::minRow() const
 {
@@ -0,0 +1,469 @@
+#include "NX/Common/Reduction.hpp"
+
+#include "NX/Common/CpuFeatures.hpp"
+#include "NX/Common/ParallelDataAlgorithm.hpp"
+
+#if defined(NXCOMMON_ARCH_X86)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <vector>
+
+namespace NX::Common
+{
+namespace
+{
+/**
+ * @brief Every kernel accumulates element i of a block into lane i % k_NumLanes and the lanes are combined in a fixed
+ * order, so scalar and SIMD kernels perform the same floating point operations in the same order.
+ */
+constexpr usize k_NumLanes = 8;
+
+/**
+ * @brief Number of elements reduced per block. Blocks are the unit of parallelism and are combined in order,
+ * which keeps results independent of the number of threads.
+ */
+constexpr usize k_BlockSize = 1ull << 16;
+
+template <class T>
+bool IsNan(T value)
+{
+  if constexpr(std::is_floating_point_v<T>)
+  {
+    return std::isnan(value);
+  }
+  else
+  {
+    return false;
+  }
+}
+
+template <class T>
+constexpr T InitialMin()
+{
+  return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+}
+
+template <class T>
+constexpr T InitialMax()
+{
+  return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::lowest();
+}
+
+// A NaN operand replaces the current value under NanPolicy::Propagate and never does under NanPolicy::Ignore.
+// The SIMD kernels implement exactly these comparisons.
+template <class T, bool IgnoreNan>
+T MinStep(T current, T value)
+{
+  return (value < current || (!IgnoreNan && IsNan(value))) ? value : current;
+}
+
+template <class T, bool IgnoreNan>
+T MaxStep(T current, T value)
+{
+  return (value > current || (!IgnoreNan && IsNan(value))) ? value : current;
+}
+
+template <class T>
+struct Lanes
+{
+  T min[k_NumLanes];
+  T max[k_NumLanes];
+  float64 sum[k_NumLanes] = {};
+  float64 sumOfSquares[k_NumLanes] = {};
+  usize count = 0;
+
+  Lanes()
+  {
+    std::fill(std::begin(min), std::end(min), InitialMin<T>());
+    std::fill(std::begin(max), std::end(max), InitialMax<T>());
+  }
+};
+
+template <class T>
+struct BlockResult
+{
+  T min = InitialMin<T>();
+  T max = InitialMax<T>();
+  float64 sum = 0.0;
+  float64 sumOfSquares = 0.0;
+  usize count = 0;
+};
+
+/**
+ * @brief Accumulates data[i] into lane i % k_NumLanes. data must start on a lane boundary of its block.
+ */
+template <class T, bool IgnoreNan>
+void ScalarKernel(const T* data, usize size, float64 shift, Lanes<T>& lanes)
+{
+  for(usize i = 0; i < size; i++)
+  {
+    const usize lane = i % k_NumLanes;
+    const T value = data[i];
+    lanes.min[lane] = MinStep<T, IgnoreNan>(lanes.min[lane], value);
+    lanes.max[lane] = MaxStep<T, IgnoreNan>(lanes.max[lane], value);
+    if(IgnoreNan && IsNan(value))
+    {
+      continue;
+    }
+    const float64 shifted = static_cast<float64>(value) - shift;
+    lanes.sum[lane] += shifted;
+    lanes.sumOfSquares[lane] += shifted * shifted;
+    lanes.count++;
+  }
+}
+
+#if defined(NXCOMMON_ARCH_X86)
+/**
+ * @brief Returns the number of set bits in a movemask result. NaNs are rare so the loop almost never runs.
+ */
+inline uint32 CountNans(uint32 mask)
+{
+  uint32 count = 0;
+  for(; mask != 0; mask &= mask - 1)
+  {
+    count++;
+  }
+  return count;
+}
+
+/**
+ * @brief Adds low - shift and high - shift and their squares to the low and high four lanes.
+ * Multiply and add are kept separate to match the rounding of the scalar kernel.
+ */
+NXCOMMON_TARGET("avx2") inline void AccumulateAvx2(__m256d low, __m256d high, __m256d shift, __m256d& sumLow, __m256d& sumHigh, __m256d& squaresLow, __m256d& squaresHigh)
+{
+  low = _mm256_sub_pd(low, shift);
+  high = _mm256_sub_pd(high, shift);
+  sumLow = _mm256_add_pd(sumLow, low);
+  sumHigh = _mm256_add_pd(sumHigh, high);
+  squaresLow = _mm256_add_pd(squaresLow, _mm256_mul_pd(low, low));
+  squaresHigh = _mm256_add_pd(squaresHigh, _mm256_mul_pd(high, high));
+}
+
+template <bool IgnoreNan>
+NXCOMMON_TARGET("avx2") inline void MinMaxStepAvx2(__m256d values, __m256d isNan, __m256d& min, __m256d& max)
+{
+  __m256d takeMin = _mm256_cmp_pd(values, min, _CMP_LT_OQ);
+  __m256d takeMax = _mm256_cmp_pd(values, max, _CMP_GT_OQ);
+  if constexpr(!IgnoreNan)
+  {
+    takeMin = _mm256_or_pd(takeMin, isNan);
+    takeMax = _mm256_or_pd(takeMax, isNan);
+  }
+  min = _mm256_blendv_pd(min, values, takeMin);
+  max = _mm256_blendv_pd(max, values, takeMax);
+}
+
+template <bool IgnoreNan>
+NXCOMMON_TARGET("avx2") void Float32Avx2Kernel(const float32* data, usize size, float64 shift, Lanes<float32>& lanes)
+{
+  __m256 min = _mm256_loadu_ps(lanes.min);
+  __m256 max = _mm256_loadu_ps(lanes.max);
+  __m256d sumLow = _mm256_loadu_pd(lanes.sum);
+  __m256d sumHigh = _mm256_loadu_pd(lanes.sum + 4);
+  __m256d squaresLow = _mm256_loadu_pd(lanes.sumOfSquares);
+  __m256d squaresHigh = _mm256_loadu_pd(lanes.sumOfSquares + 4);
+  const __m256d shiftVector = _mm256_set1_pd(shift);
+
+  usize i = 0;
+  for(; i + k_NumLanes <= size; i += k_NumLanes)
+  {
+    const __m256 values = _mm256_loadu_ps(data + i);
+    const __m256 isNan = _mm256_cmp_ps(values, values, _CMP_UNORD_Q);
+    __m256 takeMin = _mm256_cmp_ps(values, min, _CMP_LT_OQ);
+    __m256 takeMax = _mm256_cmp_ps(values, max, _CMP_GT_OQ);
+    if constexpr(!IgnoreNan)
+    {
+      takeMin = _mm256_or_ps(takeMin, isNan);
+      takeMax = _mm256_or_ps(takeMax, isNan);
+    }
+    min = _mm256_blendv_ps(min, values, takeMin);
+    max = _mm256_blendv_ps(max, values, takeMax);
+
+    __m256d low = _mm256_cvtps_pd(_mm256_castps256_ps128(values));
+    __m256d high = _mm256_cvtps_pd(_mm256_extractf128_ps(values, 1));
+    if constexpr(IgnoreNan)
+    {
+      // Ignored values must add exactly 0 like they do in the scalar kernel
+      low = _mm256_blendv_pd(low, shiftVector, _mm256_cmp_pd(low, low, _CMP_UNORD_Q));
+      high = _mm256_blendv_pd(high, shiftVector, _mm256_cmp_pd(high, high, _CMP_UNORD_Q));
+      lanes.count += k_NumLanes - CountNans(static_cast<uint32>(_mm256_movemask_ps(isNan)));
+    }
+    else
+    {
+      lanes.count += k_NumLanes;
+    }
+    AccumulateAvx2(low, high, shiftVector, sumLow, sumHigh, squaresLow, squaresHigh);
+  }
+
+  _mm256_storeu_ps(lanes.min, min);
+  _mm256_storeu_ps(lanes.max, max);
+  _mm256_storeu_pd(lanes.sum, sumLow);
+  _mm256_storeu_pd(lanes.sum + 4, sumHigh);
+  _mm256_storeu_pd(lanes.sumOfSquares, squaresLow);
+  _mm256_storeu_pd(lanes.sumOfSquares + 4, squaresHigh);
+  ScalarKernel<float32, IgnoreNan>(data + i, size - i, shift, lanes);
+}
+
+template <bool IgnoreNan>
+NXCOMMON_TARGET("avx2") void Float64Avx2Kernel(const float64* data, usize size, float64 shift, Lanes<float64>& lanes)
+{
+  __m256d minLow = _mm256_loadu_pd(lanes.min);
+  __m256d minHigh = _mm256_loadu_pd(lanes.min + 4);
+  __m256d maxLow = _mm256_loadu_pd(lanes.max);
+  __m256d maxHigh = _mm256_loadu_pd(lanes.max + 4);
+  __m256d sumLow = _mm256_loadu_pd(lanes.sum);
+  __m256d sumHigh = _mm256_loadu_pd(lanes.sum + 4);
+  __m256d squaresLow = _mm256_loadu_pd(lanes.sumOfSquares);
+  __m256d squaresHigh = _mm256_loadu_pd(lanes.sumOfSquares + 4);
+  const __m256d shiftVector = _mm256_set1_pd(shift);
+
+  usize i = 0;
+  for(; i + k_NumLanes <= size; i += k_NumLanes)
+  {
+    __m256d low = _mm256_loadu_pd(data + i);
+    __m256d high = _mm256_loadu_pd(data + i + 4);
+    const __m256d lowNan = _mm256_cmp_pd(low, low, _CMP_UNORD_Q);
+    const __m256d highNan = _mm256_cmp_pd(high, high, _CMP_UNORD_Q);
+    MinMaxStepAvx2<IgnoreNan>(low, lowNan, minLow, maxLow);
+    MinMaxStepAvx2<IgnoreNan>(high, highNan, minHigh, maxHigh);
+    if constexpr(IgnoreNan)
+    {
+      low = _mm256_blendv_pd(low, shiftVector, lowNan);
+      high = _mm256_blendv_pd(high, shiftVector, highNan);
+      const auto nanMask = static_cast<uint32>(_mm256_movemask_pd(lowNan) | (_mm256_movemask_pd(highNan) << 4));
+      lanes.count += k_NumLanes - static_cast<usize>(CountNans(nanMask));
+    }
+    else
+    {
+      lanes.count += k_NumLanes;
+    }
+    AccumulateAvx2(low, high, shiftVector, sumLow, sumHigh, squaresLow, squaresHigh);
+  }
+
+  _mm256_storeu_pd(lanes.min, minLow);
+  _mm256_storeu_pd(lanes.min + 4, minHigh);
+  _mm256_storeu_pd(lanes.max, maxLow);
+  _mm256_storeu_pd(lanes.max + 4, maxHigh);
+  _mm256_storeu_pd(lanes.sum, sumLow);
+  _mm256_storeu_pd(lanes.sum + 4, sumHigh);
+  _mm256_storeu_pd(lanes.sumOfSquares, squaresLow);
+  _mm256_storeu_pd(lanes.sumOfSquares + 4, squaresHigh);
+  ScalarKernel<float64, IgnoreNan>(data + i, size - i, shift, lanes);
+}
+
+template <bool IgnoreNan>
+NXCOMMON_TARGET("avx2") void Int32Avx2Kernel(const int32* data, usize size, float64 shift, Lanes<int32>& lanes)
+{
+  __m256i min = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes.min));
+  __m256i max = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lanes.max));
+  __m256d sumLow = _mm256_loadu_pd(lanes.sum);
+  __m256d sumHigh = _mm256_loadu_pd(lanes.sum + 4);
+  __m256d squaresLow = _mm256_loadu_pd(lanes.sumOfSquares);
+  __m256d squaresHigh = _mm256_loadu_pd(lanes.sumOfSquares + 4);
+  const __m256d shiftVector = _mm256_set1_pd(shift);
+
+  usize i = 0;
+  for(; i + k_NumLanes <= size; i += k_NumLanes)
+  {
+    const __m256i values = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + i));
+    min = _mm256_min_epi32(min, values);
+    max = _mm256_max_epi32(max, values);
+    const __m256d low = _mm256_cvtepi32_pd(_mm256_castsi256_si128(values));
+    const __m256d high = _mm256_cvtepi32_pd(_mm256_extracti128_si256(values, 1));
+    AccumulateAvx2(low, high, shiftVector, sumLow, sumHigh, squaresLow, squaresHigh);
+  }
+  lanes.count += i;
+
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes.min), min);
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes.max), max);
+  _mm256_storeu_pd(lanes.sum, sumLow);
+  _mm256_storeu_pd(lanes.sum + 4, sumHigh);
+  _mm256_storeu_pd(lanes.sumOfSquares, squaresLow);
+  _mm256_storeu_pd(lanes.sumOfSquares + 4, squaresHigh);
+  ScalarKernel<int32, IgnoreNan>(data + i, size - i, shift, lanes);
+}
+#endif
+
+template <class T, bool IgnoreNan>
+using KernelFunc = void (*)(const T*, usize, float64, Lanes<T>&);
+
+template <class T, bool IgnoreNan>
+KernelFunc<T, IgnoreNan> SelectKernel()
+{
+#if defined(NXCOMMON_ARCH_X86)
+  if(GetCpuFeatures().avx2)
+  {
+    if constexpr(std::is_same_v<T, float32>)
+    {
+      return Float32Avx2Kernel<IgnoreNan>;
+    }
+    else if constexpr(std::is_same_v<T, float64>)
+    {
+      return Float64Avx2Kernel<IgnoreNan>;
+    }
+    else if constexpr(std::is_same_v<T, int32>)
+    {
+      return Int32Avx2Kernel<IgnoreNan>;
+    }
+  }
+#endif
+  return ScalarKernel<T, IgnoreNan>;
+}
+
+template <class T, bool IgnoreNan>
+BlockResult<T> ReduceBlock(const T* data, usize size, float64 shift)
+{
+  static const KernelFunc<T, IgnoreNan> kernel = SelectKernel<T, IgnoreNan>();
+
+  Lanes<T> lanes;
+  kernel(data, size, shift, lanes);
+
+  // Fixed pairwise order shared by every kernel
+  BlockResult<T> result;
+  for(usize width = k_NumLanes / 2; width > 0; width /= 2)
+  {
+    for(usize lane = 0; lane < width; lane++)
+    {
+      lanes.min[lane] = MinStep<T, IgnoreNan>(lanes.min[lane], lanes.min[lane + width]);
+      lanes.max[lane] = MaxStep<T, IgnoreNan>(lanes.max[lane], lanes.max[lane + width]);
+      lanes.sum[lane] += lanes.sum[lane + width];
+      lanes.sumOfSquares[lane] += lanes.sumOfSquares[lane + width];
+    }
+  }
+  result.min = lanes.min[0];
+  result.max = lanes.max[0];
+  result.sum = lanes.sum[0];
+  result.sumOfSquares = lanes.sumOfSquares[0];
+  result.count = lanes.count;
+  return result;
+}
+
+template <class T, bool IgnoreNan>
+Statistics<T> ComputeStatisticsImpl(const T* data, usize size)
+{
+  // Reducing values relative to one of them keeps squaredDeviations accurate when the mean is large relative to the spread
+  float64 shift = 0.0;
+  if(size > 0 && std::isfinite(static_cast<float64>(data[0])))
+  {
+    shift = static_cast<float64>(data[0]);
+  }
+
+  const usize numBlocks = (size + k_BlockSize - 1) / k_BlockSize;
+  std::vector<BlockResult<T>> blocks(numBlocks);
+  ParallelDataAlgorithm algorithm(Range(0, numBlocks));
+  algorithm.setGrain(1);
+  algorithm.execute([data, size, shift, blockResults = blocks.data()](const Range& range) {
+    for(usize block = range.min(); block < range.max(); block++)
+    {
+      const usize offset = block * k_BlockSize;
+      blockResults[block] = ReduceBlock<T, IgnoreNan>(data + offset, std::min(k_BlockSize, size - offset), shift);
+    }
+  });
+
+  BlockResult<T> total;
+  for(const BlockResult<T>& block : blocks)
+  {
+    total.min = MinStep<T, IgnoreNan>(total.min, block.min);
+    total.max = MaxStep<T, IgnoreNan>(total.max, block.max);
+    total.sum += block.sum;
+    total.sumOfSquares += block.sumOfSquares;
+    total.count += block.count;
+  }
+
+  Statistics<T> statistics;
+  statistics.count = total.count;
+  if(total.count == 0)
+  {
+    if constexpr(std::is_floating_point_v<T>)
+    {
+      statistics.min = std::numeric_limits<T>::quiet_NaN();
+      statistics.max = std::numeric_limits<T>::quiet_NaN();
+    }
+    return statistics;
+  }
+
+  const auto count = static_cast<float64>(total.count);
+  statistics.min = total.min;
+  statistics.max = total.max;
+  statistics.sum = shift * count + total.sum;
+  statistics.sumOfSquares = total.sumOfSquares + 2.0 * shift * total.sum + count * shift * shift;
+  // std::max keeps a NaN first argument
+  statistics.squaredDeviations = std::max(total.sumOfSquares - total.sum * total.sum / count, 0.0);
+  return statistics;
+}
+
+template <class T>
+Statistics<T> ComputeStatisticsDispatch(const T* data, usize size, NanPolicy nanPolicy)
+{
+  if constexpr(std::is_floating_point_v<T>)
+  {
+    if(nanPolicy == NanPolicy::Ignore)
+    {
+      return ComputeStatisticsImpl<T, true>(data, size);
+    }
+  }
+  return ComputeStatisticsImpl<T, false>(data, size);
+}
+} // namespace
+
+namespace detail
+{
+Statistics<int8> ComputeStatistics(const int8* data, usize size, NanPolicy nanPolicy)
+{
+  return ComputeStatisticsDispatch(data, size, nanPolicy);
+}
+
+Statistics<uint8> ComputeStatistics(const uint8* data, usize size, NanPolicy nanPolicy)
+{
+  return ComputeStatisticsDispatch(data, size, nanPolicy);
+}
+
+Statistics<int16> ComputeStatistics(const int16* data, usize size, NanPolicy nanPolicy)
+{
+  return ComputeStatisticsDispatch(data, size, nanPolicy);
+}
+
+Statistics<uint16> ComputeStatistics(const uint16* data, usize size, NanPolicy nanPolicy)
+{
+  return ComputeStatisticsDispatch(data, size, nanPolicy);
+}
+
+Statistics<int32> ComputeStatistics(const int32* data, usize size, NanPolicy nanPolicy)
+{
+  return ComputeStatisticsDispatch(data, size, nanPolicy);
+}
+
+Statistics<uint32> ComputeStatistics(const uint32* data, usize size, NanPolicy nanPolicy)
+{
+  return ComputeStatisticsDispatch(data, size, nanPolicy);
+}
+
+Statistics<int64> ComputeStatistics(const int64* data, usize size, NanPolicy nanPolicy)
+{
+  return ComputeStatisticsDispatch(data, size, nanPolicy);
+}
+
+Statistics<uint64> ComputeStatistics(const uint64* data, usize size, NanPolicy nanPolicy)
+{
+  return ComputeStatisticsDispatch(data, size, nanPolicy);
+}
+
+Statistics<float32> ComputeStatistics(const float32* data, usize size, NanPolicy nanPolicy)
+{
+  return ComputeStatisticsDispatch(data, size, nanPolicy);
+}
+
+Statistics<float64> ComputeStatistics(const float64* data, usize size, NanPolicy nanPolicy)
+{
+  return ComputeStatisticsDispatch(data, size, nanPolicy);
+}
+
+Statistics<bool> ComputeStatistics(const bool* data, usize size, NanPolicy nanPolicy)
+{
+  return ComputeStatisticsDispatch(data, size, nanPolicy);
+}
+} // namespace detail
+} // namespace NX::Common
@@ -0,0 +1,179 @@
+#pragma once
+
+#include "NX/Common/DataVector.hpp"
+#include "NX/Common/NXCommon_export.hpp"
+#include "NX/Common/Types.hpp"
+
+#include "nonstd/span.hpp"
+
+#include <cmath>
+#include <limits>
+#include <type_traits>
+
+namespace NX::Common
+{
+/**
+ * @brief Controls how floating point reductions treat NaN values. Has no effect on integer types.
+ */
+enum class NanPolicy : uint8
+{
+  Propagate = 0, ///< Any NaN makes min, max, sum and variance NaN.
+  Ignore = 1     ///< NaNs are skipped as if they were not part of the input, like numpy's nan* functions.
+};
+
+/**
+ * @brief Statistics holds the result of the fused min, max, sum and sum of squares reduction done by ComputeStatistics.
+ * If no values were reduced, min and max are NaN for floating point types and 0 otherwise.
+ * @tparam T
+ */
+template <class T>
+struct Statistics
+{
+  T min = {};
+  T max = {};
+  usize count = 0;                 ///< Number of values reduced, not counting ignored NaNs.
+  float64 sum = 0.0;               ///< Sum of the values.
+  float64 sumOfSquares = 0.0;      ///< Sum of the squares of the values.
+  float64 squaredDeviations = 0.0; ///< Sum of the squared deviations from the mean, free of the cancellation in sumOfSquares - sum * sum / count.
+
+  /**
+   * @brief Returns the arithmetic mean, or NaN if count is 0.
+   * @return float64
+   */
+  float64 mean() const
+  {
+    return count == 0 ? std::numeric_limits<float64>::quiet_NaN() : sum / static_cast<float64>(count);
+  }
+
+  /**
+   * @brief Returns the variance with count - ddof degrees of freedom, or NaN if count is not greater than ddof.
+   * ddof = 0 is the population variance and ddof = 1 the sample variance.
+   * @param ddof
+   * @return float64
+   */
+  float64 variance(usize ddof = 0) const
+  {
+    return count <= ddof ? std::numeric_limits<float64>::quiet_NaN() : squaredDeviations / static_cast<float64>(count - ddof);
+  }
+
+  /**
+   * @brief Returns the square root of variance(ddof).
+   * @param ddof
+   * @return float64
+   */
+  float64 standardDeviation(usize ddof = 0) const
+  {
+    return std::sqrt(variance(ddof));
+  }
+};
+
+namespace detail
+{
+NXCOMMON_EXPORT Statistics<int8> ComputeStatistics(const int8* data, usize size, NanPolicy nanPolicy);
+NXCOMMON_EXPORT Statistics<uint8> ComputeStatistics(const uint8* data, usize size, NanPolicy nanPolicy);
+NXCOMMON_EXPORT Statistics<int16> ComputeStatistics(const int16* data, usize size, NanPolicy nanPolicy);
+NXCOMMON_EXPORT Statistics<uint16> ComputeStatistics(const uint16* data, usize size, NanPolicy nanPolicy);
+NXCOMMON_EXPORT Statistics<int32> ComputeStatistics(const int32* data, usize size, NanPolicy nanPolicy);
+NXCOMMON_EXPORT Statistics<uint32> ComputeStatistics(const uint32* data, usize size, NanPolicy nanPolicy);
+NXCOMMON_EXPORT Statistics<int64> ComputeStatistics(const int64* data, usize size, NanPolicy nanPolicy);
+NXCOMMON_EXPORT Statistics<uint64> ComputeStatistics(const uint64* data, usize size, NanPolicy nanPolicy);
+NXCOMMON_EXPORT Statistics<float32> ComputeStatistics(const float32* data, usize size, NanPolicy nanPolicy);
+NXCOMMON_EXPORT Statistics<float64> ComputeStatistics(const float64* data, usize size, NanPolicy nanPolicy);
+NXCOMMON_EXPORT Statistics<bool> ComputeStatistics(const bool* data, usize size, NanPolicy nanPolicy);
+} // namespace detail
+
+/**
+ * @brief Computes min, max, sum and sum of squares of values in a single pass. float32, float64 and int32 use AVX2
+ * when available and large inputs are split across threads through ParallelDataAlgorithm.
+ * Values are reduced in fixed size blocks combined in a fixed order, so the result is bit for bit the same
+ * regardless of the number of threads or the instruction set used.
+ * @tparam T Any type of NX::DataType
+ * @param values
+ * @param nanPolicy
+ * @return Statistics<T>
+ */
+template <class T>
+Statistics<std::remove_cv_t<T>> ComputeStatistics(nonstd::span<T> values, NanPolicy nanPolicy = NanPolicy::Propagate)
+{
+  return detail::ComputeStatistics(values.data(), values.size(), nanPolicy);
+}
+
+/**
+ * @brief Computes min, max, sum and sum of squares of every element of values. See ComputeStatistics(nonstd::span<T>, NanPolicy).
+ * @tparam T
+ * @param values
+ * @param nanPolicy
+ * @return Statistics<T>
+ */
+template <class T>
+Statistics<T> ComputeStatistics(const DataVector<T>& values, NanPolicy nanPolicy = NanPolicy::Propagate)
+{
+  return ComputeStatistics(values.createSpan(), nanPolicy);
+}
+
+/**
+ * @brief Returns the smallest value. See ComputeStatistics for the handling of NaN and empty input.
+ * @tparam T
+ * @param values
+ * @param nanPolicy
+ * @return T
+ */
+template <class T>
+std::remove_cv_t<T> Min(nonstd::span<T> values, NanPolicy nanPolicy = NanPolicy::Propagate)
+{
+  return ComputeStatistics(values, nanPolicy).min;
+}
+
+/**
+ * @brief Returns the largest value. See ComputeStatistics for the handling of NaN and empty input.
+ * @tparam T
+ * @param values
+ * @param nanPolicy
+ * @return T
+ */
+template <class T>
+std::remove_cv_t<T> Max(nonstd::span<T> values, NanPolicy nanPolicy = NanPolicy::Propagate)
+{
+  return ComputeStatistics(values, nanPolicy).max;
+}
+
+/**
+ * @brief Returns the sum of the values accumulated in double precision.
+ * @tparam T
+ * @param values
+ * @param nanPolicy
+ * @return float64
+ */
+template <class T>
+float64 Sum(nonstd::span<T> values, NanPolicy nanPolicy = NanPolicy::Propagate)
+{
+  return ComputeStatistics(values, nanPolicy).sum;
+}
+
+/**
+ * @brief Returns the arithmetic mean of the values, or NaN if there are none.
+ * @tparam T
+ * @param values
+ * @param nanPolicy
+ * @return float64
+ */
+template <class T>
+float64 Mean(nonstd::span<T> values, NanPolicy nanPolicy = NanPolicy::Propagate)
+{
+  return ComputeStatistics(values, nanPolicy).mean();
+}
+
+/**
+ * @brief Returns the variance of the values with size - ddof degrees of freedom.
+ * @tparam T
+ * @param values
+ * @param ddof
+ * @param nanPolicy
+ * @return float64
+ */
+template <class T>
+float64 Variance(nonstd::span<T> values, usize ddof = 0, NanPolicy nanPolicy = NanPolicy::Propagate)
+{
+  return ComputeStatistics(values, nanPolicy).variance(ddof);
+}
+} // namespace NX::Common
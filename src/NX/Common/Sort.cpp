@@ -0,0 +1,379 @@
+#include "NX/Common/Sort.hpp"
+
+#include "NX/Common/Bit.hpp"
+#include "NX/Common/ParallelDataAlgorithm.hpp"
+
+#include <array>
+#include <cstring>
+#include <optional>
+#include <vector>
+
+namespace NX::Common::detail
+{
+namespace
+{
+/**
+ * @brief Arrays shorter than this are sorted with std::sort on their keys since the radix passes would be dominated by
+ * clearing and scanning the histograms.
+ */
+constexpr usize k_RadixSortThreshold = 256;
+
+/**
+ * @brief Number of elements each block histograms and scatters. Arrays with at most one block are sorted serially.
+ */
+constexpr usize k_BlockSize = 1ull << 16;
+
+constexpr usize k_RadixBits = 8;
+constexpr usize k_NumBuckets = 1ull << k_RadixBits;
+
+using Histogram = std::array<usize, k_NumBuckets>;
+
+template <usize Size>
+struct UnsignedOfSize;
+
+template <>
+struct UnsignedOfSize<1>
+{
+  using type = uint8;
+};
+
+template <>
+struct UnsignedOfSize<2>
+{
+  using type = uint16;
+};
+
+template <>
+struct UnsignedOfSize<4>
+{
+  using type = uint32;
+};
+
+template <>
+struct UnsignedOfSize<8>
+{
+  using type = uint64;
+};
+
+template <class T>
+using KeyType = typename UnsignedOfSize<sizeof(T)>::type;
+
+/**
+ * @brief Maps value to an unsigned key whose unsigned order is the ascending order of T.
+ * Signed integers have their sign bit flipped. Floats have every bit flipped if negative and only the sign bit otherwise.
+ */
+template <class T>
+KeyType<T> ToKey(T value)
+{
+  using KeyT = KeyType<T>;
+  constexpr KeyT k_SignBit = KeyT(1) << (sizeof(T) * 8 - 1);
+  const auto bits = bit_cast<KeyT>(value);
+  if constexpr(std::is_floating_point_v<T>)
+  {
+    return (bits & k_SignBit) != 0 ? static_cast<KeyT>(~bits) : static_cast<KeyT>(bits | k_SignBit);
+  }
+  else if constexpr(std::is_signed_v<T>)
+  {
+    return static_cast<KeyT>(bits ^ k_SignBit);
+  }
+  else
+  {
+    return bits;
+  }
+}
+
+template <class T>
+T FromKey(KeyType<T> key)
+{
+  using KeyT = KeyType<T>;
+  constexpr KeyT k_SignBit = KeyT(1) << (sizeof(T) * 8 - 1);
+  if constexpr(std::is_floating_point_v<T>)
+  {
+    return bit_cast<T>((key & k_SignBit) != 0 ? static_cast<KeyT>(key ^ k_SignBit) : static_cast<KeyT>(~key));
+  }
+  else if constexpr(std::is_signed_v<T>)
+  {
+    return bit_cast<T>(static_cast<KeyT>(key ^ k_SignBit));
+  }
+  else
+  {
+    return bit_cast<T>(key);
+  }
+}
+
+/**
+ * @brief Calls func(block, begin, end) for each block of k_BlockSize elements. Blocks run in parallel through
+ * ParallelDataAlgorithm. The block boundaries never depend on the number of threads so the result is deterministic.
+ */
+template <class Func>
+void ForEachBlock(usize size, usize numBlocks, Func&& func)
+{
+  ParallelDataAlgorithm algorithm(Range(0, numBlocks));
+  algorithm.setGrain(1);
+  algorithm.execute([size, &func](const Range& blocks) {
+    for(usize block = blocks.min(); block < blocks.max(); block++)
+    {
+      func(block, block * k_BlockSize, std::min(size, (block + 1) * k_BlockSize));
+    }
+  });
+}
+
+/**
+ * @brief Stable LSD radix sort of keys, carrying indices along if they are not null.
+ * Each pass histograms the digit per block, turns the histograms into per block output offsets ordered by digit then
+ * block, and scatters every block independently. Passes in which every key has the same digit are skipped.
+ * The sorted keys and indices are written back to keys and indices.
+ */
+template <class KeyT>
+void RadixSort(KeyT* keys, uint64* indices, usize size)
+{
+  const usize numBlocks = (size + k_BlockSize - 1) / k_BlockSize;
+  std::vector<Histogram> histograms(numBlocks);
+  DataVector<KeyT> keyBuffer(size, InitializationMode::Uninitialized);
+  std::optional<DataVector<uint64>> indexBuffer;
+  if(indices != nullptr)
+  {
+    indexBuffer.emplace(size, InitializationMode::Uninitialized);
+  }
+
+  KeyT* sourceKeys = keys;
+  KeyT* destinationKeys = keyBuffer.data();
+  uint64* sourceIndices = indices;
+  uint64* destinationIndices = indexBuffer ? indexBuffer->data() : nullptr;
+
+  for(usize shift = 0; shift < sizeof(KeyT) * 8; shift += k_RadixBits)
+  {
+    ForEachBlock(size, numBlocks, [&histograms, sourceKeys, shift](usize block, usize begin, usize end) {
+      Histogram& histogram = histograms[block];
+      histogram.fill(0);
+      for(usize i = begin; i < end; i++)
+      {
+        histogram[(sourceKeys[i] >> shift) & (k_NumBuckets - 1)]++;
+      }
+    });
+
+    usize offset = 0;
+    bool isTrivialPass = false;
+    for(usize bucket = 0; bucket < k_NumBuckets; bucket++)
+    {
+      usize bucketCount = 0;
+      for(Histogram& histogram : histograms)
+      {
+        const usize count = histogram[bucket];
+        histogram[bucket] = offset;
+        offset += count;
+        bucketCount += count;
+      }
+      if(bucketCount == size)
+      {
+        isTrivialPass = true;
+        break;
+      }
+    }
+    if(isTrivialPass)
+    {
+      continue;
+    }
+
+    ForEachBlock(size, numBlocks, [&histograms, sourceKeys, destinationKeys, sourceIndices, destinationIndices, shift](usize block, usize begin, usize end) {
+      Histogram& offsets = histograms[block];
+      for(usize i = begin; i < end; i++)
+      {
+        const KeyT key = sourceKeys[i];
+        const usize position = offsets[(key >> shift) & (k_NumBuckets - 1)]++;
+        destinationKeys[position] = key;
+        if(destinationIndices != nullptr)
+        {
+          destinationIndices[position] = sourceIndices[i];
+        }
+      }
+    });
+    std::swap(sourceKeys, destinationKeys);
+    std::swap(sourceIndices, destinationIndices);
+  }
+
+  if(sourceKeys != keys)
+  {
+    std::memcpy(keys, sourceKeys, size * sizeof(KeyT));
+    if(indices != nullptr)
+    {
+      std::memcpy(indices, sourceIndices, size * sizeof(uint64));
+    }
+  }
+}
+
+template <class T>
+void SortImpl(T* data, usize size)
+{
+  using KeyT = KeyType<T>;
+  if constexpr(std::is_same_v<T, KeyT>)
+  {
+    if(size < k_RadixSortThreshold)
+    {
+      std::sort(data, data + size);
+      return;
+    }
+    RadixSort(data, nullptr, size);
+  }
+  else
+  {
+    DataVector<KeyT> keys(size, InitializationMode::Uninitialized);
+    KeyT* keyData = keys.data();
+    ForEachBlock(size, (size + k_BlockSize - 1) / k_BlockSize, [data, keyData](usize, usize begin, usize end) {
+      for(usize i = begin; i < end; i++)
+      {
+        keyData[i] = ToKey(data[i]);
+      }
+    });
+    if(size < k_RadixSortThreshold)
+    {
+      std::sort(keyData, keyData + size);
+    }
+    else
+    {
+      RadixSort(keyData, nullptr, size);
+    }
+    ForEachBlock(size, (size + k_BlockSize - 1) / k_BlockSize, [data, keyData](usize, usize begin, usize end) {
+      for(usize i = begin; i < end; i++)
+      {
+        data[i] = FromKey<T>(keyData[i]);
+      }
+    });
+  }
+}
+
+template <class T>
+void ArgSortImpl(const T* data, usize size, uint64* indices)
+{
+  using KeyT = KeyType<T>;
+  DataVector<KeyT> keys(size, InitializationMode::Uninitialized);
+  KeyT* keyData = keys.data();
+  ForEachBlock(size, (size + k_BlockSize - 1) / k_BlockSize, [data, keyData, indices](usize, usize begin, usize end) {
+    for(usize i = begin; i < end; i++)
+    {
+      keyData[i] = ToKey(data[i]);
+      indices[i] = i;
+    }
+  });
+  if(size < k_RadixSortThreshold)
+  {
+    std::stable_sort(indices, indices + size, [keyData](uint64 lhs, uint64 rhs) { return keyData[lhs] < keyData[rhs]; });
+    return;
+  }
+  RadixSort(keyData, indices, size);
+}
+} // namespace
+
+void Sort(int8* data, usize size)
+{
+  SortImpl(data, size);
+}
+
+void Sort(uint8* data, usize size)
+{
+  SortImpl(data, size);
+}
+
+void Sort(int16* data, usize size)
+{
+  SortImpl(data, size);
+}
+
+void Sort(uint16* data, usize size)
+{
+  SortImpl(data, size);
+}
+
+void Sort(int32* data, usize size)
+{
+  SortImpl(data, size);
+}
+
+void Sort(uint32* data, usize size)
+{
+  SortImpl(data, size);
+}
+
+void Sort(int64* data, usize size)
+{
+  SortImpl(data, size);
+}
+
+void Sort(uint64* data, usize size)
+{
+  SortImpl(data, size);
+}
+
+void Sort(float32* data, usize size)
+{
+  SortImpl(data, size);
+}
+
+void Sort(float64* data, usize size)
+{
+  SortImpl(data, size);
+}
+
+void Sort(bool* data, usize size)
+{
+  // Only two values so counting is all that is needed
+  const auto numTrue = static_cast<usize>(std::count(data, data + size, true));
+  std::fill(data, data + size - numTrue, false);
+  std::fill(data + size - numTrue, data + size, true);
+}
+
+void ArgSort(const int8* data, usize size, uint64* indices)
+{
+  ArgSortImpl(data, size, indices);
+}
+
+void ArgSort(const uint8* data, usize size, uint64* indices)
+{
+  ArgSortImpl(data, size, indices);
+}
+
+void ArgSort(const int16* data, usize size, uint64* indices)
+{
+  ArgSortImpl(data, size, indices);
+}
+
+void ArgSort(const uint16* data, usize size, uint64* indices)
+{
+  ArgSortImpl(data, size, indices);
+}
+
+void ArgSort(const int32* data, usize size, uint64* indices)
+{
+  ArgSortImpl(data, size, indices);
+}
+
+void ArgSort(const uint32* data, usize size, uint64* indices)
+{
+  ArgSortImpl(data, size, indices);
+}
+
+void ArgSort(const int64* data, usize size, uint64* indices)
+{
+  ArgSortImpl(data, size, indices);
+}
+
+void ArgSort(const uint64* data, usize size, uint64* indices)
+{
+  ArgSortImpl(data, size, indices);
+}
+
+void ArgSort(const float32* data, usize size, uint64* indices)
+{
+  ArgSortImpl(data, size, indices);
+}
+
+void ArgSort(const float64* data, usize size, uint64* indices)
+{
+  ArgSortImpl(data, size, indices);
+}
+
+void ArgSort(const bool* data, usize size, uint64* indices)
+{
+  ArgSortImpl(data, size, indices);
+}
+} // namespace NX::Common::detail
@@ -0,0 +1,334 @@
+#pragma once
+
+#include "NX/Common/DataTypeDispatch.hpp"
+#include "NX/Common/DataVector.hpp"
+#include "NX/Common/NXCommon_export.hpp"
+#include "NX/Common/Types.hpp"
+
+#include "nonstd/span.hpp"
+
+#ifdef NXCOMMON_ENABLE_MULTICORE
+#include <tbb/parallel_invoke.h>
+#elif defined(NXCOMMON_ENABLE_THREAD_POOL)
+#include "NX/Common/ThreadPool.hpp"
+#endif
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace NX::Common
+{
+/**
+ * @brief Sorted distinct values and the number of times each occurs.
+ */
+template <class T>
+struct UniqueCounts
+{
+  DataVector<T> values;
+  DataVector<uint64> counts;
+};
+
+namespace detail
+{
+/**
+ * @brief Sorts [data, data + size) in ascending order with a parallel LSD radix sort.
+ * Floating point values are ordered by their bits so -0.0 precedes 0.0 and NaNs are placed before
+ * negative infinity or after positive infinity depending on their sign bit.
+ * @param data
+ * @param size
+ */
+NXCOMMON_EXPORT void Sort(int8* data, usize size);
+NXCOMMON_EXPORT void Sort(uint8* data, usize size);
+NXCOMMON_EXPORT void Sort(int16* data, usize size);
+NXCOMMON_EXPORT void Sort(uint16* data, usize size);
+NXCOMMON_EXPORT void Sort(int32* data, usize size);
+NXCOMMON_EXPORT void Sort(uint32* data, usize size);
+NXCOMMON_EXPORT void Sort(int64* data, usize size);
+NXCOMMON_EXPORT void Sort(uint64* data, usize size);
+NXCOMMON_EXPORT void Sort(float32* data, usize size);
+NXCOMMON_EXPORT void Sort(float64* data, usize size);
+NXCOMMON_EXPORT void Sort(bool* data, usize size);
+
+/**
+ * @brief Writes the permutation that stably sorts [data, data + size) to [indices, indices + size)
+ * using the same ordering as Sort.
+ * @param data
+ * @param size
+ * @param indices
+ */
+NXCOMMON_EXPORT void ArgSort(const int8* data, usize size, uint64* indices);
+NXCOMMON_EXPORT void ArgSort(const uint8* data, usize size, uint64* indices);
+NXCOMMON_EXPORT void ArgSort(const int16* data, usize size, uint64* indices);
+NXCOMMON_EXPORT void ArgSort(const uint16* data, usize size, uint64* indices);
+NXCOMMON_EXPORT void ArgSort(const int32* data, usize size, uint64* indices);
+NXCOMMON_EXPORT void ArgSort(const uint32* data, usize size, uint64* indices);
+NXCOMMON_EXPORT void ArgSort(const int64* data, usize size, uint64* indices);
+NXCOMMON_EXPORT void ArgSort(const uint64* data, usize size, uint64* indices);
+NXCOMMON_EXPORT void ArgSort(const float32* data, usize size, uint64* indices);
+NXCOMMON_EXPORT void ArgSort(const float64* data, usize size, uint64* indices);
+NXCOMMON_EXPORT void ArgSort(const bool* data, usize size, uint64* indices);
+
+template <class T, class TypeList>
+struct IsInTypeList;
+
+template <class T, class... Ts>
+struct IsInTypeList<T, std::tuple<Ts...>> : std::disjunction<std::is_same<T, Ts>...>
+{
+};
+
+/**
+ * @brief True for the types that have a radix sort overload above. Other arithmetic types, such as char, long long
+ * where int64 is long, or long double, use the merge sort.
+ */
+template <class T>
+inline constexpr bool k_IsRadixSortable = IsInTypeList<T, DataTypeList>::value;
+
+/**
+ * @brief Ranges shorter than this are sorted or merged serially by the merge sort.
+ */
+inline constexpr usize k_MergeSortGrain = 1ull << 13;
+
+template <class Func1, class Func2>
+void ParallelInvoke(Func1&& func1, Func2&& func2)
+{
+#ifdef NXCOMMON_ENABLE_MULTICORE
+  tbb::parallel_invoke(std::forward<Func1>(func1), std::forward<Func2>(func2));
+#elif defined(NXCOMMON_ENABLE_THREAD_POOL)
+  TaskGroup group(ThreadPool::Global());
+  group.run([&func1]() { func1(); });
+  func2();
+  group.wait();
+#else
+  func1();
+  func2();
+#endif
+}
+
+/**
+ * @brief Stably merges the sorted ranges [first1, last1) and [first2, last2) into output by moving elements.
+ * Large merges are split around the median of the longer range and the two halves are merged in parallel.
+ */
+template <class T, class Compare>
+void ParallelMerge(T* first1, T* last1, T* first2, T* last2, T* output, Compare comp)
+{
+  const auto size1 = static_cast<usize>(last1 - first1);
+  const auto size2 = static_cast<usize>(last2 - first2);
+  if(size1 + size2 <= k_MergeSortGrain)
+  {
+    std::merge(std::make_move_iterator(first1), std::make_move_iterator(last1), std::make_move_iterator(first2), std::make_move_iterator(last2), output, comp);
+    return;
+  }
+
+  // Equal elements from the first range must stay in front of those from the second
+  T* middle1 = nullptr;
+  T* middle2 = nullptr;
+  if(size1 >= size2)
+  {
+    middle1 = first1 + size1 / 2;
+    middle2 = std::lower_bound(first2, last2, *middle1, comp);
+  }
+  else
+  {
+    middle2 = first2 + size2 / 2;
+    middle1 = std::upper_bound(first1, last1, *middle2, comp);
+  }
+  T* outputMiddle = output + (middle1 - first1) + (middle2 - first2);
+  ParallelInvoke([=]() { ParallelMerge(first1, middle1, first2, middle2, output, comp); }, [=]() { ParallelMerge(middle1, last1, middle2, last2, outputMiddle, comp); });
+}
+
+/**
+ * @brief Stably sorts [data, data + size). The result is left in buffer if resultInBuffer is true, otherwise in data.
+ * The halves are sorted in parallel into the opposite array so each level merges without copying back.
+ */
+template <class T, class Compare>
+void ParallelMergeSort(T* data, T* buffer, usize size, bool resultInBuffer, Compare comp)
+{
+  if(size <= k_MergeSortGrain)
+  {
+    std::stable_sort(data, data + size, comp);
+    if(resultInBuffer)
+    {
+      std::move(data, data + size, buffer);
+    }
+    return;
+  }
+
+  const usize middle = size / 2;
+  ParallelInvoke([=]() { ParallelMergeSort(data, buffer, middle, !resultInBuffer, comp); },
+                 [=]() { ParallelMergeSort(data + middle, buffer + middle, size - middle, !resultInBuffer, comp); });
+  if(resultInBuffer)
+  {
+    ParallelMerge(data, data + middle, data + middle, data + size, buffer, comp);
+  }
+  else
+  {
+    ParallelMerge(buffer, buffer + middle, buffer + middle, buffer + size, data, comp);
+  }
+}
+
+template <class T>
+bool IsSameValue(const T& lhs, const T& rhs)
+{
+  if constexpr(std::is_floating_point_v<T>)
+  {
+    // NaNs compare unequal to themselves but are grouped into a single entry
+    return lhs == rhs || (lhs != lhs && rhs != rhs);
+  }
+  else
+  {
+    return lhs == rhs;
+  }
+}
+} // namespace detail
+
+/**
+ * @brief Stably sorts values with comp using a parallel merge sort. T must be default constructible and movable.
+ * @param values
+ * @param comp
+ */
+template <class T, class Compare>
+void Sort(nonstd::span<T> values, Compare comp)
+{
+  if(values.size() <= detail::k_MergeSortGrain)
+  {
+    std::stable_sort(values.begin(), values.end(), comp);
+    return;
+  }
+  auto buffer = std::make_unique<T[]>(values.size());
+  detail::ParallelMergeSort(values.data(), buffer.get(), values.size(), false, comp);
+}
+
+/**
+ * @brief Sorts values in ascending order. The types of DataTypeList use a parallel radix sort and other types a parallel
+ * merge sort.
+ * Floating point values are ordered by their bits so -0.0 precedes 0.0 and NaNs are placed at the ends.
+ * @param values
+ */
+template <class T>
+void Sort(nonstd::span<T> values)
+{
+  if constexpr(detail::k_IsRadixSortable<T>)
+  {
+    detail::Sort(values.data(), values.size());
+  }
+  else
+  {
+    Sort(values, std::less<>{});
+  }
+}
+
+/**
+ * @brief Sorts values in ascending order. See Sort(nonstd::span<T>). Shared copy-on-write storage is made unique first.
+ * @param values
+ */
+template <class T>
+void Sort(DataVector<T>& values)
+{
+  values.makeUnique();
+  Sort(values.createSpan());
+}
+
+/**
+ * @brief Returns the permutation that stably sorts values with comp, i.e. values[indices[0]] is the first sorted value.
+ * @param values
+ * @param comp
+ * @return DataVector<uint64>
+ */
+template <class T, class Compare>
+DataVector<uint64> ArgSort(nonstd::span<T> values, Compare comp)
+{
+  DataVector<uint64> indices(values.size(), InitializationMode::Uninitialized);
+  std::iota(indices.begin(), indices.end(), uint64{0});
+  const std::remove_cv_t<T>* data = values.data();
+  Sort(indices.createSpan(), [data, comp](uint64 lhs, uint64 rhs) { return comp(data[lhs], data[rhs]); });
+  return indices;
+}
+
+/**
+ * @brief Returns the permutation that stably sorts values in ascending order. The types of DataTypeList use a parallel
+ * radix sort of (value, index) pairs and other types a parallel merge sort.
+ * @param values
+ * @return DataVector<uint64>
+ */
+template <class T>
+DataVector<uint64> ArgSort(nonstd::span<T> values)
+{
+  if constexpr(detail::k_IsRadixSortable<std::remove_cv_t<T>>)
+  {
+    DataVector<uint64> indices(values.size(), InitializationMode::Uninitialized);
+    detail::ArgSort(values.data(), values.size(), indices.data());
+    return indices;
+  }
+  else
+  {
+    return ArgSort(values, std::less<>{});
+  }
+}
+
+/**
+ * @brief Returns the permutation that stably sorts values in ascending order. See ArgSort(nonstd::span<T>).
+ * @param values
+ * @return DataVector<uint64>
+ */
+template <class T>
+DataVector<uint64> ArgSort(const DataVector<T>& values)
+{
+  return ArgSort(values.createSpan());
+}
+
+/**
+ * @brief Returns the distinct values in ascending order along with how many times each occurs. NaNs are counted as a
+ * single value per sign.
+ * @param values
+ * @return UniqueCounts<T>
+ */
+template <class T>
+UniqueCounts<std::remove_cv_t<T>> UniqueWithCounts(nonstd::span<T> values)
+{
+  using ValueT = std::remove_cv_t<T>;
+  DataVector<ValueT> sorted(values.size(), InitializationMode::Uninitialized);
+  std::copy(values.begin(), values.end(), sorted.begin());
+  Sort(sorted.createSpan());
+
+  usize numUnique = 0;
+  for(usize i = 0; i < sorted.size(); i++)
+  {
+    if(i == 0 || !detail::IsSameValue(sorted[i], sorted[i - 1]))
+    {
+      numUnique++;
+    }
+  }
+
+  UniqueCounts<ValueT> result = {DataVector<ValueT>(numUnique), DataVector<uint64>(numUnique)};
+  usize unique = 0;
+  for(usize i = 0; i < sorted.size(); i++)
+  {
+    if(i == 0 || !detail::IsSameValue(sorted[i], sorted[i - 1]))
+    {
+      result.values[unique] = sorted[i];
+      result.counts[unique] = 0;
+      unique++;
+    }
+    result.counts[unique - 1]++;
+  }
+  return result;
+}
+
+/**
+ * @brief Returns the distinct values in ascending order along with how many times each occurs.
+ * See UniqueWithCounts(nonstd::span<T>).
+ * @param values
+ * @return UniqueCounts<T>
+ */
+template <class T>
+UniqueCounts<T> UniqueWithCounts(const DataVector<T>& values)
+{
+  return UniqueWithCounts(values.createSpan());
+}
+} // namespace NX::Common
@@ -0,0 +1,386 @@
+#include "NX/Common/SpaceFillingCurve.hpp"
+
+#include "NX/Common/CpuFeatures.hpp"
+
+#include <fmt/format.h>
+
+#if defined(NXCOMMON_ARCH_X86) && (defined(__x86_64__) || defined(_M_X64))
+#define NXCOMMON_HAS_PDEP
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace NX::Common
+{
+namespace
+{
+/**
+ * @brief Bits of a Morton key that hold x. y and z are shifted up by one and two.
+ */
+constexpr uint64 k_MortonMask = 0x1249249249249249ull;
+
+constexpr uint32 k_ByteMask = 0xFF;
+constexpr uint32 k_NineBitMask = 0x1FF;
+
+/**
+ * @brief Maps each byte to the same bits spread three apart.
+ */
+constexpr std::array<uint32, 256> MakeSpreadTable()
+{
+  std::array<uint32, 256> table = {};
+  for(uint32 value = 0; value < 256; value++)
+  {
+    uint32 spread = 0;
+    for(uint32 bit = 0; bit < 8; bit++)
+    {
+      spread |= ((value >> bit) & 1u) << (3 * bit);
+    }
+    table[value] = spread;
+  }
+  return table;
+}
+
+/**
+ * @brief Maps nine bits of a Morton key to the three bits each of x, y and z they hold, packed as x | y << 3 | z << 6.
+ */
+constexpr std::array<uint16, 512> MakeCompactTable()
+{
+  std::array<uint16, 512> table = {};
+  for(uint32 value = 0; value < 512; value++)
+  {
+    uint32 compact = 0;
+    for(uint32 bit = 0; bit < 9; bit++)
+    {
+      compact |= ((value >> bit) & 1u) << ((bit % 3) * 3 + bit / 3);
+    }
+    table[value] = static_cast<uint16>(compact);
+  }
+  return table;
+}
+
+constexpr std::array<uint32, 256> k_SpreadTable = MakeSpreadTable();
+constexpr std::array<uint16, 512> k_CompactTable = MakeCompactTable();
+
+uint64 Spread21(uint32 value)
+{
+  return static_cast<uint64>(k_SpreadTable[value & k_ByteMask]) | (static_cast<uint64>(k_SpreadTable[(value >> 8) & k_ByteMask]) << 24) |
+         (static_cast<uint64>(k_SpreadTable[(value >> 16) & 0x1F]) << 48);
+}
+
+uint64 MortonEncodeTable(uint32 x, uint32 y, uint32 z)
+{
+  return Spread21(x) | (Spread21(y) << 1) | (Spread21(z) << 2);
+}
+
+std::array<uint32, 3> MortonDecodeTable(uint64 key)
+{
+  std::array<uint32, 3> coords = {0, 0, 0};
+  for(uint32 chunk = 0; chunk < 7; chunk++)
+  {
+    const uint32 compact = k_CompactTable[(key >> (9 * chunk)) & k_NineBitMask];
+    coords[0] |= (compact & 7u) << (3 * chunk);
+    coords[1] |= ((compact >> 3) & 7u) << (3 * chunk);
+    coords[2] |= ((compact >> 6) & 7u) << (3 * chunk);
+  }
+  return coords;
+}
+
+#ifdef NXCOMMON_HAS_PDEP
+NXCOMMON_TARGET("bmi2") uint64 MortonEncodeBmi2(uint32 x, uint32 y, uint32 z)
+{
+  return _pdep_u64(x, k_MortonMask) | _pdep_u64(y, k_MortonMask << 1) | _pdep_u64(z, k_MortonMask << 2);
+}
+
+NXCOMMON_TARGET("bmi2") std::array<uint32, 3> MortonDecodeBmi2(uint64 key)
+{
+  return {static_cast<uint32>(_pext_u64(key, k_MortonMask)), static_cast<uint32>(_pext_u64(key, k_MortonMask << 1)), static_cast<uint32>(_pext_u64(key, k_MortonMask << 2))};
+}
+#endif
+
+struct MortonKernels
+{
+  uint64 (*encode)(uint32, uint32, uint32) = MortonEncodeTable;
+  std::array<uint32, 3> (*decode)(uint64) = MortonDecodeTable;
+};
+
+MortonKernels SelectKernels()
+{
+  MortonKernels kernels;
+#ifdef NXCOMMON_HAS_PDEP
+  if(GetCpuFeatures().bmi2)
+  {
+    kernels.encode = MortonEncodeBmi2;
+    kernels.decode = MortonDecodeBmi2;
+  }
+#endif
+  return kernels;
+}
+
+const MortonKernels& GetKernels()
+{
+  static const MortonKernels kernels = SelectKernels();
+  return kernels;
+}
+
+uint32 ClampBits(uint32 numBits)
+{
+  return std::clamp<uint32>(numBits, 1, k_MaxCurveBits);
+}
+
+/**
+ * @brief Returns the number of bits needed to hold every offset in [0, extent).
+ */
+uint32 BitsForExtent(usize extent)
+{
+  uint32 numBits = 1;
+  while(numBits < k_MaxCurveBits && (usize{1} << numBits) < extent)
+  {
+    numBits++;
+  }
+  return numBits;
+}
+
+/**
+ * @brief Returns the extents of range after checking that it lies within dims and fits in a curve key.
+ */
+std::array<usize, 3> CurveExtents(const Range3D& range, const std::array<usize, 3>& dims, const char* functionName)
+{
+  std::array<usize, 3> extents = {};
+  for(usize i = 0; i < 3; i++)
+  {
+    if(range[2 * i] > range[2 * i + 1] || range[2 * i + 1] > dims[i])
+    {
+      throw std::runtime_error(fmt::format("{}: range [{}, {}) along axis {} does not lie within the grid size {}", functionName, range[2 * i], range[2 * i + 1], i, dims[i]));
+    }
+    extents[i] = range[2 * i + 1] - range[2 * i];
+    if(extents[i] > usize{k_MaxCurveCoordinate} + 1)
+    {
+      throw std::runtime_error(fmt::format("{}: extent {} along axis {} exceeds the {} voxels a curve key can hold", functionName, extents[i], i, usize{k_MaxCurveCoordinate} + 1));
+    }
+  }
+  return extents;
+}
+
+/**
+ * @brief Visits the octants of the cube [origin, origin + 2^sizeBits) that overlap the range in curve order, down to
+ * cubes of 2^leafBits voxels. Aligned cubes occupy a contiguous stretch of both curves, so the children of an octant
+ * are visited in the order of the keys of their corners.
+ */
+struct OctantTraversal
+{
+  Range3D::RangeType bounds;
+  std::array<usize, 3> extents;
+  SpaceFillingCurve curve;
+  uint32 numBits;
+  uint32 leafBits;
+  const std::function<void(const Range3D&)>& body;
+
+  void visit(const std::array<uint32, 3>& origin, uint32 sizeBits) const
+  {
+    std::array<usize, 3> end = {};
+    for(usize i = 0; i < 3; i++)
+    {
+      if(origin[i] >= extents[i])
+      {
+        return;
+      }
+      end[i] = std::min<usize>(usize{origin[i]} + (usize{1} << sizeBits), extents[i]);
+    }
+    if(sizeBits <= leafBits)
+    {
+      body(Range3D(bounds[0] + origin[0], bounds[0] + end[0], bounds[2] + origin[1], bounds[2] + end[1], bounds[4] + origin[2], bounds[4] + end[2]));
+      return;
+    }
+
+    const uint32 childBits = sizeBits - 1;
+    std::array<std::pair<uint64, std::array<uint32, 3>>, 8> children = {};
+    for(uint32 child = 0; child < 8; child++)
+    {
+      const std::array<uint32, 3> childOrigin = {origin[0] + ((child & 1) << childBits), origin[1] + (((child >> 1) & 1) << childBits), origin[2] + (((child >> 2) & 1) << childBits)};
+      children[child] = {CurveEncode3D(curve, childOrigin[0], childOrigin[1], childOrigin[2], numBits), childOrigin};
+    }
+    std::sort(children.begin(), children.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+    for(const auto& child : children)
+    {
+      visit(child.second, childBits);
+    }
+  }
+};
+
+/*
+ * The Hilbert curve uses J. Skilling, "Programming the Hilbert curve", AIP Conference Proceedings 707, 2004.
+ * The key is held "transposed" across the three coordinates, bit b of coords[0], coords[1] and coords[2] being bits
+ * 3b + 2, 3b + 1 and 3b of the key, which lets the curve be built with a few exchanges and inversions per level.
+ */
+void AxesToTranspose(std::array<uint32, 3>& coords, uint32 numBits)
+{
+  const uint32 highBit = 1u << (numBits - 1);
+  // Undo the rotations and reflections of each level, coarsest first
+  for(uint32 bit = highBit; bit > 1; bit >>= 1)
+  {
+    const uint32 lowerBits = bit - 1;
+    for(usize i = 0; i < 3; i++)
+    {
+      if((coords[i] & bit) != 0)
+      {
+        coords[0] ^= lowerBits;
+      }
+      else
+      {
+        const uint32 swap = (coords[0] ^ coords[i]) & lowerBits;
+        coords[0] ^= swap;
+        coords[i] ^= swap;
+      }
+    }
+  }
+  // Gray encode
+  coords[1] ^= coords[0];
+  coords[2] ^= coords[1];
+  uint32 flip = 0;
+  for(uint32 bit = highBit; bit > 1; bit >>= 1)
+  {
+    if((coords[2] & bit) != 0)
+    {
+      flip ^= bit - 1;
+    }
+  }
+  for(uint32& coord : coords)
+  {
+    coord ^= flip;
+  }
+}
+
+void TransposeToAxes(std::array<uint32, 3>& coords, uint32 numBits)
+{
+  // Gray decode
+  const uint32 flip = coords[2] >> 1;
+  coords[2] ^= coords[1];
+  coords[1] ^= coords[0];
+  coords[0] ^= flip;
+  // Redo the rotations and reflections of each level, finest first
+  const uint32 endBit = 1u << numBits;
+  for(uint32 bit = 2; bit != endBit; bit <<= 1)
+  {
+    const uint32 lowerBits = bit - 1;
+    for(usize i = 3; i-- > 0;)
+    {
+      if((coords[i] & bit) != 0)
+      {
+        coords[0] ^= lowerBits;
+      }
+      else
+      {
+        const uint32 swap = (coords[0] ^ coords[i]) & lowerBits;
+        coords[0] ^= swap;
+        coords[i] ^= swap;
+      }
+    }
+  }
+}
+} // namespace
+
+uint64 MortonEncode3D(uint32 x, uint32 y, uint32 z)
+{
+  return GetKernels().encode(x, y, z);
+}
+
+std::array<uint32, 3> MortonDecode3D(uint64 key)
+{
+  return GetKernels().decode(key);
+}
+
+uint64 HilbertEncode3D(uint32 x, uint32 y, uint32 z, uint32 numBits)
+{
+  numBits = ClampBits(numBits);
+  const uint32 mask = (1u << numBits) - 1;
+  std::array<uint32, 3> coords = {x & mask, y & mask, z & mask};
+  AxesToTranspose(coords, numBits);
+  return MortonEncode3D(coords[2], coords[1], coords[0]);
+}
+
+std::array<uint32, 3> HilbertDecode3D(uint64 key, uint32 numBits)
+{
+  numBits = ClampBits(numBits);
+  const std::array<uint32, 3> transposed = MortonDecode3D(key & ((uint64{1} << (3 * numBits)) - 1));
+  std::array<uint32, 3> coords = {transposed[2], transposed[1], transposed[0]};
+  TransposeToAxes(coords, numBits);
+  return coords;
+}
+
+uint64 CurveEncode3D(SpaceFillingCurve curve, uint32 x, uint32 y, uint32 z, uint32 numBits)
+{
+  switch(curve)
+  {
+  case SpaceFillingCurve::Hilbert:
+    return HilbertEncode3D(x, y, z, numBits);
+  case SpaceFillingCurve::Morton:
+  default:
+    return MortonEncode3D(x, y, z);
+  }
+}
+
+DataVector<uint64> CurveOrderVoxelIndices(const Range3D& range, const std::array<usize, 3>& dims, SpaceFillingCurve curve)
+{
+  const std::array<usize, 3> extents = CurveExtents(range, dims, "CurveOrderVoxelIndices");
+  const usize numVoxels = extents[0] * extents[1] * extents[2];
+  if(numVoxels == 0)
+  {
+    return DataVector<uint64>(0);
+  }
+  const uint32 numBits = BitsForExtent(std::max({extents[0], extents[1], extents[2]}));
+  const Range3D::RangeType bounds = range.getRange();
+
+  // Keys are stored at the position of their voxel within the range in row major order
+  DataVector<uint64> keys(numVoxels, InitializationMode::Uninitialized);
+  ParallelData3DAlgorithm keyAlgorithm(range);
+  keyAlgorithm.execute([keyData = keys.data(), &bounds, &extents, numBits, curve](const Range3D& subRange) {
+    const Range3D::RangeType block = subRange.getRange();
+    for(usize z = block[4]; z < block[5]; z++)
+    {
+      for(usize y = block[2]; y < block[3]; y++)
+      {
+        const usize rowOffset = ((z - bounds[4]) * extents[1] + (y - bounds[2])) * extents[0];
+        for(usize x = block[0]; x < block[1]; x++)
+        {
+          keyData[rowOffset + (x - bounds[0])] = CurveEncode3D(curve, static_cast<uint32>(x - bounds[0]), static_cast<uint32>(y - bounds[2]), static_cast<uint32>(z - bounds[4]), numBits);
+        }
+      }
+    }
+  });
+
+  DataVector<uint64> indices = ArgSort(keys);
+  ParallelDataAlgorithm indexAlgorithm(Range(0, numVoxels));
+  indexAlgorithm.execute([indexData = indices.data(), &bounds, &extents, &dims](const Range& block) {
+    for(usize i = block.min(); i < block.max(); i++)
+    {
+      const usize position = indexData[i];
+      const usize x = bounds[0] + position % extents[0];
+      const usize y = bounds[2] + (position / extents[0]) % extents[1];
+      const usize z = bounds[4] + position / (extents[0] * extents[1]);
+      indexData[i] = (z * dims[1] + y) * dims[0] + x;
+    }
+  });
+  return indices;
+}
+
+void ForEachBlockInCurveOrder(const Range3D& range, const std::array<usize, 3>& dims, SpaceFillingCurve curve, usize blockExtent, const std::function<void(const Range3D&)>& body)
+{
+  const std::array<usize, 3> extents = CurveExtents(range, dims, "ForEachBlockInCurveOrder");
+  if(extents[0] == 0 || extents[1] == 0 || extents[2] == 0)
+  {
+    return;
+  }
+  const uint32 numBits = BitsForExtent(std::max({extents[0], extents[1], extents[2]}));
+  // Leaves are the largest power of two cubes that fit in blockExtent
+  uint32 leafBits = 0;
+  while(leafBits < numBits && (usize{2} << leafBits) <= blockExtent)
+  {
+    leafBits++;
+  }
+  const OctantTraversal traversal{range.getRange(), extents, curve, numBits, leafBits, body};
+  traversal.visit({0, 0, 0}, numBits);
+}
+} // namespace NX::Common
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "NX/Common/DataVector.hpp"
+#include "NX/Common/NXCommon_export.hpp"
+#include "NX/Common/ParallelDataAlgorithm.hpp"
+#include "NX/Common/Point3D.hpp"
+#include "NX/Common/Range3D.hpp"
+#include "NX/Common/Sort.hpp"
+#include "NX/Common/Types.hpp"
+
+#include "nonstd/span.hpp"
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+namespace NX::Common
+{
+/**
+ * @brief Number of bits per axis that fit in a 64 bit 3D curve key.
+ */
+inline constexpr uint32 k_MaxCurveBits = 21;
+
+/**
+ * @brief Largest coordinate that can be encoded in a 64 bit 3D curve key.
+ */
+inline constexpr uint32 k_MaxCurveCoordinate = (1u << k_MaxCurveBits) - 1;
+
+/**
+ * @brief Space filling curves that 3D grids and point sets can be ordered along. Both keep cells that are close in
+ * space close in the order. The Hilbert curve only ever steps to a face neighbor, so it has better locality than the
+ * Morton (Z order) curve, whose keys are cheaper to compute.
+ */
+enum class SpaceFillingCurve : uint8
+{
+  Morton,
+  Hilbert
+};
+
+/**
+ * @brief Interleaves the low 21 bits of x, y and z into a Morton key, x in the lowest bit. Uses BMI2 pdep when the
+ * processor supports it and lookup tables otherwise.
+ * @param x
+ * @param y
+ * @param z
+ * @return uint64
+ */
+NXCOMMON_EXPORT uint64 MortonEncode3D(uint32 x, uint32 y, uint32 z);
+
+/**
+ * @brief Inverse of MortonEncode3D. Uses BMI2 pext when the processor supports it and lookup tables otherwise.
+ * @param key
+ * @return std::array<uint32, 3> as {x, y, z}
+ */
+NXCOMMON_EXPORT std::array<uint32, 3> MortonDecode3D(uint64 key);
+
+/**
+ * @brief Returns the position of (x, y, z) along the 3D Hilbert curve that fills the cube [0, 2^numBits)^3, which
+ * starts at the origin. numBits is clamped to [1, k_MaxCurveBits] and only its low numBits bits are read from each
+ * coordinate. The cost is linear in numBits, so small grids should pass the number of bits their extents need.
+ * @param x
+ * @param y
+ * @param z
+ * @param numBits
+ * @return uint64
+ */
+NXCOMMON_EXPORT uint64 HilbertEncode3D(uint32 x, uint32 y, uint32 z, uint32 numBits = k_MaxCurveBits);
+
+/**
+ * @brief Inverse of HilbertEncode3D for the same numBits.
+ * @param key
+ * @param numBits
+ * @return std::array<uint32, 3> as {x, y, z}
+ */
+NXCOMMON_EXPORT std::array<uint32, 3> HilbertDecode3D(uint64 key, uint32 numBits = k_MaxCurveBits);
+
+/**
+ * @brief Returns the key of (x, y, z) along curve. See MortonEncode3D and HilbertEncode3D.
+ * @param curve
+ * @param x
+ * @param y
+ * @param z
+ * @param numBits Only used by the Hilbert curve
+ * @return uint64
+ */
+NXCOMMON_EXPORT uint64 CurveEncode3D(SpaceFillingCurve curve, uint32 x, uint32 y, uint32 z, uint32 numBits = k_MaxCurveBits);
+
+/**
+ * @brief Returns the linear indices x + y * dims[0] + z * dims[0] * dims[1] of the voxels of range in the order curve
+ * visits them, so that a sweep over the returned indices touches neighboring voxels close together in time.
+ * The ordering is computed once with a parallel radix sort of the curve keys and can be reused for every sweep.
+ * Computing it needs about 40 bytes per voxel at its peak, for the keys, the returned indices and the sort's scratch
+ * buffers, and the result keeps 8 bytes per voxel. ForEachBlockInCurveOrder visits the same order without storage.
+ * Throws std::runtime_error if range does not lie within dims or is wider than 2^21 voxels along an axis.
+ * @param range
+ * @param dims Grid size as {x, y, z}
+ * @param curve
+ * @return DataVector<uint64>
+ */
+NXCOMMON_EXPORT DataVector<uint64> CurveOrderVoxelIndices(const Range3D& range, const std::array<usize, 3>& dims, SpaceFillingCurve curve);
+
+/**
+ * @brief Calls body(block) on the calling thread for blocks that together cover range, in the order curve visits
+ * them. Blocks are the parts within range of aligned cubes whose side is the largest power of two not above
+ * blockExtent, so with a blockExtent of 1 the blocks are single voxels in the order of CurveOrderVoxelIndices.
+ * The octants are subdivided recursively as they are visited, so no memory is needed beyond the recursion itself.
+ * Throws std::runtime_error if range does not lie within dims or is wider than 2^21 voxels along an axis.
+ * @param range
+ * @param dims Grid size as {x, y, z}
+ * @param curve
+ * @param blockExtent
+ * @param body
+ */
+NXCOMMON_EXPORT void ForEachBlockInCurveOrder(const Range3D& range, const std::array<usize, 3>& dims, SpaceFillingCurve curve, usize blockExtent,
+                                              const std::function<void(const Range3D&)>& body);
+
+/**
+ * @brief Returns the permutation that orders points along curve, i.e. points[indices[0]] is the first point on the
+ * curve. Points are quantized to a 2^21 grid over their bounding box with the same cell size along every axis, and
+ * points in the same cell keep their relative order. Gathering arrays of per point data through the permutation makes
+ * neighbor searches and other spatially coherent algorithms access memory in order. Points must be finite.
+ * @param points
+ * @param curve
+ * @return DataVector<uint64>
+ */
+template <class T>
+DataVector<uint64> CurveOrderPermutation(nonstd::span<const Point3D<T>> points, SpaceFillingCurve curve)
+{
+  static_assert(std::is_floating_point_v<T>, "CurveOrderPermutation requires floating point coordinates");
+
+  std::array<T, 3> minimum = {std::numeric_limits<T>::max(), std::numeric_limits<T>::max(), std::numeric_limits<T>::max()};
+  std::array<T, 3> maximum = {std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest(), std::numeric_limits<T>::lowest()};
+  for(const Point3D<T>& point : points)
+  {
+    for(usize i = 0; i < 3; i++)
+    {
+      minimum[i] = std::min(minimum[i], point[i]);
+      maximum[i] = std::max(maximum[i], point[i]);
+    }
+  }
+  float64 extent = 0.0;
+  for(usize i = 0; i < 3; i++)
+  {
+    extent = std::max(extent, static_cast<float64>(maximum[i]) - static_cast<float64>(minimum[i]));
+  }
+  const float64 scale = extent > 0.0 ? static_cast<float64>(k_MaxCurveCoordinate) / extent : 0.0;
+
+  DataVector<uint64> keys(points.size(), InitializationMode::Uninitialized);
+  ParallelDataAlgorithm algorithm(Range(0, points.size()));
+  algorithm.execute([pointData = points.data(), keyData = keys.data(), &minimum, scale, curve](const Range& range) {
+    for(usize i = range.min(); i < range.max(); i++)
+    {
+      std::array<uint32, 3> cell = {};
+      for(usize j = 0; j < 3; j++)
+      {
+        const float64 offset = (static_cast<float64>(pointData[i][j]) - static_cast<float64>(minimum[j])) * scale;
+        cell[j] = static_cast<uint32>(std::min(offset, static_cast<float64>(k_MaxCurveCoordinate)));
+      }
+      keyData[i] = CurveEncode3D(curve, cell[0], cell[1], cell[2]);
+    }
+  });
+  return ArgSort(keys);
+}
+} // namespace NX::Common
@@ -0,0 +1,130 @@
+#include "NX/Common/Stencil3D.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <stdexcept>
+
+namespace NX::Common
+{
+Stencil3D::Stencil3D(const std::array<usize, 3>& dims, NeighborConnectivity connectivity)
+: m_Dims(dims)
+, m_Connectivity(connectivity)
+{
+  // Face neighbors are one step away along one axis, edge neighbors along two and vertex neighbors along all three
+  int64 maxNumSteps = 1;
+  if(connectivity == NeighborConnectivity::FaceEdge)
+  {
+    maxNumSteps = 2;
+  }
+  else if(connectivity == NeighborConnectivity::FaceEdgeVertex)
+  {
+    maxNumSteps = 3;
+  }
+
+  const auto strideY = static_cast<int64>(dims[0]);
+  const auto strideZ = static_cast<int64>(dims[0] * dims[1]);
+  for(int64 dz = -1; dz <= 1; dz++)
+  {
+    for(int64 dy = -1; dy <= 1; dy++)
+    {
+      for(int64 dx = -1; dx <= 1; dx++)
+      {
+        const int64 numSteps = std::abs(dx) + std::abs(dy) + std::abs(dz);
+        if(numSteps == 0 || numSteps > maxNumSteps)
+        {
+          continue;
+        }
+        m_Directions.push_back({dx, dy, dz});
+        m_Offsets.push_back(dx + dy * strideY + dz * strideZ);
+      }
+    }
+  }
+}
+
+const std::array<usize, 3>& Stencil3D::dims() const
+{
+  return m_Dims;
+}
+
+NeighborConnectivity Stencil3D::connectivity() const
+{
+  return m_Connectivity;
+}
+
+usize Stencil3D::numNeighbors() const
+{
+  return m_Offsets.size();
+}
+
+const std::vector<int64>& Stencil3D::offsets() const
+{
+  return m_Offsets;
+}
+
+const std::vector<Stencil3D::Direction>& Stencil3D::directions() const
+{
+  return m_Directions;
+}
+
+void Stencil3D::checkRange(const Range3D& range) const
+{
+  for(usize i = 0; i < 3; i++)
+  {
+    if(range[2 * i] > range[2 * i + 1] || range[2 * i + 1] > m_Dims[i])
+    {
+      throw std::runtime_error(fmt::format("Stencil3D: range [{}, {}) along axis {} does not lie within the grid size {}", range[2 * i], range[2 * i + 1], i, m_Dims[i]));
+    }
+  }
+}
+
+Range3D Stencil3D::interior(const Range3D& range) const
+{
+  checkRange(range);
+  // Every connectivity has the face neighbors, so the interior is one voxel away from each face of the grid
+  std::array<usize, 6> bounds = {};
+  for(usize i = 0; i < 3; i++)
+  {
+    bounds[2 * i] = std::max<usize>(range[2 * i], 1);
+    bounds[2 * i + 1] = std::min<usize>(range[2 * i + 1], m_Dims[i] - 1);
+    if(bounds[2 * i] >= bounds[2 * i + 1])
+    {
+      return {range[0], range[0], range[2], range[2], range[4], range[4]};
+    }
+  }
+  return {bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5]};
+}
+
+std::vector<Range3D> Stencil3D::boundaryShells(const Range3D& range) const
+{
+  const Range3D::RangeType outer = range.getRange();
+  const Range3D::RangeType inner = interior(range).getRange();
+  std::vector<Range3D> shells;
+  if(outer[0] == outer[1] || outer[2] == outer[3] || outer[4] == outer[5])
+  {
+    return shells;
+  }
+  if(inner[0] == inner[1])
+  {
+    // Without an interior the whole range is boundary
+    shells.push_back(range);
+    return shells;
+  }
+
+  // Slabs are peeled off along z, then y, then x so that each one keeps rows as long as possible
+  const auto addShell = [&shells](usize xMin, usize xMax, usize yMin, usize yMax, usize zMin, usize zMax) {
+    if(xMin < xMax && yMin < yMax && zMin < zMax)
+    {
+      shells.emplace_back(xMin, xMax, yMin, yMax, zMin, zMax);
+    }
+  };
+  addShell(outer[0], outer[1], outer[2], outer[3], outer[4], inner[4]);
+  addShell(outer[0], outer[1], outer[2], outer[3], inner[5], outer[5]);
+  addShell(outer[0], outer[1], outer[2], inner[2], inner[4], inner[5]);
+  addShell(outer[0], outer[1], inner[3], outer[3], inner[4], inner[5]);
+  addShell(outer[0], inner[0], inner[2], inner[3], inner[4], inner[5]);
+  addShell(inner[1], outer[1], inner[2], inner[3], inner[4], inner[5]);
+  return shells;
+}
+} // namespace NX::Common
@@ -0,0 +1,229 @@
+#pragma once
+
+#include "NX/Common/NXCommon_export.hpp"
+#include "NX/Common/ParallelDataAlgorithm.hpp"
+#include "NX/Common/Range3D.hpp"
+#include "NX/Common/Types.hpp"
+
+#include <array>
+#include <vector>
+
+namespace NX::Common
+{
+/**
+ * @brief Which of the 26 voxels around a voxel count as its neighbors. The value is the number of neighbors.
+ */
+enum class NeighborConnectivity : uint8
+{
+  Face = 6,
+  FaceEdge = 18,
+  FaceEdgeVertex = 26
+};
+
+/**
+ * @class Stencil3D
+ * @brief Stencil3D iterates the voxels of a Range3D of a voxel grid together with their neighbors. Linear neighbor
+ * offsets are precomputed once, and the range is split into an interior, whose voxels have every neighbor inside the
+ * grid and are visited without any bounds checks, and up to six boundary shells that check each neighbor.
+ * Neighbors may lie outside the range as long as they are inside the grid, so partitions of a volume read their halo
+ * from the neighboring partitions.
+ *
+ * The body is called as body(index, neighbors) for every voxel, with neighbors either an InteriorNeighbors or a
+ * BoundaryNeighbors, so it is usually a generic lambda. Both have center() and forEach(func), which calls
+ * func(neighborIndex, slot) for the neighbors inside the grid, slot being the position of the neighbor in offsets().
+ */
+class NXCOMMON_EXPORT Stencil3D
+{
+public:
+  using Direction = std::array<int64, 3>;
+
+  /**
+   * @brief Neighbors of a voxel whose neighbors all lie inside the grid.
+   */
+  class InteriorNeighbors
+  {
+  public:
+    InteriorNeighbors(const Stencil3D& stencil, usize index)
+    : m_Offsets(stencil.m_Offsets.data())
+    , m_NumNeighbors(stencil.m_Offsets.size())
+    , m_Index(index)
+    {
+    }
+
+    usize center() const
+    {
+      return m_Index;
+    }
+
+    template <class Func>
+    void forEach(Func&& func) const
+    {
+      for(usize slot = 0; slot < m_NumNeighbors; slot++)
+      {
+        func(static_cast<usize>(static_cast<int64>(m_Index) + m_Offsets[slot]), slot);
+      }
+    }
+
+  private:
+    const int64* m_Offsets;
+    usize m_NumNeighbors;
+    usize m_Index;
+  };
+
+  /**
+   * @brief Neighbors of a voxel on the boundary of the grid, which skips the neighbors outside of it.
+   */
+  class BoundaryNeighbors
+  {
+  public:
+    BoundaryNeighbors(const Stencil3D& stencil, usize index, usize x, usize y, usize z)
+    : m_Stencil(stencil)
+    , m_Index(index)
+    , m_Position({x, y, z})
+    {
+    }
+
+    usize center() const
+    {
+      return m_Index;
+    }
+
+    template <class Func>
+    void forEach(Func&& func) const
+    {
+      for(usize slot = 0; slot < m_Stencil.m_Offsets.size(); slot++)
+      {
+        const Direction& direction = m_Stencil.m_Directions[slot];
+        bool inside = true;
+        for(usize i = 0; i < 3; i++)
+        {
+          // Positions before the grid wrap around to values past its end
+          inside = inside && static_cast<usize>(static_cast<int64>(m_Position[i]) + direction[i]) < m_Stencil.m_Dims[i];
+        }
+        if(inside)
+        {
+          func(static_cast<usize>(static_cast<int64>(m_Index) + m_Stencil.m_Offsets[slot]), slot);
+        }
+      }
+    }
+
+  private:
+    const Stencil3D& m_Stencil;
+    usize m_Index;
+    std::array<usize, 3> m_Position;
+  };
+
+  /**
+   * @brief Constructs the stencil of the given connectivity for a grid of size dims.
+   * @param dims Grid size as {x, y, z}
+   * @param connectivity
+   */
+  Stencil3D(const std::array<usize, 3>& dims, NeighborConnectivity connectivity);
+
+  const std::array<usize, 3>& dims() const;
+
+  NeighborConnectivity connectivity() const;
+
+  /**
+   * @brief Returns the number of neighbors of an interior voxel.
+   * @return usize
+   */
+  usize numNeighbors() const;
+
+  /**
+   * @brief Returns the offsets of the linear indices of the neighbors from the index of the voxel, in ascending order.
+   * @return const std::vector<int64>&
+   */
+  const std::vector<int64>& offsets() const;
+
+  /**
+   * @brief Returns the {x, y, z} steps to each neighbor in the same order as offsets().
+   * @return const std::vector<Direction>&
+   */
+  const std::vector<Direction>& directions() const;
+
+  /**
+   * @brief Returns the voxels of range that have all of their neighbors inside the grid. Throws std::runtime_error if
+   * range does not lie within the grid.
+   * @param range
+   * @return Range3D
+   */
+  Range3D interior(const Range3D& range) const;
+
+  /**
+   * @brief Returns the non empty, disjoint slabs that together with interior(range) make up range. Throws
+   * std::runtime_error if range does not lie within the grid.
+   * @param range
+   * @return std::vector<Range3D>
+   */
+  std::vector<Range3D> boundaryShells(const Range3D& range) const;
+
+  /**
+   * @brief Calls body(index, neighbors) for every voxel of range on the calling thread, interior voxels first.
+   * Throws std::runtime_error if range does not lie within the grid.
+   * @param range
+   * @param body
+   */
+  template <class Body>
+  void forEach(const Range3D& range, const Body& body) const
+  {
+    const Range3D::RangeType bounds = interior(range).getRange();
+    for(usize z = bounds[4]; z < bounds[5]; z++)
+    {
+      for(usize y = bounds[2]; y < bounds[3]; y++)
+      {
+        const usize rowStart = (z * m_Dims[1] + y) * m_Dims[0];
+        for(usize x = bounds[0]; x < bounds[1]; x++)
+        {
+          body(rowStart + x, InteriorNeighbors(*this, rowStart + x));
+        }
+      }
+    }
+
+    for(const Range3D& shell : boundaryShells(range))
+    {
+      const Range3D::RangeType shellBounds = shell.getRange();
+      for(usize z = shellBounds[4]; z < shellBounds[5]; z++)
+      {
+        for(usize y = shellBounds[2]; y < shellBounds[3]; y++)
+        {
+          const usize rowStart = (z * m_Dims[1] + y) * m_Dims[0];
+          for(usize x = shellBounds[0]; x < shellBounds[1]; x++)
+          {
+            body(rowStart + x, BoundaryNeighbors(*this, rowStart + x, x, y, z));
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * @brief Calls body(index, neighbors) for every voxel of range, splitting range into blocks that run in parallel
+   * through ParallelData3DAlgorithm. Blocks run concurrently, so the body should only write output for index and
+   * should not read what it writes, as a neighbor may be in another block.
+   * Throws std::runtime_error if range does not lie within the grid.
+   * @param range
+   * @param body
+   */
+  template <class Body>
+  void execute(const Range3D& range, const Body& body) const
+  {
+    checkRange(range);
+    const Range3D::RangeType bounds = range.getRange();
+    if(bounds[0] == bounds[1] || bounds[2] == bounds[3] || bounds[4] == bounds[5])
+    {
+      return;
+    }
+    ParallelData3DAlgorithm algorithm(range);
+    algorithm.execute([this, &body](const Range3D& block) { forEach(block, body); });
+  }
+
+private:
+  void checkRange(const Range3D& range) const;
+
+  std::array<usize, 3> m_Dims;
+  NeighborConnectivity m_Connectivity;
+  std::vector<Direction> m_Directions;
+  std::vector<int64> m_Offsets;
+};
+} // namespace NX::Common
@@ -0,0 +1,352 @@
+#include "NX/Common/StridedSpan.hpp"
+
+#include "NX/Common/CpuFeatures.hpp"
+#include "NX/Common/ParallelDataAlgorithm.hpp"
+
+#if defined(NXCOMMON_ARCH_X86)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+
+namespace NX::Common::detail
+{
+namespace
+{
+/**
+ * @brief Number of interleaved bytes transposed at a time. Keeps the strided reads of a block resident in L1
+ * while each component of the block is written out.
+ */
+constexpr usize k_BlockBytes = 1ull << 14;
+
+/**
+ * @brief Arrays smaller than this many bytes are transposed on the calling thread.
+ */
+constexpr usize k_ParallelThresholdBytes = 1ull << 20;
+
+/**
+ * @brief Number of bytes each parallel task transposes.
+ */
+constexpr usize k_ParallelGrainBytes = 1ull << 18;
+
+/**
+ * @brief Transposes tuples [tupleBegin, tupleEnd) between interleaved and planar order.
+ */
+using KernelFunc = void (*)(const std::byte* source, std::byte* destination, usize numComponents, usize numTuples, usize tupleBegin, usize tupleEnd);
+
+template <usize Size, bool ToPlanar>
+void ScalarKernel(const std::byte* source, std::byte* destination, usize numComponents, usize numTuples, usize tupleBegin, usize tupleEnd)
+{
+  const usize blockTuples = std::max<usize>(k_BlockBytes / (Size * numComponents), 1);
+  for(usize blockBegin = tupleBegin; blockBegin < tupleEnd; blockBegin += blockTuples)
+  {
+    const usize blockEnd = std::min(blockBegin + blockTuples, tupleEnd);
+    for(usize c = 0; c < numComponents; c++)
+    {
+      for(usize t = blockBegin; t < blockEnd; t++)
+      {
+        const usize interleavedIndex = t * numComponents + c;
+        const usize planarIndex = c * numTuples + t;
+        if constexpr(ToPlanar)
+        {
+          std::memcpy(destination + planarIndex * Size, source + interleavedIndex * Size, Size);
+        }
+        else
+        {
+          std::memcpy(destination + interleavedIndex * Size, source + planarIndex * Size, Size);
+        }
+      }
+    }
+  }
+}
+
+#if defined(NXCOMMON_ARCH_X86)
+/**
+ * @brief Transposes 4 byte values 4 tuples at a time with register shuffles.
+ */
+template <usize NumComponents, bool ToPlanar>
+NXCOMMON_TARGET("sse2") void Sse2Kernel4(const std::byte* source, std::byte* destination, usize numComponents, usize numTuples, usize tupleBegin, usize tupleEnd)
+{
+  const auto* input = reinterpret_cast<const float*>(source);
+  auto* output = reinterpret_cast<float*>(destination);
+
+  usize t = tupleBegin;
+  for(; t + 4 <= tupleEnd; t += 4)
+  {
+    float* interleavedOut = output + t * NumComponents;
+    const float* interleavedIn = input + t * NumComponents;
+    if constexpr(NumComponents == 2)
+    {
+      if constexpr(ToPlanar)
+      {
+        const __m128 a = _mm_loadu_ps(interleavedIn);
+        const __m128 b = _mm_loadu_ps(interleavedIn + 4);
+        _mm_storeu_ps(output + t, _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(output + numTuples + t, _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1)));
+      }
+      else
+      {
+        const __m128 x = _mm_loadu_ps(input + t);
+        const __m128 y = _mm_loadu_ps(input + numTuples + t);
+        _mm_storeu_ps(interleavedOut, _mm_unpacklo_ps(x, y));
+        _mm_storeu_ps(interleavedOut + 4, _mm_unpackhi_ps(x, y));
+      }
+    }
+    else if constexpr(NumComponents == 3)
+    {
+      if constexpr(ToPlanar)
+      {
+        // a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+        const __m128 a = _mm_loadu_ps(interleavedIn);
+        const __m128 b = _mm_loadu_ps(interleavedIn + 4);
+        const __m128 c = _mm_loadu_ps(interleavedIn + 8);
+        const __m128 x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+        const __m128 y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), c, _MM_SHUFFLE(3, 0, 2, 0));
+        _mm_storeu_ps(output + t, x);
+        _mm_storeu_ps(output + numTuples + t, y);
+        _mm_storeu_ps(output + 2 * numTuples + t, z);
+      }
+      else
+      {
+        const __m128 x = _mm_loadu_ps(input + t);
+        const __m128 y = _mm_loadu_ps(input + numTuples + t);
+        const __m128 z = _mm_loadu_ps(input + 2 * numTuples + t);
+        const __m128 a = _mm_shuffle_ps(_mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 b = _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+        const __m128 c = _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+        _mm_storeu_ps(interleavedOut, a);
+        _mm_storeu_ps(interleavedOut + 4, b);
+        _mm_storeu_ps(interleavedOut + 8, c);
+      }
+    }
+    else
+    {
+      // A 4x4 transpose is its own inverse
+      const float* rowIn = ToPlanar ? interleavedIn : input + t;
+      const usize rowStride = ToPlanar ? 4 : numTuples;
+      __m128 row0 = _mm_loadu_ps(rowIn);
+      __m128 row1 = _mm_loadu_ps(rowIn + rowStride);
+      __m128 row2 = _mm_loadu_ps(rowIn + 2 * rowStride);
+      __m128 row3 = _mm_loadu_ps(rowIn + 3 * rowStride);
+      _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+      float* rowOut = ToPlanar ? output + t : interleavedOut;
+      const usize outStride = ToPlanar ? numTuples : 4;
+      _mm_storeu_ps(rowOut, row0);
+      _mm_storeu_ps(rowOut + outStride, row1);
+      _mm_storeu_ps(rowOut + 2 * outStride, row2);
+      _mm_storeu_ps(rowOut + 3 * outStride, row3);
+    }
+  }
+  ScalarKernel<4, ToPlanar>(source, destination, numComponents, numTuples, t, tupleEnd);
+}
+
+/**
+ * @brief pshufb mask that gathers component c of 4 interleaved tuples of NumComponents bytes into bytes [4c, 4c + 4).
+ */
+template <usize NumComponents>
+constexpr std::array<uint8, 16> MakeGatherMask()
+{
+  std::array<uint8, 16> mask = {};
+  for(usize i = 0; i < mask.size(); i++)
+  {
+    const usize c = i / 4;
+    mask[i] = c < NumComponents ? static_cast<uint8>((i % 4) * NumComponents + c) : 0x80;
+  }
+  return mask;
+}
+
+/**
+ * @brief pshufb mask that reverses MakeGatherMask.
+ */
+template <usize NumComponents>
+constexpr std::array<uint8, 16> MakeScatterMask()
+{
+  std::array<uint8, 16> mask = {};
+  for(usize i = 0; i < mask.size(); i++)
+  {
+    mask[i] = i < 4 * NumComponents ? static_cast<uint8>((i % NumComponents) * 4 + i / NumComponents) : 0x80;
+  }
+  return mask;
+}
+
+template <usize NumComponents>
+inline constexpr std::array<uint8, 16> k_GatherMask = MakeGatherMask<NumComponents>();
+
+template <usize NumComponents>
+inline constexpr std::array<uint8, 16> k_ScatterMask = MakeScatterMask<NumComponents>();
+
+NXCOMMON_TARGET("ssse3") inline void Transpose4x4Epi32(__m128i& v0, __m128i& v1, __m128i& v2, __m128i& v3)
+{
+  const __m128i t0 = _mm_unpacklo_epi32(v0, v1);
+  const __m128i t1 = _mm_unpacklo_epi32(v2, v3);
+  const __m128i t2 = _mm_unpackhi_epi32(v0, v1);
+  const __m128i t3 = _mm_unpackhi_epi32(v2, v3);
+  v0 = _mm_unpacklo_epi64(t0, t1);
+  v1 = _mm_unpackhi_epi64(t0, t1);
+  v2 = _mm_unpacklo_epi64(t2, t3);
+  v3 = _mm_unpackhi_epi64(t2, t3);
+}
+
+/**
+ * @brief Transposes 1 byte values such as RGB and RGBA colors 16 tuples at a time. Each group of 4 tuples is
+ * shuffled so that its components occupy one 32 bit lane each, then a 4x4 transpose of those lanes yields
+ * 16 consecutive values of every component.
+ */
+template <usize NumComponents, bool ToPlanar>
+NXCOMMON_TARGET("ssse3") void Ssse3Kernel1(const std::byte* source, std::byte* destination, usize numComponents, usize numTuples, usize tupleBegin, usize tupleEnd)
+{
+  const __m128i gatherMask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(k_GatherMask<NumComponents>.data()));
+  const __m128i scatterMask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(k_ScatterMask<NumComponents>.data()));
+  // Every group of 4 tuples is loaded or stored as 16 bytes, which reads or writes past the 12 bytes of 3 component tuples
+  const usize groupBytes = 4 * NumComponents;
+  const usize totalBytes = numTuples * NumComponents;
+
+  usize t = tupleBegin;
+  for(; t + 16 <= tupleEnd; t += 16)
+  {
+    const usize offset = t * NumComponents;
+    if constexpr(ToPlanar)
+    {
+      if(offset + 3 * groupBytes + 16 > totalBytes)
+      {
+        break;
+      }
+      __m128i rows[4];
+      for(usize g = 0; g < 4; g++)
+      {
+        rows[g] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(source + offset + g * groupBytes)), gatherMask);
+      }
+      Transpose4x4Epi32(rows[0], rows[1], rows[2], rows[3]);
+      for(usize c = 0; c < NumComponents; c++)
+      {
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + c * numTuples + t), rows[c]);
+      }
+    }
+    else
+    {
+      __m128i rows[4];
+      rows[3] = _mm_setzero_si128();
+      for(usize c = 0; c < NumComponents; c++)
+      {
+        rows[c] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + c * numTuples + t));
+      }
+      Transpose4x4Epi32(rows[0], rows[1], rows[2], rows[3]);
+      for(usize g = 0; g < 4; g++)
+      {
+        const __m128i tuples = _mm_shuffle_epi8(rows[g], scatterMask);
+        std::byte* out = destination + offset + g * groupBytes;
+        if constexpr(NumComponents == 4)
+        {
+          _mm_storeu_si128(reinterpret_cast<__m128i*>(out), tuples);
+        }
+        else
+        {
+          _mm_storel_epi64(reinterpret_cast<__m128i*>(out), tuples);
+          const int32 last = _mm_cvtsi128_si32(_mm_srli_si128(tuples, 8));
+          std::memcpy(out + 8, &last, sizeof(last));
+        }
+      }
+    }
+  }
+  ScalarKernel<1, ToPlanar>(source, destination, numComponents, numTuples, t, tupleEnd);
+}
+#endif
+
+template <usize Size, bool ToPlanar>
+KernelFunc SelectKernel(usize numComponents)
+{
+#if defined(NXCOMMON_ARCH_X86)
+  const CpuFeatures& features = GetCpuFeatures();
+  if constexpr(Size == 4)
+  {
+    if(features.sse2)
+    {
+      switch(numComponents)
+      {
+      case 2:
+        return Sse2Kernel4<2, ToPlanar>;
+      case 3:
+        return Sse2Kernel4<3, ToPlanar>;
+      case 4:
+        return Sse2Kernel4<4, ToPlanar>;
+      default:
+        break;
+      }
+    }
+  }
+  else if constexpr(Size == 1)
+  {
+    if(features.ssse3)
+    {
+      switch(numComponents)
+      {
+      case 3:
+        return Ssse3Kernel1<3, ToPlanar>;
+      case 4:
+        return Ssse3Kernel1<4, ToPlanar>;
+      default:
+        break;
+      }
+    }
+  }
+#endif
+  return ScalarKernel<Size, ToPlanar>;
+}
+
+template <usize Size, bool ToPlanar>
+void TransposeN(const void* source, void* destination, usize numComponents, usize numTuples)
+{
+  const auto* sourceBytes = static_cast<const std::byte*>(source);
+  auto* destinationBytes = static_cast<std::byte*>(destination);
+  if(numComponents == 1 || numTuples == 1)
+  {
+    std::memcpy(destinationBytes, sourceBytes, numComponents * numTuples * Size);
+    return;
+  }
+
+  const KernelFunc kernel = SelectKernel<Size, ToPlanar>(numComponents);
+
+  const usize tupleBytes = Size * numComponents;
+  ParallelDataAlgorithm algorithm(Range(0, numTuples));
+  algorithm.setGrain(std::max<usize>(k_ParallelGrainBytes / tupleBytes, 16));
+  algorithm.setParallelizationEnabled(numTuples * tupleBytes >= k_ParallelThresholdBytes);
+  algorithm.execute([=](const Range& range) { kernel(sourceBytes, destinationBytes, numComponents, numTuples, range.min(), range.max()); });
+}
+
+template <bool ToPlanar>
+void Transpose(const void* source, void* destination, usize elementSize, usize numComponents, usize numTuples)
+{
+  switch(elementSize)
+  {
+  case 1:
+    TransposeN<1, ToPlanar>(source, destination, numComponents, numTuples);
+    break;
+  case 2:
+    TransposeN<2, ToPlanar>(source, destination, numComponents, numTuples);
+    break;
+  case 4:
+    TransposeN<4, ToPlanar>(source, destination, numComponents, numTuples);
+    break;
+  case 8:
+    TransposeN<8, ToPlanar>(source, destination, numComponents, numTuples);
+    break;
+  default:
+    throw std::invalid_argument("Transpose: Element size must be 1, 2, 4 or 8 bytes");
+  }
+}
+} // namespace
+
+void TransposeToPlanar(const void* interleaved, void* planar, usize elementSize, usize numComponents, usize numTuples)
+{
+  Transpose<true>(interleaved, planar, elementSize, numComponents, numTuples);
+}
+
+void TransposeToInterleaved(const void* planar, void* interleaved, usize elementSize, usize numComponents, usize numTuples)
+{
+  Transpose<false>(planar, interleaved, elementSize, numComponents, numTuples);
+}
+} // namespace NX::Common::detail
@@ -0,0 +1,549 @@
+#pragma once
+
+#include "NX/Common/DataVector.hpp"
+#include "NX/Common/NXCommon_export.hpp"
+#include "NX/Common/Types.hpp"
+
+#include "nonstd/span.hpp"
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+namespace NX::Common
+{
+/**
+ * @class StridedSpan
+ * @brief StridedSpan is a non-owning view of size() elements that are stride() elements apart, such as one component
+ * of an array of interleaved tuples. No data is copied.
+ * @tparam T
+ */
+template <class T>
+class StridedSpan
+{
+public:
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using size_type = usize;
+  using pointer = T*;
+  using reference = T&;
+
+  /**
+   * @class Iterator
+   * @brief Random access iterator stepping stride() elements at a time.
+   */
+  class Iterator
+  {
+  public:
+    using iterator_category = std::random_access_iterator_tag;
+    using value_type = std::remove_cv_t<T>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = T*;
+    using reference = T&;
+
+    Iterator() = default;
+
+    Iterator(T* ptr, size_type stride)
+    : m_Ptr(ptr)
+    , m_Stride(static_cast<difference_type>(stride))
+    {
+    }
+
+    reference operator*() const
+    {
+      return *m_Ptr;
+    }
+
+    pointer operator->() const
+    {
+      return m_Ptr;
+    }
+
+    reference operator[](difference_type offset) const
+    {
+      return m_Ptr[offset * m_Stride];
+    }
+
+    Iterator& operator++()
+    {
+      m_Ptr += m_Stride;
+      return *this;
+    }
+
+    Iterator operator++(int)
+    {
+      Iterator copy = *this;
+      m_Ptr += m_Stride;
+      return copy;
+    }
+
+    Iterator& operator--()
+    {
+      m_Ptr -= m_Stride;
+      return *this;
+    }
+
+    Iterator operator--(int)
+    {
+      Iterator copy = *this;
+      m_Ptr -= m_Stride;
+      return copy;
+    }
+
+    Iterator& operator+=(difference_type offset)
+    {
+      m_Ptr += offset * m_Stride;
+      return *this;
+    }
+
+    Iterator& operator-=(difference_type offset)
+    {
+      m_Ptr -= offset * m_Stride;
+      return *this;
+    }
+
+    friend Iterator operator+(Iterator iter, difference_type offset)
+    {
+      return iter += offset;
+    }
+
+    friend Iterator operator+(difference_type offset, Iterator iter)
+    {
+      return iter += offset;
+    }
+
+    friend Iterator operator-(Iterator iter, difference_type offset)
+    {
+      return iter -= offset;
+    }
+
+    friend difference_type operator-(const Iterator& lhs, const Iterator& rhs)
+    {
+      return (lhs.m_Ptr - rhs.m_Ptr) / lhs.m_Stride;
+    }
+
+    friend bool operator==(const Iterator& lhs, const Iterator& rhs)
+    {
+      return lhs.m_Ptr == rhs.m_Ptr;
+    }
+
+    friend bool operator!=(const Iterator& lhs, const Iterator& rhs)
+    {
+      return lhs.m_Ptr != rhs.m_Ptr;
+    }
+
+    friend bool operator<(const Iterator& lhs, const Iterator& rhs)
+    {
+      return lhs.m_Ptr < rhs.m_Ptr;
+    }
+
+    friend bool operator>(const Iterator& lhs, const Iterator& rhs)
+    {
+      return lhs.m_Ptr > rhs.m_Ptr;
+    }
+
+    friend bool operator<=(const Iterator& lhs, const Iterator& rhs)
+    {
+      return lhs.m_Ptr <= rhs.m_Ptr;
+    }
+
+    friend bool operator>=(const Iterator& lhs, const Iterator& rhs)
+    {
+      return lhs.m_Ptr >= rhs.m_Ptr;
+    }
+
+  private:
+    T* m_Ptr = nullptr;
+    difference_type m_Stride = 1;
+  };
+
+  using iterator = Iterator;
+
+  StridedSpan() noexcept = default;
+
+  /**
+   * @brief Views size elements starting at data, each stride elements after the previous one.
+   * @param data
+   * @param size
+   * @param stride Must not be 0
+   */
+  StridedSpan(T* data, size_type size, size_type stride) noexcept
+  : m_Data(data)
+  , m_Size(size)
+  , m_Stride(stride)
+  {
+  }
+
+  /**
+   * @brief Views a contiguous span, i.e. with a stride of 1.
+   * @param span
+   */
+  explicit StridedSpan(nonstd::span<T> span) noexcept
+  : StridedSpan(span.data(), span.size(), 1)
+  {
+  }
+
+  /**
+   * @brief Allows a StridedSpan<T> to be passed as a StridedSpan<const T>.
+   * @param other
+   */
+  template <class U, class = std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>>>
+  StridedSpan(const StridedSpan<U>& other) noexcept
+  : StridedSpan(other.data(), other.size(), other.stride())
+  {
+  }
+
+  /**
+   * @brief Returns a pointer to the first element.
+   * @return pointer
+   */
+  pointer data() const noexcept
+  {
+    return m_Data;
+  }
+
+  size_type size() const noexcept
+  {
+    return m_Size;
+  }
+
+  /**
+   * @brief Returns the distance in elements between consecutive elements of the view.
+   * @return size_type
+   */
+  size_type stride() const noexcept
+  {
+    return m_Stride;
+  }
+
+  bool empty() const noexcept
+  {
+    return m_Size == 0;
+  }
+
+  /**
+   * @brief Returns true if the elements are adjacent in memory.
+   * @return bool
+   */
+  bool isContiguous() const noexcept
+  {
+    return m_Stride == 1;
+  }
+
+  reference operator[](size_type index) const
+  {
+    return m_Data[index * m_Stride];
+  }
+
+  /**
+   * @brief Returns the element at index. Throws std::runtime_error if index is out of bounds.
+   * @param index
+   * @return reference
+   */
+  reference at(size_type index) const
+  {
+    if(index >= m_Size)
+    {
+      throw std::runtime_error("StridedSpan: Index is out of bounds");
+    }
+    return (*this)[index];
+  }
+
+  iterator begin() const noexcept
+  {
+    return Iterator(m_Data, m_Stride);
+  }
+
+  iterator end() const noexcept
+  {
+    return Iterator(m_Data + m_Size * m_Stride, m_Stride);
+  }
+
+private:
+  T* m_Data = nullptr;
+  size_type m_Size = 0;
+  size_type m_Stride = 1;
+};
+
+/**
+ * @class TupleSpan
+ * @brief TupleSpan views a flat array as numTuples() tuples of numComponents() interleaved components, for example the
+ * three angles of every Euler angle triplet. Single tuples are contiguous spans and single components are StridedSpans,
+ * so neither requires a copy. Iterating a TupleSpan yields each tuple in order.
+ * @tparam T
+ */
+template <class T>
+class TupleSpan
+{
+public:
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using size_type = usize;
+
+  /**
+   * @class Iterator
+   * @brief Iterator over the tuples that yields each tuple as a nonstd::span<T>.
+   */
+  class Iterator
+  {
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = nonstd::span<T>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = void;
+    using reference = nonstd::span<T>;
+
+    Iterator() = default;
+
+    Iterator(T* ptr, size_type numComponents)
+    : m_Ptr(ptr)
+    , m_NumComponents(numComponents)
+    {
+    }
+
+    reference operator*() const
+    {
+      return {m_Ptr, m_NumComponents};
+    }
+
+    Iterator& operator++()
+    {
+      m_Ptr += m_NumComponents;
+      return *this;
+    }
+
+    Iterator operator++(int)
+    {
+      Iterator copy = *this;
+      m_Ptr += m_NumComponents;
+      return copy;
+    }
+
+    friend bool operator==(const Iterator& lhs, const Iterator& rhs)
+    {
+      return lhs.m_Ptr == rhs.m_Ptr;
+    }
+
+    friend bool operator!=(const Iterator& lhs, const Iterator& rhs)
+    {
+      return lhs.m_Ptr != rhs.m_Ptr;
+    }
+
+  private:
+    T* m_Ptr = nullptr;
+    size_type m_NumComponents = 1;
+  };
+
+  using iterator = Iterator;
+
+  TupleSpan() noexcept = default;
+
+  /**
+   * @brief Views values as tuples of numComponents components. Throws std::runtime_error if numComponents is 0
+   * or does not evenly divide the number of values.
+   * @param values
+   * @param numComponents
+   */
+  TupleSpan(nonstd::span<T> values, size_type numComponents)
+  : m_Values(values)
+  , m_NumComponents(numComponents)
+  {
+    if(m_NumComponents == 0)
+    {
+      throw std::runtime_error("TupleSpan: Number of components cannot be 0");
+    }
+    if(m_Values.size() % m_NumComponents != 0)
+    {
+      throw std::runtime_error("TupleSpan: Number of values is not a multiple of the number of components");
+    }
+  }
+
+  /**
+   * @brief Views the elements of a DataVector as tuples of numComponents components.
+   * @param values
+   * @param numComponents
+   */
+  TupleSpan(DataVector<value_type>& values, size_type numComponents)
+  : TupleSpan(values.createSpan(), numComponents)
+  {
+  }
+
+  /**
+   * @brief Views the elements of a DataVector as read only tuples of numComponents components.
+   * @param values
+   * @param numComponents
+   */
+  template <class U = T, class = std::enable_if_t<std::is_const_v<U>>>
+  TupleSpan(const DataVector<value_type>& values, size_type numComponents)
+  : TupleSpan(values.createSpan(), numComponents)
+  {
+  }
+
+  /**
+   * @brief Allows a TupleSpan<T> to be passed as a TupleSpan<const T>.
+   * @param other
+   */
+  template <class U, class = std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>>>
+  TupleSpan(const TupleSpan<U>& other) noexcept
+  : m_Values(other.values())
+  , m_NumComponents(other.numComponents())
+  {
+  }
+
+  /**
+   * @brief Returns the number of tuples.
+   * @return size_type
+   */
+  size_type numTuples() const noexcept
+  {
+    return m_Values.size() / m_NumComponents;
+  }
+
+  /**
+   * @brief Returns the number of components per tuple.
+   * @return size_type
+   */
+  size_type numComponents() const noexcept
+  {
+    return m_NumComponents;
+  }
+
+  /**
+   * @brief Returns the total number of values, numTuples() * numComponents().
+   * @return size_type
+   */
+  size_type size() const noexcept
+  {
+    return m_Values.size();
+  }
+
+  /**
+   * @brief Returns all values in their interleaved order.
+   * @return nonstd::span<T>
+   */
+  nonstd::span<T> values() const noexcept
+  {
+    return m_Values;
+  }
+
+  /**
+   * @brief Returns the components of a tuple.
+   * @param tupleIndex
+   * @return nonstd::span<T>
+   */
+  nonstd::span<T> tuple(size_type tupleIndex) const
+  {
+    return m_Values.subspan(tupleIndex * m_NumComponents, m_NumComponents);
+  }
+
+  /**
+   * @brief Returns one component of every tuple. Throws std::runtime_error if componentIndex is out of bounds.
+   * @param componentIndex
+   * @return StridedSpan<T>
+   */
+  StridedSpan<T> component(size_type componentIndex) const
+  {
+    if(componentIndex >= m_NumComponents)
+    {
+      throw std::runtime_error("TupleSpan: Component index is out of bounds");
+    }
+    return StridedSpan<T>(m_Values.data() + componentIndex, numTuples(), m_NumComponents);
+  }
+
+  /**
+   * @brief Returns the value of a component of a tuple.
+   * @param tupleIndex
+   * @param componentIndex
+   * @return T&
+   */
+  T& operator()(size_type tupleIndex, size_type componentIndex) const
+  {
+    return m_Values[tupleIndex * m_NumComponents + componentIndex];
+  }
+
+  /**
+   * @brief Returns the value of a component of a tuple. Throws std::runtime_error if either index is out of bounds.
+   * @param tupleIndex
+   * @param componentIndex
+   * @return T&
+   */
+  T& at(size_type tupleIndex, size_type componentIndex) const
+  {
+    if(tupleIndex >= numTuples() || componentIndex >= m_NumComponents)
+    {
+      throw std::runtime_error("TupleSpan: Index is out of bounds");
+    }
+    return (*this)(tupleIndex, componentIndex);
+  }
+
+  iterator begin() const noexcept
+  {
+    return Iterator(m_Values.data(), m_NumComponents);
+  }
+
+  iterator end() const noexcept
+  {
+    return Iterator(m_Values.data() + m_Values.size(), m_NumComponents);
+  }
+
+private:
+  nonstd::span<T> m_Values;
+  size_type m_NumComponents = 1;
+};
+
+namespace detail
+{
+/**
+ * @brief Copies numTuples tuples of numComponents elements of elementSize bytes from interleaved to planar order,
+ * i.e. element c of tuple t moves from index t * numComponents + c to index c * numTuples + t.
+ * elementSize must be 1, 2, 4 or 8 and the buffers must not overlap.
+ */
+NXCOMMON_EXPORT void TransposeToPlanar(const void* interleaved, void* planar, usize elementSize, usize numComponents, usize numTuples);
+
+/**
+ * @brief The inverse of TransposeToPlanar.
+ */
+NXCOMMON_EXPORT void TransposeToInterleaved(const void* planar, void* interleaved, usize elementSize, usize numComponents, usize numTuples);
+} // namespace detail
+
+/**
+ * @brief Writes the components of source into destination one after the other, so component c of every tuple forms
+ * the contiguous range [c * numTuples(), (c + 1) * numTuples()) of destination (array of structures to structure of
+ * arrays). Tuples of 2 to 4 components of 4 byte values and of 3 or 4 components of 1 byte values use SIMD shuffles,
+ * everything else is copied in cache sized blocks. Large arrays are split across threads through ParallelDataAlgorithm.
+ * Throws std::invalid_argument if destination is not the size of source.
+ * @tparam T
+ * @param source
+ * @param destination
+ */
+template <class T>
+void TransposeToPlanar(TupleSpan<const std::remove_cv_t<T>> source, nonstd::span<T> destination)
+{
+  static_assert(std::is_trivially_copyable_v<T> && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8), "TransposeToPlanar: Unsupported value type");
+  if(source.size() != destination.size())
+  {
+    throw std::invalid_argument("TransposeToPlanar: Source and destination must be the same size");
+  }
+  detail::TransposeToPlanar(source.values().data(), destination.data(), sizeof(T), source.numComponents(), source.numTuples());
+}
+
+/**
+ * @brief The inverse of TransposeToPlanar. Reads numComponents() contiguous component arrays from source and writes
+ * them interleaved into destination (structure of arrays to array of structures).
+ * Throws std::invalid_argument if destination is not the size of source.
+ * @tparam T
+ * @param source
+ * @param destination
+ */
+template <class T>
+void TransposeToInterleaved(nonstd::span<const std::remove_cv_t<T>> source, TupleSpan<T> destination)
+{
+  static_assert(std::is_trivially_copyable_v<T> && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8), "TransposeToInterleaved: Unsupported value type");
+  if(source.size() != destination.size())
+  {
+    throw std::invalid_argument("TransposeToInterleaved: Source and destination must be the same size");
+  }
+  detail::TransposeToInterleaved(source.data(), destination.values().data(), sizeof(T), destination.numComponents(), destination.numTuples());
+}
+} // namespace NX::Common
@@ -0,0 +1,421 @@
+#include "NX/Common/ThreadPool.hpp"
+
+#include <algorithm>
+
+namespace NX::Common
+{
+namespace detail
+{
+struct PoolTask
+{
+  std::function<void()> func;
+  TaskGroup* group = nullptr;
+};
+
+/**
+ * @brief Chase-Lev work stealing deque, following "Correct and Efficient Work-Stealing for Weak Memory Models"
+ * (Le, Pop, Cohen, Zappa Nardelli 2013). push and pop may only be called by the owning worker, steal by any thread.
+ * The ring buffer grows when full. Replaced buffers are kept until the deque is destroyed because a thief may still be
+ * reading from them.
+ */
+class WorkStealingDeque
+{
+public:
+  WorkStealingDeque()
+  {
+    m_Buffers.push_back(std::make_unique<Buffer>(k_InitialCapacity));
+    m_Buffer.store(m_Buffers.back().get(), std::memory_order_relaxed);
+  }
+
+  void push(PoolTask* task)
+  {
+    const int64 bottom = m_Bottom.load(std::memory_order_relaxed);
+    const int64 top = m_Top.load(std::memory_order_acquire);
+    Buffer* buffer = m_Buffer.load(std::memory_order_relaxed);
+    if(bottom - top > static_cast<int64>(buffer->capacity) - 1)
+    {
+      buffer = grow(buffer, top, bottom);
+    }
+    buffer->put(bottom, task);
+    // A release store rather than the paper's release fence, equivalent here and understood by thread sanitizers
+    m_Bottom.store(bottom + 1, std::memory_order_release);
+  }
+
+  PoolTask* pop()
+  {
+    const int64 bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+    Buffer* buffer = m_Buffer.load(std::memory_order_relaxed);
+    m_Bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64 top = m_Top.load(std::memory_order_relaxed);
+    if(top > bottom)
+    {
+      m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+      return nullptr;
+    }
+    PoolTask* task = buffer->get(bottom);
+    if(top == bottom)
+    {
+      // Last task, race any thief for it
+      if(!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+      {
+        task = nullptr;
+      }
+      m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return task;
+  }
+
+  PoolTask* steal()
+  {
+    int64 top = m_Top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const int64 bottom = m_Bottom.load(std::memory_order_acquire);
+    if(top >= bottom)
+    {
+      return nullptr;
+    }
+    PoolTask* task = m_Buffer.load(std::memory_order_acquire)->get(top);
+    if(!m_Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+      return nullptr;
+    }
+    return task;
+  }
+
+private:
+  static constexpr usize k_InitialCapacity = 256;
+
+  struct Buffer
+  {
+    explicit Buffer(usize bufferCapacity)
+    : capacity(bufferCapacity)
+    , slots(std::make_unique<std::atomic<PoolTask*>[]>(bufferCapacity))
+    {
+    }
+
+    PoolTask* get(int64 index) const
+    {
+      return slots[static_cast<usize>(index) & (capacity - 1)].load(std::memory_order_relaxed);
+    }
+
+    void put(int64 index, PoolTask* task)
+    {
+      slots[static_cast<usize>(index) & (capacity - 1)].store(task, std::memory_order_relaxed);
+    }
+
+    usize capacity = 0;
+    std::unique_ptr<std::atomic<PoolTask*>[]> slots;
+  };
+
+  Buffer* grow(Buffer* buffer, int64 top, int64 bottom)
+  {
+    m_Buffers.push_back(std::make_unique<Buffer>(buffer->capacity * 2));
+    Buffer* newBuffer = m_Buffers.back().get();
+    for(int64 i = top; i < bottom; i++)
+    {
+      newBuffer->put(i, buffer->get(i));
+    }
+    m_Buffer.store(newBuffer, std::memory_order_release);
+    return newBuffer;
+  }
+
+  std::atomic<int64> m_Top{0};
+  std::atomic<int64> m_Bottom{0};
+  std::atomic<Buffer*> m_Buffer{nullptr};
+  std::vector<std::unique_ptr<Buffer>> m_Buffers;
+};
+} // namespace detail
+
+namespace
+{
+/**
+ * @brief Number of times an idle worker looks for work, yielding in between, before it goes to sleep.
+ */
+constexpr usize k_NumIdleSpins = 64;
+
+/**
+ * @brief Maximum number of stolen tasks a thread may have on its stack. A thread waiting on a TaskGroup only steals
+ * below this depth, otherwise every wait could start another unrelated task and the stack would grow without bound.
+ * Tasks from the thread's own deque are always run, the ones on top being those the waiting task spawned.
+ */
+constexpr usize k_MaxNestedSteals = 8;
+
+/**
+ * @brief Identifies the pool and deque of the calling thread if it is a worker.
+ */
+struct WorkerContext
+{
+  const ThreadPool* pool = nullptr;
+  usize index = 0;
+  uint64 randomState = 0;
+};
+
+thread_local WorkerContext t_Worker;
+thread_local usize t_NumNestedSteals = 0;
+
+uint64 NextRandom(uint64& state)
+{
+  // xorshift64
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+} // namespace
+
+ThreadPool::ThreadPool(usize numThreads)
+{
+  if(numThreads == 0)
+  {
+    numThreads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  const usize numWorkers = numThreads - 1;
+  for(usize i = 0; i < numWorkers; i++)
+  {
+    m_Deques.push_back(std::make_unique<detail::WorkStealingDeque>());
+  }
+  m_Threads.reserve(numWorkers);
+  for(usize i = 0; i < numWorkers; i++)
+  {
+    m_Threads.emplace_back(&ThreadPool::runWorker, this, i);
+  }
+}
+
+ThreadPool::~ThreadPool() noexcept
+{
+  {
+    std::lock_guard<std::mutex> lock(m_SleepMutex);
+    m_Stopping.store(true);
+  }
+  m_SleepCondition.notify_all();
+  for(std::thread& thread : m_Threads)
+  {
+    thread.join();
+  }
+}
+
+ThreadPool& ThreadPool::Global()
+{
+  static ThreadPool pool;
+  return pool;
+}
+
+usize ThreadPool::numThreads() const
+{
+  return m_Threads.size() + 1;
+}
+
+void ThreadPool::submit(detail::PoolTask* task)
+{
+  if(t_Worker.pool == this)
+  {
+    m_Deques[t_Worker.index]->push(task);
+  }
+  else
+  {
+    std::lock_guard<std::mutex> lock(m_InjectionMutex);
+    m_InjectionQueue.push_back(task);
+    m_NumInjected.fetch_add(1);
+  }
+
+  // Sleeping workers check the epoch under the sleep mutex after announcing themselves, so either they see the new
+  // epoch or this sees them sleeping and wakes one
+  m_Epoch.fetch_add(1);
+  if(m_NumSleeping.load() > 0)
+  {
+    std::lock_guard<std::mutex> lock(m_SleepMutex);
+    m_SleepCondition.notify_one();
+  }
+}
+
+void ThreadPool::runTask(detail::PoolTask* task)
+{
+  std::unique_ptr<detail::PoolTask> taskOwner(task);
+  std::exception_ptr exception;
+  try
+  {
+    task->func();
+  } catch(...)
+  {
+    exception = std::current_exception();
+  }
+  // The group may be destroyed as soon as it sees the count drop, so the task is freed first
+  TaskGroup* group = task->group;
+  taskOwner.reset();
+  group->finishTask(std::move(exception));
+}
+
+void ThreadPool::runStolenTask(detail::PoolTask* task)
+{
+  t_NumNestedSteals++;
+  runTask(task);
+  t_NumNestedSteals--;
+}
+
+bool ThreadPool::runPendingTask(const TaskGroup* waitingGroup, bool allowSteal)
+{
+  const bool isWorker = t_Worker.pool == this;
+  if(isWorker)
+  {
+    if(detail::PoolTask* task = m_Deques[t_Worker.index]->pop(); task != nullptr)
+    {
+      runTask(task);
+      return true;
+    }
+  }
+  else if(waitingGroup != nullptr && m_NumInjected.load() > 0)
+  {
+    // Threads outside the pool have no deque and queue their tasks here, so the newest task of the group they wait on
+    // stands in for the bottom of their deque
+    detail::PoolTask* task = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(m_InjectionMutex);
+      const auto iter = std::find_if(m_InjectionQueue.rbegin(), m_InjectionQueue.rend(), [waitingGroup](const detail::PoolTask* queuedTask) { return queuedTask->group == waitingGroup; });
+      if(iter != m_InjectionQueue.rend())
+      {
+        task = *iter;
+        m_InjectionQueue.erase(std::next(iter).base());
+        m_NumInjected.fetch_sub(1);
+      }
+    }
+    if(task != nullptr)
+    {
+      runTask(task);
+      return true;
+    }
+  }
+
+  if(!allowSteal)
+  {
+    return false;
+  }
+
+  if(m_NumInjected.load() > 0)
+  {
+    detail::PoolTask* task = nullptr;
+    {
+      std::lock_guard<std::mutex> lock(m_InjectionMutex);
+      if(!m_InjectionQueue.empty())
+      {
+        task = m_InjectionQueue.front();
+        m_InjectionQueue.pop_front();
+        m_NumInjected.fetch_sub(1);
+      }
+    }
+    if(task != nullptr)
+    {
+      runStolenTask(task);
+      return true;
+    }
+  }
+
+  const usize numDeques = m_Deques.size();
+  if(numDeques == 0)
+  {
+    return false;
+  }
+  // Start at a random victim so that thieves spread out
+  thread_local uint64 t_RandomState = std::hash<std::thread::id>()(std::this_thread::get_id()) | 1;
+  const usize start = static_cast<usize>(NextRandom(isWorker ? t_Worker.randomState : t_RandomState) % numDeques);
+  for(usize i = 0; i < numDeques; i++)
+  {
+    const usize victim = (start + i) % numDeques;
+    if(isWorker && victim == t_Worker.index)
+    {
+      continue;
+    }
+    if(detail::PoolTask* task = m_Deques[victim]->steal(); task != nullptr)
+    {
+      runStolenTask(task);
+      return true;
+    }
+  }
+  return false;
+}
+
+void ThreadPool::runWorker(usize index)
+{
+  t_Worker.pool = this;
+  t_Worker.index = index;
+  t_Worker.randomState = 0x9E3779B97F4A7C15ull * (index + 1);
+
+  while(!m_Stopping.load(std::memory_order_relaxed))
+  {
+    const uint64 epoch = m_Epoch.load();
+    bool foundTask = false;
+    for(usize spin = 0; spin < k_NumIdleSpins && !foundTask; spin++)
+    {
+      foundTask = runPendingTask(nullptr, true);
+      if(!foundTask)
+      {
+        std::this_thread::yield();
+      }
+    }
+    if(foundTask)
+    {
+      continue;
+    }
+
+    std::unique_lock<std::mutex> lock(m_SleepMutex);
+    m_NumSleeping.fetch_add(1);
+    m_SleepCondition.wait(lock, [this, epoch]() { return m_Stopping.load() || m_Epoch.load() != epoch; });
+    m_NumSleeping.fetch_sub(1);
+  }
+}
+
+TaskGroup::TaskGroup(ThreadPool& pool)
+: m_Pool(pool)
+{
+}
+
+TaskGroup::~TaskGroup() noexcept
+{
+  try
+  {
+    wait();
+  } catch(...)
+  {
+  }
+}
+
+void TaskGroup::run(std::function<void()> task)
+{
+  m_NumPending.fetch_add(1);
+  m_Pool.submit(new detail::PoolTask{std::move(task), this});
+}
+
+void TaskGroup::wait()
+{
+  while(m_NumPending.load(std::memory_order_acquire) != 0)
+  {
+    if(!m_Pool.runPendingTask(this, t_NumNestedSteals < k_MaxNestedSteals))
+    {
+      std::this_thread::yield();
+    }
+  }
+
+  std::exception_ptr exception;
+  {
+    std::lock_guard<std::mutex> lock(m_ExceptionMutex);
+    std::swap(exception, m_Exception);
+  }
+  if(exception)
+  {
+    std::rethrow_exception(exception);
+  }
+}
+
+void TaskGroup::finishTask(std::exception_ptr exception)
+{
+  if(exception)
+  {
+    std::lock_guard<std::mutex> lock(m_ExceptionMutex);
+    if(!m_Exception)
+    {
+      m_Exception = std::move(exception);
+    }
+  }
+  m_NumPending.fetch_sub(1, std::memory_order_acq_rel);
+}
+} // namespace NX::Common
@@ -0,0 +1,152 @@
+#pragma once
+
+#include "NX/Common/NXCommon_export.hpp"
+#include "NX/Common/Types.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace NX::Common
+{
+class TaskGroup;
+
+namespace detail
+{
+struct PoolTask;
+class WorkStealingDeque;
+} // namespace detail
+
+/**
+ * @class ThreadPool
+ * @brief ThreadPool is a work stealing scheduler for builds without TBB. Each worker owns a Chase-Lev deque: it pushes
+ * and pops tasks it creates at the bottom, while idle workers steal the oldest, and usually largest, tasks from the
+ * top. Tasks created by threads outside the pool go through a global injection queue. Tasks are run through TaskGroup.
+ * A pool of numThreads threads starts numThreads - 1 workers, since the thread waiting on a TaskGroup runs tasks too.
+ */
+class NXCOMMON_EXPORT ThreadPool
+{
+public:
+  /**
+   * @brief Starts the workers. A numThreads of 0 uses one thread per hardware thread.
+   * @param numThreads
+   */
+  explicit ThreadPool(usize numThreads = 0);
+
+  /**
+   * @brief Stops and joins the workers. Every TaskGroup using the pool must have been waited on.
+   */
+  ~ThreadPool() noexcept;
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool(ThreadPool&&) noexcept = delete;
+
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ThreadPool& operator=(ThreadPool&&) noexcept = delete;
+
+  /**
+   * @brief Returns the pool shared by the parallel algorithms, created with one thread per hardware thread on first use.
+   * @return ThreadPool&
+   */
+  static ThreadPool& Global();
+
+  /**
+   * @brief Returns the number of threads that run tasks, including the waiting thread.
+   * @return usize
+   */
+  usize numThreads() const;
+
+private:
+  friend class TaskGroup;
+
+  /**
+   * @brief Queues task on the deque of the calling worker, or on the injection queue if called from another thread.
+   * @param task
+   */
+  void submit(detail::PoolTask* task);
+
+  /**
+   * @brief Runs one queued task, looking in the deque of the calling worker, or for a thread outside the pool the tasks
+   * it queued for waitingGroup, then, if allowSteal is true, the injection queue and the deques of the other workers.
+   * Returns false if no task was found.
+   * @param waitingGroup Group the calling thread waits on, if any
+   * @param allowSteal
+   * @return bool
+   */
+  bool runPendingTask(const TaskGroup* waitingGroup, bool allowSteal);
+
+  /**
+   * @brief Runs task, reports its completion and any exception it threw to its group, then frees it.
+   * @param task
+   */
+  static void runTask(detail::PoolTask* task);
+
+  /**
+   * @brief Runs a task taken from the injection queue or another worker, counting it towards the nesting limit.
+   * @param task
+   */
+  static void runStolenTask(detail::PoolTask* task);
+
+  void runWorker(usize index);
+
+  std::vector<std::unique_ptr<detail::WorkStealingDeque>> m_Deques;
+  std::vector<std::thread> m_Threads;
+  std::mutex m_InjectionMutex;
+  std::deque<detail::PoolTask*> m_InjectionQueue;
+  std::atomic<usize> m_NumInjected{0};
+  std::mutex m_SleepMutex;
+  std::condition_variable m_SleepCondition;
+  std::atomic<uint64> m_Epoch{0};
+  std::atomic<usize> m_NumSleeping{0};
+  std::atomic<bool> m_Stopping{false};
+};
+
+/**
+ * @class TaskGroup
+ * @brief TaskGroup runs tasks on a ThreadPool and waits for them. Waiting runs queued tasks rather than blocking, so
+ * tasks may create and wait on task groups of their own for fork-join parallelism.
+ */
+class NXCOMMON_EXPORT TaskGroup
+{
+public:
+  explicit TaskGroup(ThreadPool& pool);
+
+  /**
+   * @brief Waits for tasks that are still running. Exceptions they throw are discarded.
+   */
+  ~TaskGroup() noexcept;
+
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup(TaskGroup&&) noexcept = delete;
+
+  TaskGroup& operator=(const TaskGroup&) = delete;
+  TaskGroup& operator=(TaskGroup&&) noexcept = delete;
+
+  /**
+   * @brief Queues task to run on the pool. It may run on any thread, including the one that calls wait().
+   * @param task
+   */
+  void run(std::function<void()> task);
+
+  /**
+   * @brief Returns once every task run so far has finished. Rethrows the first exception thrown by a task.
+   */
+  void wait();
+
+private:
+  friend class ThreadPool;
+
+  void finishTask(std::exception_ptr exception);
+
+  ThreadPool& m_Pool;
+  std::atomic<usize> m_NumPending{0};
+  std::mutex m_ExceptionMutex;
+  std::exception_ptr m_Exception;
+};
+} // namespace NX::Common
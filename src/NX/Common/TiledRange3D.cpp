@@ -0,0 +1,164 @@
+#include "NX/Common/TiledRange3D.hpp"
+
+#include <fmt/format.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace NX::Common
+{
+namespace
+{
+/**
+ * @brief Minimum number of rows, 8 x 8 in y and z, that an automatic tile keeps so stencils have neighbors to reuse.
+ */
+constexpr usize k_MinTileCrossSection = 64;
+
+std::array<usize, 3> Extents(const Range3D& range)
+{
+  return {range[1] - range[0], range[3] - range[2], range[5] - range[4]};
+}
+
+usize CeilDiv(usize numerator, usize denominator)
+{
+  return (numerator + denominator - 1) / denominator;
+}
+} // namespace
+
+VoxelIndexRange::VoxelIndexRange(const Range3D& range, const std::array<usize, 3>& dims)
+: m_Range(range.getRange())
+, m_Dims(dims)
+{
+}
+
+usize VoxelIndexRange::size() const
+{
+  return (m_Range[1] - m_Range[0]) * (m_Range[3] - m_Range[2]) * (m_Range[5] - m_Range[4]);
+}
+
+bool VoxelIndexRange::empty() const
+{
+  return size() == 0;
+}
+
+VoxelIndexRange::Iterator VoxelIndexRange::begin() const
+{
+  if(empty())
+  {
+    return end();
+  }
+  const usize index = linearIndex(m_Range[0], m_Range[2], m_Range[4]);
+  return Iterator(this, index, index + (m_Range[1] - m_Range[0]), m_Range[2], m_Range[4]);
+}
+
+VoxelIndexRange::Iterator VoxelIndexRange::end() const
+{
+  // The first voxel past the last row, which no voxel of the range shares an index with
+  const usize index = linearIndex(m_Range[0], m_Range[2], m_Range[5]);
+  return Iterator(this, index, index, m_Range[2], m_Range[5]);
+}
+
+TiledRange3D::TiledRange3D(const Range3D& range, const std::array<usize, 3>& dims, const TileExtents& tileExtents)
+: m_Range(range)
+, m_Dims(dims)
+, m_TileExtents(tileExtents)
+, m_NumTiles({0, 0, 0})
+{
+  const std::array<usize, 3> extents = Extents(range);
+  for(usize i = 0; i < 3; i++)
+  {
+    if(range[2 * i] > range[2 * i + 1] || range[2 * i + 1] > dims[i])
+    {
+      throw std::runtime_error(fmt::format("TiledRange3D: range [{}, {}) along axis {} does not lie within the grid size {}", range[2 * i], range[2 * i + 1], i, dims[i]));
+    }
+    if(m_TileExtents[i] == 0)
+    {
+      m_TileExtents[i] = std::max<usize>(1, extents[i]);
+    }
+  }
+  if(extents[0] != 0 && extents[1] != 0 && extents[2] != 0)
+  {
+    for(usize i = 0; i < 3; i++)
+    {
+      m_NumTiles[i] = CeilDiv(extents[i], m_TileExtents[i]);
+    }
+  }
+}
+
+TiledRange3D::TiledRange3D(const Range3D& range, const std::array<usize, 3>& dims, usize bytesPerVoxel)
+: TiledRange3D(range, dims, AutomaticTileExtents(range, bytesPerVoxel))
+{
+}
+
+TiledRange3D::TileExtents TiledRange3D::AutomaticTileExtents(const Range3D& range, usize bytesPerVoxel, usize tileBytes)
+{
+  const std::array<usize, 3> extents = Extents(range);
+  const usize numX = std::max<usize>(1, extents[0]);
+  const usize numY = std::max<usize>(1, extents[1]);
+  const usize numZ = std::max<usize>(1, extents[2]);
+  const usize numVoxels = std::max<usize>(1, tileBytes / std::max<usize>(1, bytesPerVoxel));
+
+  const usize tileX = std::min(numX, std::max<usize>(1, numVoxels / k_MinTileCrossSection));
+  const usize numRows = std::max<usize>(1, numVoxels / tileX);
+  const usize tileY = std::min(numY, std::max<usize>(1, static_cast<usize>(std::sqrt(static_cast<float64>(numRows)))));
+  const usize tileZ = std::min(numZ, std::max<usize>(1, numRows / tileY));
+  return {tileX, tileY, tileZ};
+}
+
+const Range3D& TiledRange3D::range() const
+{
+  return m_Range;
+}
+
+const std::array<usize, 3>& TiledRange3D::dims() const
+{
+  return m_Dims;
+}
+
+const TiledRange3D::TileExtents& TiledRange3D::tileExtents() const
+{
+  return m_TileExtents;
+}
+
+std::array<usize, 3> TiledRange3D::numTilesPerAxis() const
+{
+  return m_NumTiles;
+}
+
+usize TiledRange3D::numTiles() const
+{
+  return m_NumTiles[0] * m_NumTiles[1] * m_NumTiles[2];
+}
+
+Range3D TiledRange3D::tile(usize index) const
+{
+  if(index >= numTiles())
+  {
+    throw std::runtime_error(fmt::format("TiledRange3D: tile index {} is out of bounds for {} tiles", index, numTiles()));
+  }
+  const std::array<usize, 3> tileIndex = {index % m_NumTiles[0], (index / m_NumTiles[0]) % m_NumTiles[1], index / (m_NumTiles[0] * m_NumTiles[1])};
+  std::array<usize, 6> bounds = {};
+  for(usize i = 0; i < 3; i++)
+  {
+    bounds[2 * i] = m_Range[2 * i] + tileIndex[i] * m_TileExtents[i];
+    bounds[2 * i + 1] = std::min(m_Range[2 * i + 1], bounds[2 * i] + m_TileExtents[i]);
+  }
+  return {bounds[0], bounds[1], bounds[2], bounds[3], bounds[4], bounds[5]};
+}
+
+VoxelIndexRange TiledRange3D::voxelIndices(usize index) const
+{
+  return {tile(index), m_Dims};
+}
+
+TiledRange3D::Iterator TiledRange3D::begin() const
+{
+  return {this, 0};
+}
+
+TiledRange3D::Iterator TiledRange3D::end() const
+{
+  return {this, numTiles()};
+}
+} // namespace NX::Common
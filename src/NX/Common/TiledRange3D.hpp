@@ -0,0 +1,312 @@
+#pragma once
+
+#include "NX/Common/NXCommon_export.hpp"
+#include "NX/Common/ParallelDataAlgorithm.hpp"
+#include "NX/Common/Range3D.hpp"
+#include "NX/Common/Types.hpp"
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+
+namespace NX::Common
+{
+/**
+ * @brief Number of bytes a tile chosen by TiledRange3D::AutomaticTileExtents touches. Sized to stay resident in L2.
+ */
+inline constexpr usize k_DefaultTileBytes = 256ull * 1024ull;
+
+/**
+ * @class VoxelIndexRange
+ * @brief VoxelIndexRange is an iterable view of the linear indices x + y * dims[0] + z * dims[0] * dims[1] of the voxels
+ * of a Range3D in a grid of size dims, visited with x fastest. Rows are contiguous, so the iterator only does extra
+ * work at the end of each row. forEach() visits the same indices with plain nested loops.
+ */
+class NXCOMMON_EXPORT VoxelIndexRange
+{
+public:
+  /**
+   * @class Iterator
+   * @brief Forward iterator over the linear voxel indices.
+   */
+  class Iterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = usize;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const usize*;
+    using reference = usize;
+
+    Iterator() = default;
+
+    Iterator(const VoxelIndexRange* range, usize index, usize rowEnd, usize y, usize z)
+    : m_Range(range)
+    , m_Index(index)
+    , m_RowEnd(rowEnd)
+    , m_Y(y)
+    , m_Z(z)
+    {
+    }
+
+    usize operator*() const
+    {
+      return m_Index;
+    }
+
+    Iterator& operator++()
+    {
+      m_Index++;
+      if(m_Index == m_RowEnd)
+      {
+        nextRow();
+      }
+      return *this;
+    }
+
+    Iterator operator++(int)
+    {
+      Iterator copy = *this;
+      ++(*this);
+      return copy;
+    }
+
+    bool operator==(const Iterator& rhs) const
+    {
+      return m_Index == rhs.m_Index;
+    }
+
+    bool operator!=(const Iterator& rhs) const
+    {
+      return m_Index != rhs.m_Index;
+    }
+
+  private:
+    void nextRow()
+    {
+      m_Y++;
+      if(m_Y == m_Range->m_Range[3])
+      {
+        m_Y = m_Range->m_Range[2];
+        m_Z++;
+      }
+      m_Index = m_Range->linearIndex(m_Range->m_Range[0], m_Y, m_Z);
+      m_RowEnd = m_Index + (m_Range->m_Range[1] - m_Range->m_Range[0]);
+    }
+
+    const VoxelIndexRange* m_Range = nullptr;
+    usize m_Index = 0;
+    usize m_RowEnd = 0;
+    usize m_Y = 0;
+    usize m_Z = 0;
+  };
+
+  using iterator = Iterator;
+  using const_iterator = Iterator;
+
+  /**
+   * @brief Constructs the view of the voxels of range. range must lie within dims, which is not checked.
+   * @param range
+   * @param dims Grid size as {x, y, z}
+   */
+  VoxelIndexRange(const Range3D& range, const std::array<usize, 3>& dims);
+
+  /**
+   * @brief Returns the number of voxels in the range.
+   * @return usize
+   */
+  usize size() const;
+
+  bool empty() const;
+
+  Iterator begin() const;
+
+  Iterator end() const;
+
+  /**
+   * @brief Calls func(index) for every linear voxel index in iteration order.
+   * @param func
+   */
+  template <class Func>
+  void forEach(Func&& func) const
+  {
+    for(usize z = m_Range[4]; z < m_Range[5]; z++)
+    {
+      for(usize y = m_Range[2]; y < m_Range[3]; y++)
+      {
+        const usize rowStart = linearIndex(0, y, z);
+        for(usize x = m_Range[0]; x < m_Range[1]; x++)
+        {
+          func(rowStart + x);
+        }
+      }
+    }
+  }
+
+private:
+  usize linearIndex(usize x, usize y, usize z) const
+  {
+    return x + y * m_Dims[0] + z * m_Dims[0] * m_Dims[1];
+  }
+
+  Range3D::RangeType m_Range;
+  std::array<usize, 3> m_Dims;
+};
+
+/**
+ * @class TiledRange3D
+ * @brief TiledRange3D splits a Range3D of a voxel grid into bricks of at most tileExtents voxels, so that kernels which
+ * read neighboring rows and slices keep their working set in cache. Tiles are numbered with x fastest, like voxels.
+ * Tiles on the upper faces of the range are truncated to fit.
+ */
+class NXCOMMON_EXPORT TiledRange3D
+{
+public:
+  using TileExtents = std::array<usize, 3>;
+
+  /**
+   * @class Iterator
+   * @brief Forward iterator over the tiles as Range3D.
+   */
+  class Iterator
+  {
+  public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Range3D;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Range3D*;
+    using reference = Range3D;
+
+    Iterator() = default;
+
+    Iterator(const TiledRange3D* tiling, usize index)
+    : m_Tiling(tiling)
+    , m_Index(index)
+    {
+    }
+
+    Range3D operator*() const
+    {
+      return m_Tiling->tile(m_Index);
+    }
+
+    Iterator& operator++()
+    {
+      m_Index++;
+      return *this;
+    }
+
+    Iterator operator++(int)
+    {
+      Iterator copy = *this;
+      m_Index++;
+      return copy;
+    }
+
+    bool operator==(const Iterator& rhs) const
+    {
+      return m_Index == rhs.m_Index;
+    }
+
+    bool operator!=(const Iterator& rhs) const
+    {
+      return m_Index != rhs.m_Index;
+    }
+
+  private:
+    const TiledRange3D* m_Tiling = nullptr;
+    usize m_Index = 0;
+  };
+
+  using iterator = Iterator;
+  using const_iterator = Iterator;
+
+  /**
+   * @brief Tiles range with the given extents. A zero extent covers the whole range along that axis.
+   * Throws std::runtime_error if range does not lie within dims.
+   * @param range
+   * @param dims Grid size as {x, y, z}
+   * @param tileExtents Tile size as {x, y, z}
+   */
+  TiledRange3D(const Range3D& range, const std::array<usize, 3>& dims, const TileExtents& tileExtents);
+
+  /**
+   * @brief Tiles range with AutomaticTileExtents(range, bytesPerVoxel).
+   * Throws std::runtime_error if range does not lie within dims.
+   * @param range
+   * @param dims Grid size as {x, y, z}
+   * @param bytesPerVoxel Number of bytes the kernel reads and writes per voxel, summed over all of its arrays
+   */
+  TiledRange3D(const Range3D& range, const std::array<usize, 3>& dims, usize bytesPerVoxel);
+
+  /**
+   * @brief Returns tile extents for range whose tiles touch about tileBytes bytes. Tiles are made of long runs along x
+   * for the hardware prefetchers, cut so that at least an 8 x 8 cross section in y and z remains for neighbor access, and
+   * roughly square in y and z.
+   * @param range
+   * @param bytesPerVoxel
+   * @param tileBytes
+   * @return TileExtents
+   */
+  static TileExtents AutomaticTileExtents(const Range3D& range, usize bytesPerVoxel, usize tileBytes = k_DefaultTileBytes);
+
+  const Range3D& range() const;
+
+  const std::array<usize, 3>& dims() const;
+
+  const TileExtents& tileExtents() const;
+
+  /**
+   * @brief Returns the number of tiles along x, y and z.
+   * @return std::array<usize, 3>
+   */
+  std::array<usize, 3> numTilesPerAxis() const;
+
+  /**
+   * @brief Returns the total number of tiles.
+   * @return usize
+   */
+  usize numTiles() const;
+
+  /**
+   * @brief Returns the tile with the given index. Throws std::runtime_error if index is out of bounds.
+   * @param index
+   * @return Range3D
+   */
+  Range3D tile(usize index) const;
+
+  /**
+   * @brief Returns the linear voxel indices of the tile with the given index.
+   * @param index
+   * @return VoxelIndexRange
+   */
+  VoxelIndexRange voxelIndices(usize index) const;
+
+  Iterator begin() const;
+
+  Iterator end() const;
+
+  /**
+   * @brief Calls body(tile) for every tile, running tiles in parallel through ParallelDataAlgorithm.
+   * @param body Callable as body(const Range3D&)
+   */
+  template <class Body>
+  void execute(const Body& body) const
+  {
+    ParallelDataAlgorithm algorithm(Range(0, numTiles()));
+    algorithm.setGrain(1);
+    algorithm.execute([this, &body](const Range& tiles) {
+      for(usize i = tiles.min(); i < tiles.max(); i++)
+      {
+        body(tile(i));
+      }
+    });
+  }
+
+private:
+  Range3D m_Range;
+  std::array<usize, 3> m_Dims;
+  TileExtents m_TileExtents;
+  std::array<usize, 3> m_NumTiles;
+};
+} // namespace NX::Common
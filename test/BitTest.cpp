@@ -1,6 +1,10 @@
 #include <catch2/catch.hpp>
 
 #include "NX/Common/Bit.hpp"
+#include "NX/Common/Byteswap.hpp"
+
+#include <numeric>
+#include <vector>
 
 using namespace NX;
 using namespace NX::Common;
@@ -64,3 +68,51 @@ TEST_CASE("BitTest")
     REQUIRE(swapped == expected);
   }
 }
+
+namespace
+{
+template <class T>
+void TestBulkByteswap(usize size)
+{
+  std::vector<T> values(size);
+  for(usize i = 0; i < size; i++)
+  {
+    values[i] = static_cast<T>(i * 2654435761ull);
+  }
+
+  std::vector<T> expected(size);
+  for(usize i = 0; i < size; i++)
+  {
+    expected[i] = byteswap(values[i]);
+  }
+
+  std::vector<T> swapped = values;
+  BulkByteswap(nonstd::span<T>(swapped));
+  REQUIRE(swapped == expected);
+
+  std::vector<T> copied(size);
+  BulkByteswap<T>(nonstd::span<const T>(swapped), nonstd::span<T>(copied));
+  REQUIRE(copied == values);
+}
+} // namespace
+
+TEST_CASE("BulkByteswapTest")
+{
+  // Sizes are chosen to cover the scalar tail of each SIMD width and the parallel path
+  const std::vector<usize> sizes = {0, 1, 3, 7, 17, 33, 65, 1000, (1ull << 20) + 3};
+  for(usize size : sizes)
+  {
+    TestBulkByteswap<int16>(size);
+    TestBulkByteswap<uint16>(size);
+    TestBulkByteswap<int32>(size);
+    TestBulkByteswap<uint32>(size);
+    TestBulkByteswap<int64>(size);
+    TestBulkByteswap<uint64>(size);
+  }
+
+  std::vector<float32> floats = {1.0f, -2.5f, 3.25f};
+  std::vector<float32> swappedFloats = floats;
+  BulkByteswap(nonstd::span<float32>(swappedFloats));
+  BulkByteswap(nonstd::span<float32>(swappedFloats));
+  REQUIRE(swappedFloats == floats);
+}
@@ -0,0 +1,185 @@
+#include <catch2/catch.hpp>
+
+#include "NX/Common/BitVector.hpp"
+#include "NX/Common/DataVector.hpp"
+
+#include <algorithm>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace NX;
+using namespace NX::Common;
+
+namespace
+{
+std::vector<uint8> RandomBytes(usize size, uint64 seed)
+{
+  std::mt19937_64 generator(seed);
+  std::vector<uint8> values(size);
+  for(uint8& value : values)
+  {
+    // Mostly 0 and 1 but also other nonzero values, which count as set
+    const uint64 random = generator();
+    value = static_cast<uint8>(random % 3 == 0 ? random >> 8 : random % 2);
+  }
+  return values;
+}
+
+usize CountNonzero(const std::vector<uint8>& values)
+{
+  return static_cast<usize>(std::count_if(values.begin(), values.end(), [](uint8 value) { return value != 0; }));
+}
+} // namespace
+
+TEST_CASE("BitVectorTest")
+{
+  SECTION("element access")
+  {
+    BitVector bits(70);
+    REQUIRE(bits.size() == 70);
+    REQUIRE(bits.numWords() == 2);
+    REQUIRE(bits.none());
+
+    bits[3] = true;
+    bits.set(64);
+    bits[69] = bits[3];
+    REQUIRE(bits.test(3));
+    REQUIRE(bits[64]);
+    REQUIRE(bits.at(69));
+    REQUIRE_FALSE(bits[4]);
+    REQUIRE(bits.count() == 3);
+    REQUIRE(bits.words()[1] == 0b100001);
+    REQUIRE_THROWS_AS(bits.at(70), std::runtime_error);
+
+    bits.flip(3);
+    bits[64].flip();
+    bits.reset(69);
+    REQUIRE(bits.none());
+
+    std::fill(bits.begin() + 10, bits.begin() + 20, true);
+    REQUIRE(bits.count() == 10);
+    REQUIRE(std::count(bits.cbegin(), bits.cend(), true) == 10);
+    REQUIRE(bits.end() - bits.begin() == 70);
+    const BitVector& constBits = bits;
+    REQUIRE(std::find(constBits.begin(), constBits.end(), true) - constBits.begin() == 10);
+  }
+
+  SECTION("bulk operations")
+  {
+    BitVector bits(130, true);
+    REQUIRE(bits.all());
+    REQUIRE(bits.count() == 130);
+    REQUIRE(bits.words()[2] == 0b11);
+
+    bits.flip();
+    REQUIRE(bits.none());
+    REQUIRE(bits.words()[2] == 0);
+
+    bits.setRange(5, 5, true);
+    REQUIRE(bits.none());
+    bits.setRange(3, 7, true);
+    bits.setRange(60, 129, true);
+    REQUIRE(bits.count() == 4 + 69);
+    REQUIRE_FALSE(bits[59]);
+    REQUIRE(bits[60]);
+    REQUIRE(bits[128]);
+    REQUIRE_FALSE(bits[129]);
+    bits.setRange(62, 127, false);
+    REQUIRE(bits.count() == 4 + 2 + 2);
+    REQUIRE_THROWS_AS(bits.setRange(0, 131, true), std::out_of_range);
+    REQUIRE_THROWS_AS(bits.setRange(7, 3, true), std::out_of_range);
+    bits.setRange(130, 130, true);
+    REQUIRE(bits.count() == 4 + 2 + 2);
+
+    BitVector other(130);
+    other.setRange(0, 65, true);
+    REQUIRE((bits & other).count() == 4 + 2);
+    REQUIRE((bits | other).count() == 65 + 2);
+    REQUIRE((bits ^ other).count() == 65 - 6 + 2);
+    REQUIRE((~other).count() == 65);
+    REQUIRE((~other | other).all());
+    REQUIRE(((bits ^ other) ^ other) == bits);
+    REQUIRE_THROWS_AS(bits &= BitVector(129), std::invalid_argument);
+
+    bits.resize(200, true);
+    REQUIRE(bits.count() == 8 + 70);
+    bits.resize(61);
+    REQUIRE(bits.count() == 4 + 1);
+    REQUIRE(bits.words()[0] == ((1ull << 7) - (1ull << 3)) + (1ull << 60));
+    bits.resize(130);
+    REQUIRE(bits.count() == 5);
+
+    bits.set();
+    REQUIRE(bits.count() == 130);
+    bits.reset();
+    REQUIRE(bits.none());
+    REQUIRE(BitVector().all());
+  }
+
+  SECTION("find")
+  {
+    BitVector bits(1000);
+    REQUIRE(bits.findFirst() == bits.size());
+
+    const std::vector<uint64> setIndices = {0, 63, 64, 65, 127, 500, 999};
+    for(uint64 index : setIndices)
+    {
+      bits.set(index);
+    }
+    std::vector<uint64> found;
+    for(uint64 index = bits.findFirst(); index < bits.size(); index = bits.findNext(index))
+    {
+      found.push_back(index);
+    }
+    REQUIRE(found == setIndices);
+    REQUIRE(bits.findNext(999) == bits.size());
+    REQUIRE(bits.findNext(5000) == bits.size());
+  }
+
+  SECTION("pack and unpack")
+  {
+    for(usize size : {0, 1, 63, 64, 65, 200, 1000, 1000003})
+    {
+      const std::vector<uint8> values = RandomBytes(size, size);
+      BitVector bits = BitVector::Pack(nonstd::span<const uint8>(values));
+      REQUIRE(bits.size() == size);
+      REQUIRE(bits.count() == CountNonzero(values));
+
+      usize numMismatches = 0;
+      for(usize i = 0; i < size; i++)
+      {
+        if(bits[i] != (values[i] != 0))
+        {
+          numMismatches++;
+        }
+      }
+      REQUIRE(numMismatches == 0);
+
+      std::vector<uint8> unpacked(size);
+      bits.unpack(nonstd::span<uint8>(unpacked));
+      for(usize i = 0; i < size; i++)
+      {
+        if(unpacked[i] != (values[i] != 0 ? 1 : 0))
+        {
+          numMismatches++;
+        }
+      }
+      REQUIRE(numMismatches == 0);
+
+      // DataVector<bool> rather than std::vector<bool> so the values are contiguous
+      DataVector<bool> mask(size);
+      bits.unpack(mask.createSpan());
+      REQUIRE(BitVector::Pack(mask.createSpan()) == bits);
+
+      if(size > 0)
+      {
+        bits.flip();
+        REQUIRE(bits.count() == size - CountNonzero(values));
+      }
+    }
+
+    std::vector<uint8> tooSmall(3);
+    REQUIRE_THROWS_AS(BitVector(4).unpack(nonstd::span<uint8>(tooSmall)), std::invalid_argument);
+  }
+}
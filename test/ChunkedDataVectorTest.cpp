@@ -0,0 +1,264 @@
+#include <catch2/catch.hpp>
+
+#include "NX/Common/ChunkedDataVector.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace NX;
+using namespace NX::Common;
+
+namespace
+{
+/**
+ * @brief Stores nothing and blocks reading chunk 1 until opened. Reading chunk 2 fails the first time.
+ */
+class GatedStore : public ChunkStore
+{
+public:
+  void readChunk(usize chunkIndex, nonstd::span<std::byte> buffer) override
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    if(chunkIndex == 2 && !std::exchange(m_FailedOnce, true))
+    {
+      throw std::runtime_error("GatedStore: read failed");
+    }
+    if(chunkIndex == 1)
+    {
+      m_Reading = true;
+      m_Condition.notify_all();
+      m_Condition.wait(lock, [this] { return m_Open; });
+    }
+    std::fill(buffer.begin(), buffer.end(), static_cast<std::byte>(chunkIndex));
+  }
+
+  void writeChunk(usize, nonstd::span<const std::byte>) override
+  {
+  }
+
+  usize storedBytes() const override
+  {
+    return 0;
+  }
+
+  void waitForReading()
+  {
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Condition.wait(lock, [this] { return m_Reading; });
+  }
+
+  void open()
+  {
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    m_Open = true;
+    m_Condition.notify_all();
+  }
+
+private:
+  std::mutex m_Mutex;
+  std::condition_variable m_Condition;
+  bool m_Reading = false;
+  bool m_Open = false;
+  bool m_FailedOnce = false;
+};
+} // namespace
+
+TEST_CASE("ChunkedDataVectorTest")
+{
+  constexpr usize k_NumElements = 10000;
+  constexpr usize k_ChunkSize = 1000;
+  constexpr usize k_Budget = 3 * k_ChunkSize * sizeof(int64);
+
+  SECTION("layout")
+  {
+    ChunkedDataVector<int64> vector(k_NumElements + 1, k_Budget, k_ChunkSize);
+    REQUIRE(vector.size() == k_NumElements + 1);
+    REQUIRE(vector.chunkSize() == k_ChunkSize);
+    REQUIRE(vector.numChunks() == 11);
+    REQUIRE(vector.chunkElementCount(0) == k_ChunkSize);
+    REQUIRE(vector.chunkElementCount(10) == 1);
+    REQUIRE(vector.getValue(k_NumElements) == 0);
+    REQUIRE_THROWS(vector.getValue(k_NumElements + 1));
+    REQUIRE(ChunkedDataVector<float32>::DefaultChunkSize() == ChunkedDataVector<float32>::k_DefaultChunkBytes / sizeof(float32));
+  }
+  SECTION("write back")
+  {
+    ChunkedDataVector<int64> vector(k_NumElements, k_Budget, k_ChunkSize);
+    vector.forEachChunk([](nonstd::span<int64> chunk, uint64 offset) { std::iota(chunk.begin(), chunk.end(), static_cast<int64>(offset)); });
+
+    // Only the budget is resident and evicted chunks were written to the scratch file
+    const ChunkCache& cache = vector.cache();
+    REQUIRE(cache.residentBytes() <= k_Budget);
+    REQUIRE(cache.numWriteBacks() == 7);
+    REQUIRE(cache.storedBytes() == 7 * k_ChunkSize * sizeof(int64));
+
+    const ChunkedDataVector<int64>& constVector = vector;
+    int64 sum = 0;
+    constVector.forEachChunk([&sum](nonstd::span<const int64> chunk, uint64) { sum = std::accumulate(chunk.begin(), chunk.end(), sum); });
+    REQUIRE(sum == static_cast<int64>(k_NumElements * (k_NumElements - 1) / 2));
+    REQUIRE(cache.residentBytes() <= k_Budget);
+
+    // Reading evicts the last written chunks but does not dirty any, so a second pass writes nothing back
+    REQUIRE(cache.numWriteBacks() == 10);
+    constVector.forEachChunk([](nonstd::span<const int64>, uint64) {});
+    REQUIRE(cache.numWriteBacks() == 10);
+    REQUIRE(constVector.getValue(1234) == 1234);
+
+    vector.setValue(9999, -1);
+    vector.flush();
+    REQUIRE(vector.getValue(9999) == -1);
+    REQUIRE(cache.storedBytes() == k_NumElements * sizeof(int64));
+  }
+  SECTION("pinned chunks")
+  {
+    ChunkedDataVector<int64> vector(k_NumElements, k_Budget, k_ChunkSize);
+    std::vector<ChunkedDataVector<int64>::Chunk<int64>> chunks;
+    for(usize i = 0; i < 5; i++)
+    {
+      chunks.push_back(vector.acquireChunk(i));
+      chunks.back().span()[0] = static_cast<int64>(i) + 1;
+    }
+    // Pinned chunks are never evicted, even past the budget
+    REQUIRE(vector.cache().residentBytes() == 5 * k_ChunkSize * sizeof(int64));
+    chunks.clear();
+
+    vector.fill(3);
+    for(usize i = 0; i < vector.numChunks(); i++)
+    {
+      REQUIRE(vector.getValue(i * k_ChunkSize) == 3);
+    }
+    REQUIRE(vector.cache().residentBytes() <= k_Budget);
+  }
+}
+
+TEST_CASE("ChunkedDataVectorTest: cache")
+{
+  constexpr usize k_ChunkBytes = 64;
+  auto store = std::make_unique<GatedStore>();
+  GatedStore& gate = *store;
+  ChunkCache cache(std::move(store), k_ChunkBytes, 4, 2 * k_ChunkBytes);
+
+  SECTION("loads outside the lock")
+  {
+    std::byte* first = cache.pin(0, false);
+    std::thread loader([&cache]() {
+      cache.pin(1, false);
+      cache.unpin(1);
+    });
+    gate.waitForReading();
+
+    // Chunk 1 is still being read, which must not keep the resident chunk 0 from being pinned
+    REQUIRE(cache.pin(0, true) == first);
+    cache.unpin(0);
+    cache.unpin(0);
+    REQUIRE(cache.residentBytes() == 2 * k_ChunkBytes);
+
+    gate.open();
+    loader.join();
+    REQUIRE(cache.numLoads() == 2);
+    REQUIRE(cache.pin(1, false)[0] == std::byte{1});
+    cache.unpin(1);
+  }
+  SECTION("failed loads")
+  {
+    gate.open();
+    REQUIRE_THROWS_AS(cache.pin(2, false), std::runtime_error);
+    REQUIRE(cache.residentBytes() == 0);
+    REQUIRE(cache.pin(2, false)[0] == std::byte{2});
+    cache.unpin(2);
+    REQUIRE(cache.numLoads() == 1);
+
+    // Buffers of evicted chunks are reused rather than adding to the budget
+    for(usize i = 0; i < 4; i++)
+    {
+      cache.pin(i, true);
+      cache.unpin(i);
+      REQUIRE(cache.residentBytes() <= 2 * k_ChunkBytes);
+    }
+    REQUIRE(cache.numWriteBacks() == 2);
+  }
+}
+
+TEST_CASE("ChunkedDataVectorTest: compressed")
+{
+  SECTION("codec")
+  {
+    std::vector<int32> values(1001);
+    for(usize i = 0; i < values.size(); i++)
+    {
+      values[i] = static_cast<int32>(i / 100) * 0x01010101 + static_cast<int32>(i % 3);
+    }
+    const auto source = nonstd::as_bytes(nonstd::span<const int32>(values.data(), values.size()));
+    for(usize elementSize : {1, 2, 4, 8, 3})
+    {
+      std::vector<std::byte> compressed;
+      detail::ShuffleRleCompress(source, elementSize, compressed);
+      std::vector<std::byte> result(source.size());
+      detail::ShuffleRleDecompress(compressed, elementSize, result);
+      REQUIRE(std::equal(result.begin(), result.end(), source.begin()));
+
+      if(elementSize == 4)
+      {
+        REQUIRE(compressed.size() < source.size() / 2);
+      }
+    }
+
+    std::vector<std::byte> compressed;
+    detail::ShuffleRleCompress(source, 4, compressed);
+    std::vector<std::byte> tooSmall(source.size() - 1);
+    REQUIRE_THROWS(detail::ShuffleRleDecompress(compressed, 4, tooSmall));
+    compressed.pop_back();
+    std::vector<std::byte> result(source.size());
+    REQUIRE_THROWS(detail::ShuffleRleDecompress(compressed, 4, result));
+  }
+  SECTION("feature ids")
+  {
+    constexpr usize k_NumElements = 1000000;
+    constexpr usize k_ChunkSize = 65536;
+    auto vector = ChunkedDataVector<int32>::Compressed(k_NumElements, 2 * k_ChunkSize * sizeof(int32), k_ChunkSize);
+    REQUIRE(vector.uncompressedBytes() == k_NumElements * sizeof(int32));
+    vector.forEachChunk([](nonstd::span<int32> chunk, uint64 offset) {
+      for(usize i = 0; i < chunk.size(); i++)
+      {
+        chunk[i] = static_cast<int32>((offset + i) / 5000);
+      }
+    });
+    vector.flush();
+    REQUIRE(vector.storedBytes() * 10 < vector.uncompressedBytes());
+    REQUIRE(vector.cache().residentBytes() <= 2 * k_ChunkSize * sizeof(int32));
+
+    for(usize index : {0, 4999, 5000, 123456, 999999})
+    {
+      REQUIRE(vector.getValue(index) == static_cast<int32>(index / 5000));
+    }
+
+    // Incompressible data is stored as is
+    auto noise = ChunkedDataVector<uint32>::Compressed(4096, 4096, 1024);
+    uint32 state = 1;
+    noise.forEachChunk([&state](nonstd::span<uint32> chunk, uint64) {
+      for(uint32& value : chunk)
+      {
+        state = state * 1664525u + 1013904223u;
+        value = state;
+      }
+    });
+    noise.flush();
+    REQUIRE(noise.storedBytes() <= noise.uncompressedBytes());
+    state = 1;
+    usize numMismatches = 0;
+    noise.forEachChunk([&state, &numMismatches](nonstd::span<uint32> chunk, uint64) {
+      for(uint32 value : chunk)
+      {
+        state = state * 1664525u + 1013904223u;
+        numMismatches += value != state ? 1 : 0;
+      }
+    });
+    REQUIRE(numMismatches == 0);
+  }
+}
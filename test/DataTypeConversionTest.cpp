@@ -0,0 +1,143 @@
+#include <catch2/catch.hpp>
+
+#include "NX/Common/DataTypeConversion.hpp"
+#include "NX/Common/DataTypeDispatch.hpp"
+#include "NX/Common/DataVector.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace NX;
+using namespace NX::Common;
+
+namespace
+{
+template <class U, class T>
+std::vector<U> Convert(const std::vector<T>& source, ConversionMode mode)
+{
+  // DataVector rather than std::vector so that bool destinations are contiguous
+  DataVector<U> destination(source.size());
+  ConvertValues(nonstd::span<const T>(source), destination.createSpan(), mode);
+  return std::vector<U>(destination.begin(), destination.end());
+}
+
+/**
+ * @brief Converts a whole array, which goes through the SIMD kernels, and every value on its own, which goes through
+ * the scalar tail, and requires both to match bit for bit.
+ */
+struct CheckVectorMatchesScalar
+{
+  template <class T, class U>
+  void operator()(const std::vector<float64>& values, ConversionMode mode) const
+  {
+    DataVector<T> source(values.size());
+    ConvertValues(nonstd::span<const float64>(values), source.createSpan(), ConversionMode::Truncate);
+    DataVector<U> vectorized(source.size());
+    ConvertValues(source.createSpan(), vectorized.createSpan(), mode);
+    usize numMismatches = 0;
+    for(usize i = 0; i < source.size(); i++)
+    {
+      U scalar = {};
+      ConvertValues(nonstd::span<const T>(&source[i], 1), nonstd::span<U>(&scalar, 1), mode);
+      if(std::memcmp(&scalar, &vectorized[i], sizeof(U)) != 0)
+      {
+        numMismatches++;
+      }
+    }
+    REQUIRE(numMismatches == 0);
+  }
+};
+} // namespace
+
+TEST_CASE("DataTypeConversionTest")
+{
+  constexpr float64 k_Nan = std::numeric_limits<float64>::quiet_NaN();
+  constexpr float64 k_Infinity = std::numeric_limits<float64>::infinity();
+
+  SECTION("modes")
+  {
+    std::vector<float32> floats = {-1.5f, -0.6f, 0.5f, 1.5f, 2.5f, 254.6f, 255.4f, 300.0f, std::numeric_limits<float32>::quiet_NaN()};
+    REQUIRE(Convert<uint8>(floats, ConversionMode::Truncate) == std::vector<uint8>{0, 0, 0, 1, 2, 254, 255, 255, 0});
+    REQUIRE(Convert<uint8>(floats, ConversionMode::Saturate) == std::vector<uint8>{0, 0, 0, 1, 2, 254, 255, 255, 0});
+    REQUIRE(Convert<uint8>(floats, ConversionMode::RoundSaturate) == std::vector<uint8>{0, 0, 0, 2, 2, 255, 255, 255, 0});
+    REQUIRE(Convert<int8>(floats, ConversionMode::RoundSaturate) == std::vector<int8>{-2, -1, 0, 2, 2, 127, 127, 127, 0});
+    for(ConversionMode mode : {ConversionMode::Truncate, ConversionMode::Saturate, ConversionMode::RoundSaturate})
+    {
+      // NaN is nonzero, so it converts to true rather than following the integer conversions to 0
+      REQUIRE(Convert<bool>(floats, mode) == std::vector<bool>{true, true, true, true, true, true, true, true, true});
+      REQUIRE(Convert<bool>(std::vector<float64>{0.0, -0.0, k_Nan}, mode) == std::vector<bool>{false, false, true});
+    }
+
+    std::vector<int32> ints = {-70000, -1, 0, 255, 256, 70000};
+    REQUIRE(Convert<uint8>(ints, ConversionMode::Truncate) == std::vector<uint8>{144, 255, 0, 255, 0, 112});
+    REQUIRE(Convert<uint8>(ints, ConversionMode::Saturate) == std::vector<uint8>{0, 0, 0, 255, 255, 255});
+    REQUIRE(Convert<int16>(ints, ConversionMode::Saturate) == std::vector<int16>{-32768, -1, 0, 255, 256, 32767});
+    REQUIRE(Convert<bool>(ints, ConversionMode::Saturate) == std::vector<bool>{true, true, false, true, true, true});
+
+    std::vector<uint64> largeUnsigned = {std::numeric_limits<uint64>::max(), 5};
+    REQUIRE(Convert<int64>(largeUnsigned, ConversionMode::Saturate) == std::vector<int64>{std::numeric_limits<int64>::max(), 5});
+
+    std::vector<float64> doubles = {1.0e300, -1.0e300, k_Infinity, 1.0e19, -1.0e19, 3.0e9};
+    std::vector<float32> truncated = Convert<float32>(doubles, ConversionMode::Truncate);
+    REQUIRE(std::isinf(truncated[0]));
+    std::vector<float32> saturated = Convert<float32>(doubles, ConversionMode::Saturate);
+    REQUIRE(saturated[0] == std::numeric_limits<float32>::max());
+    REQUIRE(saturated[1] == std::numeric_limits<float32>::lowest());
+    REQUIRE(std::isinf(saturated[2]));
+    REQUIRE(Convert<int64>(doubles, ConversionMode::Saturate) ==
+            std::vector<int64>{std::numeric_limits<int64>::max(), std::numeric_limits<int64>::lowest(), std::numeric_limits<int64>::max(), std::numeric_limits<int64>::max(),
+                               std::numeric_limits<int64>::lowest(), 3000000000});
+    REQUIRE(Convert<uint32>(doubles, ConversionMode::Saturate)[5] == 3000000000u);
+    REQUIRE(Convert<int32>(doubles, ConversionMode::Saturate)[5] == std::numeric_limits<int32>::max());
+  }
+
+  SECTION("vectorized matches scalar")
+  {
+    std::vector<float64> values = {k_Nan,   -k_Infinity, k_Infinity, -1.0e10, 1.0e10,  2147483648.0, 2147483520.0, -2147483648.0, -2147483904.0, -0.6, 0.5,
+                                   1.5,     2.5,         -2.5,       254.6,   255.4,   256.0,        -128.5,       -129.0,        32767.5,       -32768.5, 65535.4,
+                                   65535.6, 1.0e300,     -1.0e300,   3.4e38,  3.5e38,  -3.5e38,      1.0e-40,      -0.0};
+    std::mt19937_64 generator(3);
+    std::uniform_real_distribution<float64> distribution(-70000.0, 70000.0);
+    for(usize i = 0; i < 1000; i++)
+    {
+      values.push_back(distribution(generator));
+    }
+    for(ConversionMode mode : {ConversionMode::Truncate, ConversionMode::Saturate, ConversionMode::RoundSaturate})
+    {
+      for(DataType source : {DataType::float32, DataType::float64, DataType::int8, DataType::uint8, DataType::int16, DataType::uint16, DataType::int32})
+      {
+        for(DataType destination : GetAllDataTypes())
+        {
+          DispatchDataTypes(source, destination, CheckVectorMatchesScalar{}, values, mode);
+        }
+      }
+    }
+  }
+
+  SECTION("large arrays")
+  {
+    DataVector<uint16> source(1000003);
+    for(usize i = 0; i < source.size(); i++)
+    {
+      source[i] = static_cast<uint16>(i * 7);
+    }
+    DataVector<float32> destination(source.size());
+    ConvertValues(DataType::uint16, source.data(), DataType::float32, destination.data(), source.size());
+    usize numMismatches = 0;
+    for(usize i = 0; i < source.size(); i++)
+    {
+      if(destination[i] != static_cast<float32>(source[i]))
+      {
+        numMismatches++;
+      }
+    }
+    REQUIRE(numMismatches == 0);
+
+    std::vector<int32> small(3);
+    REQUIRE_THROWS_AS(ConvertValues(destination.createSpan(), nonstd::span<int32>(small)), std::invalid_argument);
+  }
+}
@@ -0,0 +1,88 @@
+#include <catch2/catch.hpp>
+
+#include "NX/Common/DataTypeDispatch.hpp"
+#include "NX/Common/DataVector.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+using namespace NX;
+using namespace NX::Common;
+
+namespace
+{
+struct TypeName
+{
+  template <class T>
+  std::string operator()() const
+  {
+    return std::string(DataTypeToString(GetDataType<T>()).view());
+  }
+};
+
+struct FillVector
+{
+  template <class T>
+  usize operator()(std::shared_ptr<void>& storage, usize size, int32 value)
+  {
+    auto vector = std::make_shared<DataVector<T>>(size, static_cast<T>(value));
+    storage = vector;
+    return sizeof(T);
+  }
+};
+
+struct ConvertValue
+{
+  template <class T, class U>
+  bool operator()(float64 value, DataType& sourceType, DataType& destinationType) const
+  {
+    sourceType = GetDataType<T>();
+    destinationType = GetDataType<U>();
+    return static_cast<U>(static_cast<T>(value)) == static_cast<U>(value);
+  }
+};
+} // namespace
+
+TEST_CASE("DataTypeDispatchTest")
+{
+  SECTION("single type")
+  {
+    for(DataType dataType : GetAllDataTypes())
+    {
+      REQUIRE(DispatchDataType(dataType, TypeName{}) == DataTypeToString(dataType).view());
+    }
+    REQUIRE(std::is_same_v<DataTypeToType<DataType::uint16>, uint16>);
+    REQUIRE(std::is_same_v<DataTypeToType<DataType::boolean>, bool>);
+
+    std::shared_ptr<void> storage;
+    FillVector fill;
+    REQUIRE(DispatchDataType(DataType::float64, fill, storage, 5, 3) == sizeof(float64));
+    auto vector = std::static_pointer_cast<DataVector<float64>>(storage);
+    REQUIRE(vector->size() == 5);
+    REQUIRE((*vector)[4] == 3.0);
+
+    REQUIRE_THROWS_AS(DispatchDataType(static_cast<DataType>(k_NumDataTypes), TypeName{}), std::runtime_error);
+  }
+
+  SECTION("two types")
+  {
+    for(DataType source : GetAllDataTypes())
+    {
+      for(DataType destination : GetAllDataTypes())
+      {
+        DataType dispatchedSource = DataType::boolean;
+        DataType dispatchedDestination = DataType::boolean;
+        REQUIRE(DispatchDataTypes(source, destination, ConvertValue{}, 1.0, dispatchedSource, dispatchedDestination));
+        REQUIRE(dispatchedSource == source);
+        REQUIRE(dispatchedDestination == destination);
+      }
+    }
+    DataType source = DataType::boolean;
+    DataType destination = DataType::boolean;
+    // 2.5 is in range for uint8 but loses its fraction there
+    REQUIRE_FALSE(DispatchDataTypes(DataType::uint8, DataType::float64, ConvertValue{}, 2.5, source, destination));
+    REQUIRE(source == DataType::uint8);
+    REQUIRE(destination == DataType::float64);
+  }
+}
@@ -0,0 +1,473 @@
+#include <catch2/catch.hpp>
+
+#include "NX/Common/DataVector.hpp"
+#include "NX/Common/DataVectorStream.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace NX;
+using namespace NX::Common;
+
+namespace
+{
+std::filesystem::path WriteTestFile(const std::string& name, const std::vector<int32>& values)
+{
+  std::filesystem::path path = std::filesystem::temp_directory_path() / name;
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(int32)));
+  return path;
+}
+
+int OpenFile(const std::filesystem::path& path, bool write)
+{
+#ifdef _WIN32
+  return _wopen(path.c_str(), write ? (_O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY) : (_O_RDONLY | _O_BINARY), _S_IREAD | _S_IWRITE);
+#else
+  return ::open(path.c_str(), write ? (O_WRONLY | O_CREAT | O_TRUNC) : O_RDONLY, 0644);
+#endif
+}
+
+void CloseFile(int fileDescriptor)
+{
+#ifdef _WIN32
+  _close(fileDescriptor);
+#else
+  ::close(fileDescriptor);
+#endif
+}
+} // namespace
+
+TEST_CASE("DataVectorTest")
+{
+  SECTION("heap storage")
+  {
+    DataVector<int32> vector(5);
+    REQUIRE(vector.size() == 5);
+    REQUIRE_FALSE(vector.isFileBacked());
+    for(usize i = 0; i < vector.size(); i++)
+    {
+      REQUIRE(vector[i] == 0);
+      vector[i] = static_cast<int32>(i);
+    }
+
+    DataVector<int32> copy = vector;
+    vector.resize(3);
+    REQUIRE(vector.size() == 3);
+    REQUIRE(copy.size() == 5);
+    for(usize i = 0; i < vector.size(); i++)
+    {
+      REQUIRE(vector[i] == copy[i]);
+    }
+  }
+  SECTION("initialization modes")
+  {
+    constexpr usize k_LargeSize = 1ull << 18;
+
+    DataVector<float32> uninitialized(k_LargeSize, InitializationMode::Uninitialized);
+    REQUIRE(uninitialized.size() == k_LargeSize);
+    uninitialized.fill(1.5f);
+    REQUIRE(std::all_of(uninitialized.begin(), uninitialized.end(), [](float32 value) { return value == 1.5f; }));
+
+    DataVector<float32> parallel(k_LargeSize, InitializationMode::ParallelFill);
+    REQUIRE(std::all_of(parallel.begin(), parallel.end(), [](float32 value) { return value == 0.0f; }));
+
+    DataVector<uint8> filled(k_LargeSize, uint8{7});
+    REQUIRE(std::all_of(filled.begin(), filled.end(), [](uint8 value) { return value == 7; }));
+
+    // A literal 0 is a fill value, not a null MemoryResource
+    DataVector<float32> zeros(10, 0);
+    REQUIRE(zeros.size() == 10);
+    REQUIRE(zeros.memoryResource() == GetDefaultMemoryResource());
+    REQUIRE(std::all_of(zeros.begin(), zeros.end(), [](float32 value) { return value == 0.0f; }));
+
+    filled.resize(k_LargeSize * 2, InitializationMode::ParallelFill);
+    REQUIRE(filled[k_LargeSize - 1] == 7);
+    REQUIRE(std::all_of(filled.begin() + k_LargeSize, filled.end(), [](uint8 value) { return value == 0; }));
+
+    filled.resize(k_LargeSize * 3, InitializationMode::Uninitialized);
+    REQUIRE(filled.size() == k_LargeSize * 3);
+    REQUIRE(filled[k_LargeSize * 2 - 1] == 0);
+  }
+  SECTION("capacity")
+  {
+    DataVector<int32> vector(4);
+    REQUIRE(vector.capacity() == 4);
+    for(usize i = 0; i < vector.size(); i++)
+    {
+      vector[i] = static_cast<int32>(i);
+    }
+
+    const int32* originalData = vector.data();
+    vector.resize(2);
+    REQUIRE(vector.size() == 2);
+    REQUIRE(vector.capacity() == 4);
+    REQUIRE(vector.data() == originalData);
+
+    vector.resize(3);
+    REQUIRE(vector.data() == originalData);
+    REQUIRE(vector[2] == 0);
+
+    vector.resize(5);
+    REQUIRE(vector.capacity() >= 6);
+    REQUIRE(vector[1] == 1);
+    REQUIRE(vector[4] == 0);
+
+    vector.reserve(100);
+    REQUIRE(vector.capacity() == 100);
+    REQUIRE(vector.size() == 5);
+    const int32* reservedData = vector.data();
+    for(usize i = 0; i < 95; i++)
+    {
+      vector.resize(vector.size() + 1);
+    }
+    REQUIRE(vector.data() == reservedData);
+
+    vector.shrink_to_fit();
+    REQUIRE(vector.capacity() == 100);
+    vector.resize(10);
+    vector.shrink_to_fit();
+    REQUIRE(vector.capacity() == 10);
+    REQUIRE(vector[1] == 1);
+
+    DataVector<int32> other(20);
+    other = vector;
+    REQUIRE(other.size() == 10);
+    REQUIRE(other.capacity() == 20);
+    REQUIRE(other[1] == 1);
+  }
+  SECTION("external buffers")
+  {
+    std::vector<int32> deleted;
+
+    // Custom deleter through unique_ptr
+    {
+      auto deleter = [&deleted](int32* ptr) {
+        deleted.push_back(ptr[0]);
+        delete[] ptr;
+      };
+      std::unique_ptr<int32[], decltype(deleter)> buffer(new int32[4]{1, 2, 3, 4}, deleter);
+      int32* raw = buffer.get();
+      DataVector<int32> vector(4, std::move(buffer));
+      REQUIRE(vector.data() == raw);
+      REQUIRE(vector[3] == 4);
+      REQUIRE_FALSE(vector.isView());
+      DataVector<int32> moved(std::move(vector));
+      REQUIRE(deleted.empty());
+    }
+    REQUIRE(deleted == std::vector<int32>{1});
+
+    // Adopt with a deleter, released when the DataVector reallocates
+    {
+      auto* raw = static_cast<int32*>(std::malloc(3 * sizeof(int32)));
+      raw[0] = 7;
+      DataVector<int32> vector = DataVector<int32>::Adopt(raw, 3, [&deleted](int32* ptr) {
+        deleted.push_back(ptr[0]);
+        std::free(ptr);
+      });
+      REQUIRE(vector.data() == raw);
+      vector.resize(100);
+      REQUIRE(deleted == std::vector<int32>{1, 7});
+      REQUIRE(vector[0] == 7);
+    }
+
+    // Share keeps the owner alive
+    {
+      auto owner = std::make_shared<std::vector<float32>>(10, 3.0f);
+      std::weak_ptr<std::vector<float32>> weakOwner = owner;
+      float32* data = owner->data();
+      DataVector<float32> vector = DataVector<float32>::Share(data, 10, std::move(owner));
+      REQUIRE_FALSE(weakOwner.expired());
+      REQUIRE(vector[9] == 3.0f);
+      vector = DataVector<float32>(1);
+      REQUIRE(weakOwner.expired());
+      REQUIRE_THROWS(DataVector<float32>::Share(vector.data(), 1, std::shared_ptr<int>()));
+    }
+
+    // View never frees and writes through to the buffer
+    {
+      std::vector<uint16> buffer(5, 1);
+      {
+        DataVector<uint16> view = DataVector<uint16>::View(buffer.data(), buffer.size());
+        REQUIRE(view.isView());
+        REQUIRE(view.data() == buffer.data());
+        view[4] = 9;
+        view.resize(10);
+        REQUIRE_FALSE(view.isView());
+        view[0] = 5;
+      }
+      REQUIRE(buffer[4] == 9);
+      REQUIRE(buffer[0] == 1);
+    }
+
+    // Growing back after shrinking leaves the external buffer alone
+    {
+      std::vector<uint16> buffer = {1, 2, 3, 4};
+      DataVector<uint16> view = DataVector<uint16>::View(buffer.data(), buffer.size());
+      view.resize(2);
+      REQUIRE(view.capacity() == 2);
+      view.resize(4);
+      REQUIRE_FALSE(view.isView());
+      REQUIRE(view[1] == 2);
+      REQUIRE(view[3] == 0);
+      REQUIRE(buffer == std::vector<uint16>{1, 2, 3, 4});
+
+      auto owner = std::make_shared<std::vector<uint16>>(buffer);
+      uint16* data = owner->data();
+      DataVector<uint16> shared = DataVector<uint16>::Share(data, 4, owner);
+      shared.resize(1);
+      shared.resize(3);
+      REQUIRE(std::as_const(shared).data() != data);
+      REQUIRE(*owner == std::vector<uint16>{1, 2, 3, 4});
+    }
+  }
+  SECTION("copy on write")
+  {
+    DataVector<int32> vector(1000);
+    std::iota(vector.begin(), vector.end(), 0);
+    REQUIRE_FALSE(vector.isCopyOnWrite());
+    vector.setCopyOnWrite(true);
+    REQUIRE(vector.isCopyOnWrite());
+    REQUIRE_FALSE(vector.isShared());
+    const int32* original = std::as_const(vector).data();
+
+    // Copies share storage until one of them is modified
+    DataVector<int32> copy = vector;
+    REQUIRE(copy.isCopyOnWrite());
+    REQUIRE(copy.isShared());
+    REQUIRE(std::as_const(copy).data() == original);
+    const DataVector<int32>& constCopy = copy;
+    REQUIRE(constCopy[999] == 999);
+    REQUIRE(std::as_const(copy).data() == original);
+
+    // Writing through the copy leaves the original untouched
+    copy[0] = -1;
+    REQUIRE(std::as_const(copy).data() != original);
+    REQUIRE_FALSE(copy.isShared());
+    REQUIRE_FALSE(vector.isShared());
+    REQUIRE(vector[0] == 0);
+    REQUIRE(copy[0] == -1);
+    REQUIRE(copy[999] == 999);
+    REQUIRE(std::as_const(vector).data() == original);
+    DataVector<int32> iterated = vector;
+    std::fill(iterated.begin(), iterated.end(), 3);
+    REQUIRE(std::as_const(vector)[0] == 0);
+    REQUIRE(std::as_const(vector).data() == original);
+
+    // Assignment shares as well, and fill does not copy the old elements
+    DataVector<int32> assigned(5);
+    assigned = vector;
+    REQUIRE(assigned.isShared());
+    assigned.fill(7);
+    REQUIRE(assigned[999] == 7);
+    REQUIRE(vector[999] == 999);
+
+    // Growing within capacity copies first
+    DataVector<int32> grown = vector;
+    grown.resize(500);
+    grown.resize(600);
+    REQUIRE(grown[599] == 0);
+    REQUIRE(vector[599] == 599);
+
+    // Disabling copy-on-write detaches
+    DataVector<int32> detached = vector;
+    detached.setCopyOnWrite(false);
+    REQUIRE_FALSE(vector.isShared());
+    REQUIRE(std::as_const(detached).data() != original);
+    DataVector<int32> deepCopy = detached;
+    REQUIRE(std::as_const(deepCopy).data() != std::as_const(detached).data());
+
+    // Shared storage outlives the DataVector it came from
+    DataVector<int32> survivor = vector;
+    vector = DataVector<int32>(1);
+    REQUIRE_FALSE(survivor.isShared());
+    REQUIRE(std::as_const(survivor).data() == original);
+    REQUIRE(survivor[10] == 10);
+  }
+  SECTION("byteswap")
+  {
+    DataVector<uint32> vector(37);
+    std::iota(vector.begin(), vector.end(), 0x01020304u);
+    vector.byteswap();
+    REQUIRE(vector[0] == 0x04030201u);
+    REQUIRE(vector[36] == byteswap(0x01020304u + 36u));
+  }
+  SECTION("iterators")
+  {
+    DataVector<float64> vector(10);
+    std::iota(vector.begin(), vector.end(), 0.0);
+    REQUIRE(vector.end() - vector.begin() == 10);
+    REQUIRE(*(vector.begin() + 3) == 3.0);
+    REQUIRE(vector.begin()[4] == 4.0);
+    REQUIRE(*(2 + vector.begin()) == 2.0);
+
+    DataVector<float64> output(10);
+    std::transform(vector.begin(), vector.end(), output.begin(), [](float64 value) { return value * 2.0; });
+    REQUIRE(output[9] == 18.0);
+
+    const DataVector<float64>& constVector = vector;
+    std::copy(constVector.begin(), constVector.end(), output.begin());
+    REQUIRE(std::equal(output.cbegin(), output.cend(), vector.cbegin()));
+
+    DataVector<float64>::ConstIterator constIter = vector.begin();
+    REQUIRE(constIter == constVector.begin());
+    REQUIRE(std::distance(vector.begin(), vector.end()) == 10);
+
+#ifdef NXCOMMON_ENABLE_CHECKED_ITERATORS
+    REQUIRE_THROWS(*vector.end());
+    REQUIRE_THROWS(vector.begin() - 1);
+    REQUIRE_THROWS(vector.begin() == output.begin());
+#else
+    static_assert(sizeof(DataVector<float64>::Iterator) == sizeof(float64*));
+#endif
+  }
+  SECTION("alignment")
+  {
+    static_assert(DataVector<uint8>::k_Alignment == k_CacheLineSize);
+    static_assert(DataVector<float64>::k_Alignment == k_CacheLineSize);
+    static_assert(DataVector<DataVector<int32>>::k_Alignment == alignof(DataVector<int32>));
+
+    for(usize size : {1, 3, 100, 1000})
+    {
+      DataVector<float32> vector(size);
+      REQUIRE(IsAligned(vector.data(), k_CacheLineSize));
+      REQUIRE(vector.alignment() == k_CacheLineSize);
+      vector.resize(size * 3);
+      REQUIRE(IsAligned(vector.data(), k_CacheLineSize));
+    }
+
+    DataVector<float32> vector(33, 2.0f);
+    AlignedSpan<float32, k_CacheLineSize> span = vector.createAlignedSpan();
+    REQUIRE(span.size() == 33);
+    REQUIRE(span[32] == 2.0f);
+    REQUIRE(span.data() == vector.data());
+    AlignedSpan<const float32, 16> constSpan = span;
+    REQUIRE(constSpan.size() == 33);
+
+    // Adopted buffers report the alignment they actually have
+    auto buffer = std::make_unique<int32[]>(4);
+    const bool isCacheLineAligned = IsAligned(buffer.get(), k_CacheLineSize);
+    DataVector<int32> adopted(4, std::move(buffer));
+    REQUIRE(adopted.alignment() >= alignof(int32));
+    REQUIRE((adopted.alignment() == k_CacheLineSize) == isCacheLineAligned);
+  }
+}
+
+TEST_CASE("DataVectorTest: memory mapped")
+{
+  const std::vector<int32> values = {0, 1, 2, 3, 4, 5, 6, 7};
+  std::filesystem::path path = WriteTestFile("NXCommon_DataVectorTest_mapped.raw", values);
+
+  SECTION("read only")
+  {
+    const auto vector = DataVector<int32>::MapFile(path, MemoryMappedFile::Access::ReadOnly);
+    REQUIRE(vector.isFileBacked());
+    REQUIRE(vector.size() == values.size());
+    for(usize i = 0; i < values.size(); i++)
+    {
+      REQUIRE(vector[i] == values[i]);
+    }
+  }
+  SECTION("offset")
+  {
+    const auto vector = DataVector<int32>::MapFile(path, MemoryMappedFile::Access::ReadOnly, 2 * sizeof(int32), 3);
+    REQUIRE(vector.size() == 3);
+    REQUIRE(vector[0] == 2);
+    REQUIRE(vector[2] == 4);
+    REQUIRE_THROWS(DataVector<int32>::MapFile(path, MemoryMappedFile::Access::ReadOnly, 1));
+    REQUIRE_THROWS(DataVector<int32>::MapFile(path, MemoryMappedFile::Access::ReadOnly, 0, values.size() + 1));
+  }
+  SECTION("copy on write")
+  {
+    auto vector = DataVector<int32>::MapFile(path, MemoryMappedFile::Access::CopyOnWrite);
+    vector[0] = 42;
+    REQUIRE(vector[0] == 42);
+
+    const auto reopened = DataVector<int32>::MapFile(path, MemoryMappedFile::Access::ReadOnly);
+    REQUIRE(reopened[0] == 0);
+  }
+  SECTION("read write")
+  {
+    {
+      auto vector = DataVector<int32>::MapFile(path, MemoryMappedFile::Access::ReadWrite);
+      vector[1] = 42;
+      vector.flush();
+    }
+    const auto reopened = DataVector<int32>::MapFile(path, MemoryMappedFile::Access::ReadOnly);
+    REQUIRE(reopened[1] == 42);
+  }
+  SECTION("detach on resize")
+  {
+    auto vector = DataVector<int32>::MapFile(path, MemoryMappedFile::Access::ReadOnly);
+    vector.resize(values.size() + 2);
+    REQUIRE_FALSE(vector.isFileBacked());
+    REQUIRE(vector[values.size() - 1] == values.back());
+    REQUIRE(vector[values.size()] == 0);
+  }
+
+  std::filesystem::remove(path);
+}
+
+TEST_CASE("DataVectorTest: streaming")
+{
+  std::filesystem::path path = std::filesystem::temp_directory_path() / "NXCommon_DataVectorTest_stream.raw";
+
+  constexpr usize k_NumElements = 1000;
+  constexpr usize k_BlockSize = 64;
+  DataVector<uint32> values(k_NumElements);
+  std::iota(values.begin(), values.end(), 0x01020304u);
+
+  SECTION("native")
+  {
+    int fileDescriptor = OpenFile(path, true);
+    REQUIRE(WriteDataVector(fileDescriptor, values, endian::native, k_BlockSize).valid());
+    CloseFile(fileDescriptor);
+
+    DataVector<uint32> result(k_NumElements, InitializationMode::Uninitialized);
+    fileDescriptor = OpenFile(path, false);
+    REQUIRE(ReadDataVector(fileDescriptor, result, endian::native, k_BlockSize).valid());
+    CloseFile(fileDescriptor);
+    REQUIRE(std::equal(result.begin(), result.end(), values.begin()));
+  }
+  SECTION("swapped")
+  {
+    constexpr endian k_OtherEndian = endian::native == endian::little ? endian::big : endian::little;
+
+    int fileDescriptor = OpenFile(path, true);
+    REQUIRE(WriteDataVector(fileDescriptor, values, k_OtherEndian, k_BlockSize).valid());
+    CloseFile(fileDescriptor);
+
+    // The file holds the swapped values and the source is untouched
+    const auto mapped = DataVector<uint32>::MapFile(path, MemoryMappedFile::Access::ReadOnly);
+    REQUIRE(mapped.size() == k_NumElements);
+    REQUIRE(mapped[0] == byteswap(values[0]));
+    REQUIRE(mapped[k_NumElements - 1] == byteswap(values[k_NumElements - 1]));
+    REQUIRE(values[0] == 0x01020304u);
+
+    DataVector<uint32> result(k_NumElements, InitializationMode::Uninitialized);
+    fileDescriptor = OpenFile(path, false);
+    REQUIRE(ReadDataVector(fileDescriptor, result, k_OtherEndian, k_BlockSize).valid());
+    CloseFile(fileDescriptor);
+    REQUIRE(std::equal(result.begin(), result.end(), values.begin()));
+
+    DataVector<uint32> tooLarge(k_NumElements + 1);
+    fileDescriptor = OpenFile(path, false);
+    REQUIRE(ReadDataVector(fileDescriptor, tooLarge, k_OtherEndian, k_BlockSize).invalid());
+    CloseFile(fileDescriptor);
+  }
+
+  std::filesystem::remove(path);
+}
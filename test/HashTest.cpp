@@ -0,0 +1,129 @@
+#include <catch2/catch.hpp>
+
+#include "NX/Common/DataVector.hpp"
+#include "NX/Common/Hash.hpp"
+
+#include <algorithm>
+#include <random>
+#include <set>
+#include <vector>
+
+using namespace NX;
+using namespace NX::Common;
+
+namespace
+{
+std::vector<uint8> PatternBytes(usize size)
+{
+  std::vector<uint8> bytes(size);
+  for(usize i = 0; i < size; i++)
+  {
+    bytes[i] = static_cast<uint8>((i * 31 + (i >> 8) * 7) & 0xFF);
+  }
+  return bytes;
+}
+} // namespace
+
+TEST_CASE("HashTest")
+{
+  SECTION("known values")
+  {
+    // Pins the output so that it stays identical across platforms, instruction sets and releases
+    const std::vector<std::pair<usize, uint64>> expected = {{0, 0xD274C324740BC75Full},   {3, 0x4435A18E6C98F5EDull},   {8, 0x7ECA89685E97F641ull},    {16, 0x3F1042433865581Full},
+                                                            {17, 0x340919A0B6CE8234ull},  {100, 0xA17EA544CB343839ull}, {240, 0xBB213BAB30046226ull},  {241, 0x63FA3E5B2DFEE189ull},
+                                                            {1000, 0x7E5E6D9064227322ull}, {5000, 0xC634C37BE2B0F666ull}};
+    for(const auto& [size, hash] : expected)
+    {
+      const std::vector<uint8> bytes = PatternBytes(size);
+      INFO("size " << size);
+      REQUIRE(Hash64(nonstd::span<const uint8>(bytes)) == hash);
+    }
+    const std::vector<uint8> bytes = PatternBytes(5000);
+    const Digest128 digest = Hash128(nonstd::span<const uint8>(bytes), 42);
+    REQUIRE(digest.low == 0xAAD5A0C6D860C19Dull);
+    REQUIRE(digest.high == 0x052A31F58D36C37Full);
+  }
+
+  SECTION("sensitivity")
+  {
+    std::set<uint64> hashes;
+    usize numHashes = 0;
+    for(usize size : {1, 4, 9, 16, 33, 200, 240, 241, 256, 1024, 1025, 5000})
+    {
+      std::vector<uint8> bytes = PatternBytes(size);
+      hashes.insert(Hash64(nonstd::span<const uint8>(bytes)));
+      hashes.insert(Hash64(nonstd::span<const uint8>(bytes), 1));
+      hashes.insert(Hash128(nonstd::span<const uint8>(bytes)).high);
+      numHashes += 3;
+      for(usize position : std::set<usize>{0, size / 2, size - 1})
+      {
+        bytes[position] ^= 0x10;
+        hashes.insert(Hash64(nonstd::span<const uint8>(bytes)));
+        hashes.insert(Hash128(nonstd::span<const uint8>(bytes)).high);
+        bytes[position] ^= 0x10;
+        numHashes += 2;
+      }
+    }
+    REQUIRE(hashes.size() == numHashes);
+
+    DataVector<float32> values(1000);
+    std::fill(values.begin(), values.end(), 1.5f);
+    REQUIRE(Hash64(values) == Hash64(values.createSpan()));
+    REQUIRE(Hash128(values) == Hash128(values.createSpan()));
+  }
+
+  SECTION("incremental")
+  {
+    std::mt19937_64 generator(7);
+    for(usize size : {0, 5, 17, 240, 241, 255, 256, 257, 300, 1023, 1024, 1025, 4096, 20000})
+    {
+      const std::vector<uint8> bytes = PatternBytes(size);
+      for(usize maxPiece : {1, 13, 64, 100, 256, 1000})
+      {
+        Hasher hasher(3);
+        usize offset = 0;
+        while(offset < size)
+        {
+          const usize piece = std::min<usize>(generator() % maxPiece + 1, size - offset);
+          hasher.update(bytes.data() + offset, piece);
+          offset += piece;
+        }
+        INFO("size " << size << " max piece " << maxPiece);
+        REQUIRE(hasher.digest64() == Hash64(nonstd::span<const uint8>(bytes), 3));
+        REQUIRE(hasher.digest128() == Hash128(nonstd::span<const uint8>(bytes), 3));
+      }
+    }
+
+    std::vector<uint32> values = {1, 2, 3, 4};
+    Hasher hasher;
+    hasher.update(nonstd::span<const uint32>(values));
+    REQUIRE(hasher.digest64() == Hash64(nonstd::span<const uint32>(values)));
+    hasher.reset(5);
+    REQUIRE(hasher.digest64() == Hash64(nonstd::span<const uint32>(), 5));
+  }
+
+  SECTION("tree hash")
+  {
+    const std::vector<uint8> small = PatternBytes(1000);
+    REQUIRE(TreeHash64(nonstd::span<const uint8>(small), 9) == Hash64(nonstd::span<const uint8>(small), 9));
+    REQUIRE(TreeHash128(nonstd::span<const uint8>(small), 9) == Hash128(nonstd::span<const uint8>(small), 9));
+
+    const usize size = 3 * k_HashTreeChunkBytes + 12345;
+    const std::vector<uint8> bytes = PatternBytes(size);
+    std::vector<uint64> words;
+    std::vector<uint64> words128;
+    for(usize offset = 0; offset < size; offset += k_HashTreeChunkBytes)
+    {
+      const nonstd::span<const uint8> chunk(bytes.data() + offset, std::min(k_HashTreeChunkBytes, size - offset));
+      words.push_back(Hash64(chunk));
+      const Digest128 digest = Hash128(chunk);
+      words128.push_back(digest.low);
+      words128.push_back(digest.high);
+    }
+    words.push_back(size);
+    words128.push_back(size);
+    REQUIRE(TreeHash64(nonstd::span<const uint8>(bytes), 9) == Hash64(nonstd::span<const uint64>(words), 9));
+    REQUIRE(TreeHash128(nonstd::span<const uint8>(bytes), 9) == Hash128(nonstd::span<const uint64>(words128), 9));
+    REQUIRE(TreeHash64(nonstd::span<const uint8>(bytes), 9) != Hash64(nonstd::span<const uint8>(bytes), 9));
+  }
+}
@@ -0,0 +1,134 @@
+#include <catch2/catch.hpp>
+
+#include "NX/Common/DataVector.hpp"
+#include "NX/Common/Histogram.hpp"
+
+#include <limits>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace NX;
+using namespace NX::Common;
+
+namespace
+{
+template <class T>
+Histogram NaiveHistogram(const std::vector<T>& values, const HistogramBins& bins)
+{
+  Histogram histogram;
+  histogram.counts.resize(bins.numBins(), 0);
+  for(T value : values)
+  {
+    const usize index = bins.binIndex(static_cast<float64>(value));
+    if(index == bins.numBins())
+    {
+      histogram.numOutOfRange++;
+    }
+    else
+    {
+      histogram.counts[index]++;
+    }
+  }
+  return histogram;
+}
+
+template <class T>
+void CheckAgainstNaive(const std::vector<T>& values, const HistogramBins& bins)
+{
+  Histogram histogram = ComputeHistogram(nonstd::span<const T>(values), bins);
+  Histogram expected = NaiveHistogram(values, bins);
+  REQUIRE(histogram.counts == expected.counts);
+  REQUIRE(histogram.numOutOfRange == expected.numOutOfRange);
+  REQUIRE(std::accumulate(histogram.counts.begin(), histogram.counts.end(), histogram.numOutOfRange) == values.size());
+}
+} // namespace
+
+TEST_CASE("HistogramTest")
+{
+  std::mt19937_64 generator(7);
+
+  SECTION("bins")
+  {
+    HistogramBins uniform = HistogramBins::Uniform(4, 0.0, 8.0);
+    REQUIRE(uniform.isUniform());
+    REQUIRE(uniform.binIndex(0.0) == 0);
+    REQUIRE(uniform.binIndex(1.99) == 0);
+    REQUIRE(uniform.binIndex(2.0) == 1);
+    REQUIRE(uniform.binIndex(8.0) == 3);
+    REQUIRE(uniform.binIndex(8.01) == 4);
+    REQUIRE(uniform.binIndex(-0.01) == 4);
+    REQUIRE(uniform.binIndex(std::numeric_limits<float64>::quiet_NaN()) == 4);
+
+    HistogramBins edges = HistogramBins::FromEdges({-1.0, 0.0, 10.0, 100.0});
+    REQUIRE_FALSE(edges.isUniform());
+    REQUIRE(edges.numBins() == 3);
+    REQUIRE(edges.binIndex(-1.0) == 0);
+    REQUIRE(edges.binIndex(0.0) == 1);
+    REQUIRE(edges.binIndex(99.0) == 2);
+    REQUIRE(edges.binIndex(100.0) == 2);
+    REQUIRE(edges.binIndex(100.5) == 3);
+
+    REQUIRE_THROWS_AS(HistogramBins::Uniform(0, 0.0, 1.0), std::runtime_error);
+    REQUIRE_THROWS_AS(HistogramBins::Uniform(4, 1.0, 1.0), std::runtime_error);
+    REQUIRE_THROWS_AS(HistogramBins::FromEdges({1.0}), std::runtime_error);
+    REQUIRE_THROWS_AS(HistogramBins::FromEdges({0.0, 2.0, 1.0}), std::runtime_error);
+  }
+
+  SECTION("values")
+  {
+    // Sizes below and above the direct and parallel thresholds
+    for(usize size : {5ull, 1000ull, 5000ull, 300000ull})
+    {
+      std::uniform_real_distribution<float32> floatDistribution(-10.0f, 110.0f);
+      std::uniform_int_distribution<int32> intDistribution(-40000, 70000);
+      std::vector<float32> floats(size);
+      std::vector<float64> doubles(size);
+      std::vector<uint8> bytes(size);
+      std::vector<int8> signedBytes(size);
+      std::vector<uint16> shorts(size);
+      std::vector<int32> ints(size);
+      for(usize i = 0; i < size; i++)
+      {
+        floats[i] = floatDistribution(generator);
+        doubles[i] = floats[i];
+        ints[i] = intDistribution(generator);
+        bytes[i] = static_cast<uint8>(ints[i]);
+        signedBytes[i] = static_cast<int8>(bytes[i]);
+        shorts[i] = static_cast<uint16>(ints[i]);
+      }
+      floats[size / 2] = std::numeric_limits<float32>::quiet_NaN();
+      floats[size / 3] = 100.0f;
+
+      HistogramBins uniform = HistogramBins::Uniform(37, 0.0, 100.0);
+      HistogramBins edges = HistogramBins::FromEdges({-50.0, -1.0, 0.0, 0.5, 20.0, 64.0, 1000.0, 40000.0});
+      CheckAgainstNaive(floats, uniform);
+      CheckAgainstNaive(floats, edges);
+      CheckAgainstNaive(doubles, uniform);
+      CheckAgainstNaive(bytes, uniform);
+      CheckAgainstNaive(bytes, edges);
+      CheckAgainstNaive(signedBytes, uniform);
+      CheckAgainstNaive(signedBytes, edges);
+      CheckAgainstNaive(shorts, HistogramBins::Uniform(1000, 0.0, 65535.0));
+      CheckAgainstNaive(shorts, edges);
+      CheckAgainstNaive(ints, HistogramBins::Uniform(256, -40000.0, 70000.0));
+      CheckAgainstNaive(ints, edges);
+    }
+  }
+
+  SECTION("data vector")
+  {
+    DataVector<bool> flags(2000, false);
+    for(usize i = 0; i < flags.size(); i += 4)
+    {
+      flags[i] = true;
+    }
+    Histogram histogram = ComputeHistogram(flags, HistogramBins::Uniform(2, 0.0, 1.0));
+    REQUIRE(histogram.counts == std::vector<uint64>{1500, 500});
+    REQUIRE(histogram.numOutOfRange == 0);
+
+    Histogram empty = ComputeHistogram(DataVector<float32>(0), HistogramBins::Uniform(3, 0.0, 1.0));
+    REQUIRE(empty.counts == std::vector<uint64>(3, 0));
+  }
+}
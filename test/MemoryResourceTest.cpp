@@ -0,0 +1,254 @@
+#include <catch2/catch.hpp>
+
+#include "NX/Common/AlignedSpan.hpp"
+#include "NX/Common/DataVector.hpp"
+#include "NX/Common/MemoryResource.hpp"
+
+#include <array>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace NX;
+using namespace NX::Common;
+
+namespace
+{
+/**
+ * @brief Forwards to the default resource while counting outstanding allocations.
+ */
+class CountingResource : public MemoryResource
+{
+public:
+  usize numAllocations = 0;
+  usize numOutstanding = 0;
+
+protected:
+  void* doAllocate(usize numBytes, usize alignment) override
+  {
+    numAllocations++;
+    numOutstanding++;
+    return GetDefaultMemoryResource()->allocate(numBytes, alignment);
+  }
+
+  void doDeallocate(void* ptr, usize numBytes, usize alignment) noexcept override
+  {
+    numOutstanding--;
+    GetDefaultMemoryResource()->deallocate(ptr, numBytes, alignment);
+  }
+};
+
+/**
+ * @brief Throws when copying a negative value, to check that partially copied storage is released.
+ */
+struct ThrowingCopy
+{
+  int32 value = 0;
+
+  ThrowingCopy& operator=(const ThrowingCopy& other)
+  {
+    if(other.value < 0)
+    {
+      throw std::runtime_error("ThrowingCopy: negative value");
+    }
+    value = other.value;
+    return *this;
+  }
+};
+} // namespace
+
+TEST_CASE("MemoryResourceTest")
+{
+  SECTION("default")
+  {
+    MemoryResource* resource = GetDefaultMemoryResource();
+    REQUIRE(resource == GetDefaultMemoryResource());
+    void* ptr = resource->allocate(100, 256);
+    REQUIRE(IsAligned(ptr, 256));
+    resource->deallocate(ptr, 100, 256);
+  }
+  SECTION("monotonic arena")
+  {
+    CountingResource upstream;
+    {
+      MonotonicArenaResource arena(1024, &upstream);
+      REQUIRE(arena.upstream() == &upstream);
+
+      void* first = arena.allocate(10, 1);
+      void* second = arena.allocate(16, 16);
+      REQUIRE(IsAligned(second, 16));
+      REQUIRE(static_cast<std::byte*>(second) >= static_cast<std::byte*>(first) + 10);
+      REQUIRE(upstream.numAllocations == 1);
+
+      // Larger than the next block, so the arena must grow to fit it
+      void* large = arena.allocate(100000, 64);
+      REQUIRE(IsAligned(large, 64));
+      REQUIRE(upstream.numAllocations == 2);
+      arena.deallocate(large, 100000, 64);
+      REQUIRE(upstream.numOutstanding == 2);
+
+      arena.release();
+      REQUIRE(upstream.numOutstanding == 0);
+      arena.allocate(10);
+      REQUIRE(upstream.numOutstanding == 1);
+    }
+    REQUIRE(upstream.numOutstanding == 0);
+  }
+  SECTION("monotonic arena with initial buffer")
+  {
+    CountingResource upstream;
+    alignas(64) std::array<std::byte, 256> buffer = {};
+    MonotonicArenaResource arena(buffer.data(), buffer.size(), &upstream);
+
+    void* ptr = arena.allocate(128, 64);
+    REQUIRE(ptr >= buffer.data());
+    REQUIRE(ptr < buffer.data() + buffer.size());
+    REQUIRE(upstream.numAllocations == 0);
+
+    arena.allocate(256);
+    REQUIRE(upstream.numAllocations == 1);
+
+    arena.release();
+    REQUIRE(upstream.numOutstanding == 0);
+    REQUIRE(arena.allocate(128, 64) == ptr);
+  }
+  SECTION("pool")
+  {
+    CountingResource upstream;
+    {
+      PoolResource pool(4096, &upstream);
+
+      std::vector<void*> blocks;
+      for(usize i = 0; i < 100; i++)
+      {
+        void* ptr = pool.allocate(24, 8);
+        REQUIRE(IsAligned(ptr, 8));
+        blocks.push_back(ptr);
+      }
+      const usize warmAllocations = upstream.numAllocations;
+      REQUIRE(warmAllocations == 1);
+
+      // Freed blocks are reused without going upstream
+      for(void* ptr : blocks)
+      {
+        pool.deallocate(ptr, 24, 8);
+      }
+      for(usize i = 0; i < 100; i++)
+      {
+        blocks[i] = pool.allocate(24, 8);
+      }
+      REQUIRE(upstream.numAllocations == warmAllocations);
+
+      // Blocks in a size class are aligned to the block size
+      REQUIRE(IsAligned(pool.allocate(256, 256), 256));
+
+      // Oversized requests bypass the pool
+      void* large = pool.allocate(8192, 8);
+      const usize outstanding = upstream.numOutstanding;
+      pool.deallocate(large, 8192, 8);
+      REQUIRE(upstream.numOutstanding == outstanding - 1);
+
+      pool.release();
+      REQUIRE(upstream.numOutstanding == 0);
+    }
+    REQUIRE(upstream.numOutstanding == 0);
+  }
+  SECTION("huge pages")
+  {
+    CountingResource upstream;
+    HugePageResource resource(HugePageResource::k_HugePageSize, &upstream);
+    REQUIRE(resource.upstream() == &upstream);
+
+    void* small = resource.allocate(100, 8);
+    void* large = resource.allocate(HugePageResource::k_HugePageSize + 1, 64);
+    REQUIRE(IsAligned(large, HugePageResource::k_HugePageSize));
+    REQUIRE(upstream.numOutstanding == 2);
+    resource.deallocate(small, 100, 8);
+    resource.deallocate(large, HugePageResource::k_HugePageSize + 1, 64);
+    REQUIRE(upstream.numOutstanding == 0);
+
+    DataVector<float32> vector(HugePageResource::k_HugePageSize, 1.0f, &resource);
+    REQUIRE(IsAligned(vector.data(), HugePageResource::k_HugePageSize));
+    REQUIRE(vector[HugePageResource::k_HugePageSize - 1] == 1.0f);
+  }
+  SECTION("data vector")
+  {
+    CountingResource upstream;
+    MonotonicArenaResource arena(1024, &upstream);
+    {
+      DataVector<float64> vector(100, 1.5, &arena);
+      REQUIRE(vector.memoryResource() == &arena);
+      REQUIRE(vector.size() == 100);
+      REQUIRE(vector[99] == 1.5);
+
+      // Growth stays in the arena
+      vector.resize(1000);
+      REQUIRE(vector.memoryResource() == &arena);
+      REQUIRE(vector[99] == 1.5);
+      REQUIRE(vector[999] == 0.0);
+
+      // Copies use the default resource unless one is given
+      DataVector<float64> copy(vector);
+      REQUIRE(copy.memoryResource() == GetDefaultMemoryResource());
+      DataVector<float64> arenaCopy(vector, &arena);
+      REQUIRE(arenaCopy.memoryResource() == &arena);
+      REQUIRE(std::equal(arenaCopy.begin(), arenaCopy.end(), vector.begin()));
+
+      // Assignment keeps the resource of the target
+      copy = arenaCopy;
+      REQUIRE(copy.memoryResource() == GetDefaultMemoryResource());
+
+      // Copy-on-write storage is only shared by copies that use the same resource
+      arenaCopy.setCopyOnWrite(true);
+      DataVector<float64> heapCopy(arenaCopy);
+      REQUIRE(heapCopy.isCopyOnWrite());
+      REQUIRE_FALSE(heapCopy.isShared());
+      REQUIRE(std::as_const(heapCopy).data() != std::as_const(arenaCopy).data());
+      DataVector<float64> sharedCopy(arenaCopy, &arena);
+      REQUIRE(sharedCopy.isShared());
+      REQUIRE(std::as_const(sharedCopy).data() == std::as_const(arenaCopy).data());
+
+      // Assignment into reused storage shares it with later copies, like the copy constructor
+      DataVector<float64> target(2000);
+      const float64* targetData = std::as_const(target).data();
+      target = arenaCopy;
+      REQUIRE(target.isCopyOnWrite());
+      REQUIRE(std::as_const(target).data() == targetData);
+      DataVector<float64> targetCopy(target);
+      REQUIRE(targetCopy.isShared());
+      REQUIRE(targetCopy.data() != targetData);
+      REQUIRE_FALSE(target.isShared());
+
+      DataVector<float64> moved(std::move(vector));
+      REQUIRE(moved.memoryResource() == &arena);
+      REQUIRE(moved.size() == 1000);
+    }
+    {
+      CountingResource counting;
+      {
+        DataVector<int32> vector(10, &counting);
+        vector.resize(100);
+        vector.resize(50);
+        vector.shrink_to_fit();
+        DataVector<int32> empty(0, &counting);
+      }
+      REQUIRE(counting.numAllocations == 3);
+      REQUIRE(counting.numOutstanding == 0);
+    }
+    {
+      CountingResource counting;
+      {
+        DataVector<ThrowingCopy> vector(4, &counting);
+        vector[3].value = -1;
+        REQUIRE_THROWS_AS(vector.reserve(100), std::runtime_error);
+        REQUIRE_THROWS_AS(DataVector<ThrowingCopy>(vector, &counting), std::runtime_error);
+        DataVector<ThrowingCopy> target(0, &counting);
+        REQUIRE_THROWS_AS(target = vector, std::runtime_error);
+        REQUIRE(counting.numOutstanding == 1);
+        REQUIRE(vector.capacity() == 4);
+      }
+      REQUIRE(counting.numOutstanding == 0);
+    }
+  }
+}
@@ -0,0 +1,239 @@
+#include <catch2/catch.hpp>
+
+#include "NX/Common/ParallelDataAlgorithm.hpp"
+
+#include <atomic>
+#include <numeric>
+#include <vector>
+
+using namespace NX;
+using namespace NX::Common;
+
+namespace
+{
+const std::vector<Partitioner> k_Partitioners = {Partitioner::Auto, Partitioner::Simple, Partitioner::Static};
+} // namespace
+
+TEST_CASE("ParallelDataAlgorithmTest")
+{
+  SECTION("1D")
+  {
+    for(Partitioner partitioner : k_Partitioners)
+    {
+      for(usize grain : {0, 1, 7, 100000})
+      {
+        std::vector<std::atomic<uint32>> visits(10000);
+        ParallelDataAlgorithm algorithm(Range(13, 9000));
+        algorithm.setPartitioner(partitioner);
+        algorithm.setGrain(grain);
+        algorithm.execute([&visits](const Range& range) {
+          for(usize i = range.min(); i < range.max(); i++)
+          {
+            visits[i]++;
+          }
+        });
+        usize numWrong = 0;
+        for(usize i = 0; i < visits.size(); i++)
+        {
+          numWrong += visits[i] != ((i >= 13 && i < 9000) ? 1 : 0) ? 1 : 0;
+        }
+        REQUIRE(numWrong == 0);
+
+        const uint64 sum = algorithm.reduce(
+            uint64{0},
+            [](const Range& range, uint64 value) {
+              for(usize i = range.min(); i < range.max(); i++)
+              {
+                value += i;
+              }
+              return value;
+            },
+            [](uint64 lhs, uint64 rhs) { return lhs + rhs; });
+        REQUIRE(sum == (8999ull * 9000ull - 12ull * 13ull) / 2);
+      }
+    }
+
+    // Concatenation is not commutative, so this checks that join keeps the sub ranges in order
+    ParallelDataAlgorithm algorithm(Range(0, 5000));
+    algorithm.setGrain(10);
+    std::vector<usize> expected(5000);
+    std::iota(expected.begin(), expected.end(), usize{0});
+    const std::vector<usize> indices = algorithm.reduce(
+        std::vector<usize>(),
+        [](const Range& range, std::vector<usize> value) {
+          for(usize i = range.min(); i < range.max(); i++)
+          {
+            value.push_back(i);
+          }
+          return value;
+        },
+        [](std::vector<usize> lhs, const std::vector<usize>& rhs) {
+          lhs.insert(lhs.end(), rhs.begin(), rhs.end());
+          return lhs;
+        });
+    REQUIRE(indices == expected);
+  }
+
+  SECTION("deterministic reduce")
+  {
+    std::vector<float32> values(100000);
+    for(usize i = 0; i < values.size(); i++)
+    {
+      values[i] = 1.0f / static_cast<float32>(i + 1);
+    }
+    for(Partitioner partitioner : {Partitioner::Simple, Partitioner::Static})
+    {
+      ParallelDataAlgorithm algorithm(Range(0, values.size()));
+      algorithm.setPartitioner(partitioner);
+      algorithm.setGrain(100);
+      const auto sum = [&algorithm, &values]() {
+        return algorithm.reduce(
+            0.0f,
+            [&values](const Range& range, float32 value) {
+              for(usize i = range.min(); i < range.max(); i++)
+              {
+                value += values[i];
+              }
+              return value;
+            },
+            [](float32 lhs, float32 rhs) { return lhs + rhs; });
+      };
+      const float32 first = sum();
+      for(usize i = 0; i < 10; i++)
+      {
+        REQUIRE(sum() == first);
+      }
+    }
+  }
+
+  SECTION("2D")
+  {
+    const usize numCols = 37;
+    const usize numRows = 53;
+    for(Partitioner partitioner : k_Partitioners)
+    {
+      std::vector<std::atomic<uint32>> visits(numCols * numRows);
+      ParallelData2DAlgorithm algorithm(Range2D(2, 30, 5, 50));
+      algorithm.setPartitioner(partitioner);
+      algorithm.setGrain({4, 3});
+      algorithm.execute([&visits, numCols](const Range2D& range) {
+        for(usize row = range.minRow(); row < range.maxRow(); row++)
+        {
+          for(usize col = range.minCol(); col < range.maxCol(); col++)
+          {
+            visits[row * numCols + col]++;
+          }
+        }
+      });
+      usize numWrong = 0;
+      for(usize row = 0; row < numRows; row++)
+      {
+        for(usize col = 0; col < numCols; col++)
+        {
+          const bool inside = col >= 2 && col < 30 && row >= 5 && row < 50;
+          numWrong += visits[row * numCols + col] != (inside ? 1 : 0) ? 1 : 0;
+        }
+      }
+      REQUIRE(numWrong == 0);
+    }
+  }
+
+  SECTION("3D")
+  {
+    const std::array<usize, 3> dims = {19, 23, 29};
+    for(Partitioner partitioner : k_Partitioners)
+    {
+      for(std::array<usize, 3> grain : {std::array<usize, 3>{0, 0, 0}, std::array<usize, 3>{2, 3, 4}})
+      {
+        std::vector<std::atomic<uint32>> visits(dims[0] * dims[1] * dims[2]);
+        ParallelData3DAlgorithm algorithm(Range3D(1, 18, 0, 23, 4, 20));
+        algorithm.setPartitioner(partitioner);
+        algorithm.setGrain(grain);
+        algorithm.execute([&visits, &dims](const Range3D& range) {
+          for(usize z = range[4]; z < range[5]; z++)
+          {
+            for(usize y = range[2]; y < range[3]; y++)
+            {
+              for(usize x = range[0]; x < range[1]; x++)
+              {
+                visits[(z * dims[1] + y) * dims[0] + x]++;
+              }
+            }
+          }
+        });
+        usize numWrong = 0;
+        for(usize z = 0; z < dims[2]; z++)
+        {
+          for(usize y = 0; y < dims[1]; y++)
+          {
+            for(usize x = 0; x < dims[0]; x++)
+            {
+              const bool inside = x >= 1 && x < 18 && z >= 4 && z < 20;
+              numWrong += visits[(z * dims[1] + y) * dims[0] + x] != (inside ? 1 : 0) ? 1 : 0;
+            }
+          }
+        }
+        REQUIRE(numWrong == 0);
+
+        const usize count = algorithm.reduce(
+            usize{0}, [](const Range3D& range, usize value) { return value + (range[1] - range[0]) * (range[3] - range[2]) * (range[5] - range[4]); },
+            [](usize lhs, usize rhs) { return lhs + rhs; });
+        REQUIRE(count == 17 * 23 * 16);
+      }
+    }
+  }
+
+  SECTION("serial")
+  {
+    ParallelData3DAlgorithm algorithm(Range3D(64, 64, 64));
+    algorithm.setParallelizationEnabled(false);
+    usize numCalls = 0;
+    algorithm.execute([&numCalls](const Range3D& range) {
+      numCalls++;
+      REQUIRE(range.getRange() == Range3D::RangeType{0, 64, 0, 64, 0, 64});
+    });
+    REQUIRE(numCalls == 1);
+
+    ParallelDataAlgorithm empty(Range(5, 5));
+    const usize sum = empty.reduce(usize{42}, [](const Range& range, usize value) { return value + range.size(); }, [](usize lhs, usize rhs) { return lhs + rhs; });
+    REQUIRE(sum == 42);
+  }
+
+  SECTION("split")
+  {
+    const auto halves = detail::RangeTraits<Range>::Split(Range(3, 10), 1);
+    REQUIRE(halves.first.getRange() == Range::RangeType{3, 6});
+    REQUIRE(halves.second.getRange() == Range::RangeType{6, 10});
+
+    // Rows are split on ties, columns once there are more multiples of the grain along them
+    auto halves2D = detail::RangeTraits<Range2D>::Split(Range2D(0, 8, 0, 8), {1, 1});
+    REQUIRE(halves2D.first.getRange() == Range2D::RangeType{0, 8, 0, 4});
+    REQUIRE(halves2D.second.getRange() == Range2D::RangeType{0, 8, 4, 8});
+    halves2D = detail::RangeTraits<Range2D>::Split(Range2D(0, 8, 0, 8), {1, 8});
+    REQUIRE(halves2D.first.getRange() == Range2D::RangeType{0, 4, 0, 8});
+
+    auto halves3D = detail::RangeTraits<Range3D>::Split(Range3D(0, 16, 0, 16, 2, 18), {16, 1, 1});
+    REQUIRE(halves3D.first.getRange() == Range3D::RangeType{0, 16, 0, 16, 2, 10});
+    REQUIRE(halves3D.second.getRange() == Range3D::RangeType{0, 16, 0, 16, 10, 18});
+    halves3D = detail::RangeTraits<Range3D>::Split(Range3D(0, 16, 0, 16, 0, 4), {16, 1, 1});
+    REQUIRE(halves3D.first.getRange() == Range3D::RangeType{0, 16, 0, 8, 0, 4});
+    REQUIRE(halves3D.second.getRange() == Range3D::RangeType{0, 16, 8, 16, 0, 4});
+  }
+
+  SECTION("automatic grain")
+  {
+    const usize numThreads = detail::MaxParallelism();
+    REQUIRE(numThreads >= 1);
+    REQUIRE(detail::AutomaticGrain(Range(0, 0)) == 1);
+    REQUIRE(detail::AutomaticGrain(Range(0, numThreads * detail::k_ChunksPerThread * 100)) == 100);
+
+    // Chunks of a large volume are whole rows
+    const std::array<usize, 3> grain = detail::AutomaticGrain(Range3D(256, 256, 256));
+    REQUIRE(grain[0] == 256);
+    REQUIRE(grain[0] * grain[1] * grain[2] <= 256 * 256 * 256 / (numThreads * detail::k_ChunksPerThread));
+
+    const std::array<usize, 2> grain2D = detail::AutomaticGrain(Range2D(0, 100000, 0, 1));
+    REQUIRE(grain2D[1] == 1);
+    REQUIRE(grain2D[0] == std::max<usize>(1, 100000 / (numThreads * detail::k_ChunksPerThread)));
+  }
+}
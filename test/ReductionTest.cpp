@@ -0,0 +1,184 @@
+#include <catch2/catch.hpp>
+
+#include "NX/Common/DataVector.hpp"
+#include "NX/Common/Reduction.hpp"
+
+#ifdef NXCOMMON_ENABLE_MULTICORE
+#include <tbb/global_control.h>
+#endif
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+using namespace NX;
+using namespace NX::Common;
+
+namespace
+{
+template <class T>
+void CheckAgainstNaive(const std::vector<T>& values)
+{
+  float64 sum = 0.0;
+  T min = values.front();
+  T max = values.front();
+  for(T value : values)
+  {
+    sum += static_cast<float64>(value);
+    min = std::min(min, value);
+    max = std::max(max, value);
+  }
+  const float64 mean = sum / static_cast<float64>(values.size());
+  float64 squaredDeviations = 0.0;
+  for(T value : values)
+  {
+    squaredDeviations += (static_cast<float64>(value) - mean) * (static_cast<float64>(value) - mean);
+  }
+
+  Statistics<T> statistics = ComputeStatistics(nonstd::span<const T>(values));
+  REQUIRE(statistics.count == values.size());
+  REQUIRE(statistics.min == min);
+  REQUIRE(statistics.max == max);
+  REQUIRE(statistics.sum == Approx(sum));
+  REQUIRE(statistics.mean() == Approx(mean));
+  REQUIRE(statistics.variance() == Approx(squaredDeviations / static_cast<float64>(values.size())));
+  REQUIRE(statistics.variance(1) == Approx(squaredDeviations / static_cast<float64>(values.size() - 1)));
+}
+
+bool BitEqual(float64 lhs, float64 rhs)
+{
+  return std::memcmp(&lhs, &rhs, sizeof(float64)) == 0;
+}
+} // namespace
+
+TEST_CASE("ReductionTest")
+{
+  std::mt19937_64 generator(42);
+
+  SECTION("values")
+  {
+    // Sizes around the vector width and block size exercise the tails
+    for(usize size : {1ull, 7ull, 8ull, 9ull, 1000ull, (1ull << 16) + 3, 300000ull})
+    {
+      std::uniform_real_distribution<float32> floatDistribution(-100.0f, 100.0f);
+      std::uniform_int_distribution<int32> intDistribution(-1000000, 1000000);
+      std::uniform_int_distribution<int32> byteDistribution(0, 255);
+      std::vector<float32> floats(size);
+      std::vector<float64> doubles(size);
+      std::vector<int32> ints(size);
+      std::vector<uint8> bytes(size);
+      std::vector<int64> longs(size);
+      for(usize i = 0; i < size; i++)
+      {
+        floats[i] = floatDistribution(generator);
+        doubles[i] = floats[i] * 3.0;
+        ints[i] = intDistribution(generator);
+        bytes[i] = static_cast<uint8>(byteDistribution(generator));
+        longs[i] = static_cast<int64>(ints[i]) * (1ll << 20);
+      }
+      if(size > 1)
+      {
+        CheckAgainstNaive(floats);
+        CheckAgainstNaive(doubles);
+        CheckAgainstNaive(ints);
+        CheckAgainstNaive(bytes);
+        CheckAgainstNaive(longs);
+      }
+      REQUIRE(Min(nonstd::span<const int32>(ints)) == ComputeStatistics(nonstd::span<const int32>(ints)).min);
+    }
+
+    DataVector<bool> flags(10, false);
+    flags[3] = true;
+    flags[7] = true;
+    Statistics<bool> flagStatistics = ComputeStatistics(flags);
+    REQUIRE(flagStatistics.min == false);
+    REQUIRE(flagStatistics.max == true);
+    REQUIRE(flagStatistics.sum == 2.0);
+  }
+
+  SECTION("variance is stable with a large mean")
+  {
+    std::vector<float64> values = {1.0e9 + 4.0, 1.0e9 + 7.0, 1.0e9 + 13.0, 1.0e9 + 16.0};
+    REQUIRE(Variance(nonstd::span<const float64>(values), 1) == Approx(30.0));
+    REQUIRE(Mean(nonstd::span<const float64>(values)) == Approx(1.0e9 + 10.0));
+  }
+
+  SECTION("nan")
+  {
+    constexpr float32 k_Nan = std::numeric_limits<float32>::quiet_NaN();
+    std::vector<float32> values(100, 2.0f);
+    values[0] = k_Nan;
+    values[17] = -3.0f;
+    values[42] = k_Nan;
+    values[99] = 5.0f;
+
+    Statistics<float32> propagated = ComputeStatistics(nonstd::span<const float32>(values));
+    REQUIRE(std::isnan(propagated.min));
+    REQUIRE(std::isnan(propagated.max));
+    REQUIRE(std::isnan(propagated.sum));
+    REQUIRE(std::isnan(propagated.variance()));
+    REQUIRE(propagated.count == 100);
+
+    Statistics<float32> ignored = ComputeStatistics(nonstd::span<const float32>(values), NanPolicy::Ignore);
+    REQUIRE(ignored.count == 98);
+    REQUIRE(ignored.min == -3.0f);
+    REQUIRE(ignored.max == 5.0f);
+    REQUIRE(ignored.sum == Approx(2.0 * 96 - 3.0 + 5.0));
+
+    std::vector<float64> doubles(values.begin(), values.end());
+    Statistics<float64> ignoredDoubles = ComputeStatistics(nonstd::span<const float64>(doubles), NanPolicy::Ignore);
+    REQUIRE(ignoredDoubles.count == 98);
+    REQUIRE(BitEqual(ignoredDoubles.sum, ignored.sum));
+    REQUIRE(BitEqual(ignoredDoubles.squaredDeviations, ignored.squaredDeviations));
+
+    std::vector<float32> allNan(20, k_Nan);
+    Statistics<float32> none = ComputeStatistics(nonstd::span<const float32>(allNan), NanPolicy::Ignore);
+    REQUIRE(none.count == 0);
+    REQUIRE(std::isnan(none.min));
+    REQUIRE(std::isnan(none.mean()));
+  }
+
+  SECTION("empty")
+  {
+    Statistics<float64> empty = ComputeStatistics(nonstd::span<const float64>());
+    REQUIRE(empty.count == 0);
+    REQUIRE(std::isnan(empty.min));
+    REQUIRE(std::isnan(empty.max));
+    REQUIRE(empty.sum == 0.0);
+
+    Statistics<uint16> emptyIntegers = ComputeStatistics(nonstd::span<const uint16>());
+    REQUIRE(emptyIntegers.min == 0);
+    REQUIRE(emptyIntegers.max == 0);
+  }
+
+  SECTION("deterministic")
+  {
+    std::normal_distribution<float64> distribution(1.0e6, 1.0);
+    DataVector<float64> values(1000003);
+    for(usize i = 0; i < values.size(); i++)
+    {
+      values[i] = distribution(generator);
+    }
+    // float32 values widen exactly, so both element types must take the same path through the lanes
+    DataVector<float32> floats(values.size());
+    for(usize i = 0; i < values.size(); i++)
+    {
+      floats[i] = static_cast<float32>(values[i]);
+      values[i] = floats[i];
+    }
+
+    Statistics<float64> expected = ComputeStatistics(values);
+    Statistics<float32> fromFloats = ComputeStatistics(floats);
+    REQUIRE(BitEqual(fromFloats.sum, expected.sum));
+    REQUIRE(BitEqual(fromFloats.squaredDeviations, expected.squaredDeviations));
+#ifdef NXCOMMON_ENABLE_MULTICORE
+    tbb::global_control singleThread(tbb::global_control::max_allowed_parallelism, 1);
+#endif
+    Statistics<float64> serial = ComputeStatistics(values);
+    REQUIRE(BitEqual(serial.sum, expected.sum));
+    REQUIRE(BitEqual(serial.sumOfSquares, expected.sumOfSquares));
+    REQUIRE(BitEqual(serial.squaredDeviations, expected.squaredDeviations));
+  }
+}
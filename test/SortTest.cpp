@@ -0,0 +1,174 @@
+#include <catch2/catch.hpp>
+
+#include "NX/Common/DataVector.hpp"
+#include "NX/Common/Sort.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace NX;
+using namespace NX::Common;
+
+namespace
+{
+template <class T>
+std::vector<T> RandomValues(usize size, uint64 seed)
+{
+  std::mt19937_64 generator(seed);
+  std::vector<T> values(size);
+  for(T& value : values)
+  {
+    if constexpr(std::is_floating_point_v<T>)
+    {
+      value = static_cast<T>(std::uniform_real_distribution<float64>(-1000.0, 1000.0)(generator));
+    }
+    else
+    {
+      value = static_cast<T>(generator());
+    }
+  }
+  return values;
+}
+
+template <class T>
+void CheckSort(usize size)
+{
+  std::vector<T> values = RandomValues<T>(size, size);
+  // Duplicates exercise stability and the uniqueness counts
+  for(usize i = 0; i + 3 < size; i += 7)
+  {
+    values[i + 3] = values[i];
+  }
+
+  std::vector<T> expected = values;
+  std::sort(expected.begin(), expected.end());
+  std::vector<T> sorted = values;
+  Sort(nonstd::span<T>(sorted));
+  REQUIRE(sorted == expected);
+
+  std::vector<uint64> expectedIndices(size);
+  std::iota(expectedIndices.begin(), expectedIndices.end(), uint64{0});
+  std::stable_sort(expectedIndices.begin(), expectedIndices.end(), [&values](uint64 lhs, uint64 rhs) { return values[lhs] < values[rhs]; });
+  DataVector<uint64> indices = ArgSort(nonstd::span<const T>(values));
+  REQUIRE(std::equal(indices.begin(), indices.end(), expectedIndices.begin(), expectedIndices.end()));
+
+  UniqueCounts<T> unique = UniqueWithCounts(nonstd::span<const T>(values));
+  std::vector<T> expectedUnique = expected;
+  expectedUnique.erase(std::unique(expectedUnique.begin(), expectedUnique.end()), expectedUnique.end());
+  REQUIRE(std::equal(unique.values.begin(), unique.values.end(), expectedUnique.begin(), expectedUnique.end()));
+  usize offset = 0;
+  usize numMismatches = 0;
+  for(usize i = 0; i < unique.counts.size(); i++)
+  {
+    const auto range = std::equal_range(expected.begin(), expected.end(), unique.values[i]);
+    if(static_cast<usize>(range.first - expected.begin()) != offset || unique.counts[i] != static_cast<uint64>(range.second - range.first))
+    {
+      numMismatches++;
+    }
+    offset += unique.counts[i];
+  }
+  REQUIRE(numMismatches == 0);
+  REQUIRE(offset == size);
+}
+} // namespace
+
+TEST_CASE("SortTest")
+{
+  SECTION("radix sort")
+  {
+    for(usize size : {0, 1, 2, 100, 1000, 300000})
+    {
+      CheckSort<int8>(size);
+      CheckSort<uint8>(size);
+      CheckSort<int16>(size);
+      CheckSort<uint16>(size);
+      CheckSort<int32>(size);
+      CheckSort<uint32>(size);
+      CheckSort<int64>(size);
+      CheckSort<uint64>(size);
+      CheckSort<float32>(size);
+      CheckSort<float64>(size);
+    }
+
+    std::vector<uint8> flags = {1, 0, 0, 1, 1, 0};
+    DataVector<bool> booleans(flags.size());
+    std::copy(flags.begin(), flags.end(), booleans.begin());
+    DataVector<uint64> indices = ArgSort(booleans);
+    REQUIRE(std::vector<uint64>(indices.begin(), indices.end()) == std::vector<uint64>{1, 2, 5, 0, 3, 4});
+    Sort(booleans);
+    REQUIRE(std::count(booleans.begin(), booleans.begin() + 3, false) == 3);
+    REQUIRE(std::count(booleans.begin() + 3, booleans.end(), true) == 3);
+  }
+
+  SECTION("floating point order")
+  {
+    constexpr float32 k_Infinity = std::numeric_limits<float32>::infinity();
+    const float32 nan = std::numeric_limits<float32>::quiet_NaN();
+    std::vector<float32> values(1000, 2.0f);
+    values[10] = nan;
+    values[20] = -k_Infinity;
+    values[30] = k_Infinity;
+    values[40] = 0.0f;
+    values[50] = -0.0f;
+    values[60] = -std::numeric_limits<float32>::denorm_min();
+    values[70] = -nan;
+    Sort(nonstd::span<float32>(values));
+    REQUIRE(std::isnan(values.front()));
+    REQUIRE(std::signbit(values.front()));
+    REQUIRE(values[1] == -k_Infinity);
+    REQUIRE(values[2] == -std::numeric_limits<float32>::denorm_min());
+    REQUIRE(std::signbit(values[3]));
+    REQUIRE(values[4] == 0.0f);
+    REQUIRE_FALSE(std::signbit(values[4]));
+    REQUIRE(values[values.size() - 2] == k_Infinity);
+    REQUIRE(std::isnan(values.back()));
+
+    UniqueCounts<float32> unique = UniqueWithCounts(nonstd::span<const float32>(values));
+    // -0.0 and 0.0 compare equal so they are counted together
+    REQUIRE(unique.values.size() == 7);
+    REQUIRE(unique.counts[3] == 2);
+    REQUIRE(unique.counts[4] == 993);
+  }
+
+  SECTION("merge sort")
+  {
+    std::vector<std::string> words;
+    std::vector<int32> numbers = RandomValues<int32>(50000, 5);
+    for(int32 number : numbers)
+    {
+      words.push_back(std::to_string(number % 5000));
+    }
+    std::vector<std::string> expected = words;
+    std::stable_sort(expected.begin(), expected.end());
+    std::vector<std::string> sorted = words;
+    Sort(nonstd::span<std::string>(sorted));
+    REQUIRE(sorted == expected);
+
+    // Descending order through a custom comparator keeps equal elements in their original order
+    std::vector<uint64> expectedIndices(words.size());
+    std::iota(expectedIndices.begin(), expectedIndices.end(), uint64{0});
+    std::stable_sort(expectedIndices.begin(), expectedIndices.end(), [&words](uint64 lhs, uint64 rhs) { return words[lhs].size() > words[rhs].size(); });
+    DataVector<uint64> indices = ArgSort(nonstd::span<const std::string>(words), [](const std::string& lhs, const std::string& rhs) { return lhs.size() > rhs.size(); });
+    REQUIRE(std::equal(indices.begin(), indices.end(), expectedIndices.begin(), expectedIndices.end()));
+
+    UniqueCounts<std::string> unique = UniqueWithCounts(nonstd::span<const std::string>(words));
+    REQUIRE(std::is_sorted(unique.values.begin(), unique.values.end()));
+    REQUIRE(std::accumulate(unique.counts.begin(), unique.counts.end(), uint64{0}) == words.size());
+
+    // Arithmetic types without a radix sort overload fall back to the merge sort
+    std::vector<char> characters = {'d', 'a', 'c', 'a', 'b'};
+    Sort(nonstd::span<char>(characters));
+    REQUIRE(characters == std::vector<char>{'a', 'a', 'b', 'c', 'd'});
+    std::vector<long long> longs = {5, -3, 9, 0};
+    Sort(nonstd::span<long long>(longs));
+    REQUIRE(longs == std::vector<long long>{-3, 0, 5, 9});
+    std::vector<long double> extended = {2.5L, -1.0L, 2.0L};
+    DataVector<uint64> extendedIndices = ArgSort(nonstd::span<const long double>(extended));
+    REQUIRE(std::vector<uint64>(extendedIndices.begin(), extendedIndices.end()) == std::vector<uint64>{1, 2, 0});
+  }
+}
@@ -0,0 +1,238 @@
+#include <catch2/catch.hpp>
+
+#include "NX/Common/SpaceFillingCurve.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+using namespace NX;
+using namespace NX::Common;
+
+namespace
+{
+usize Distance(const std::array<uint32, 3>& lhs, const std::array<uint32, 3>& rhs)
+{
+  usize distance = 0;
+  for(usize i = 0; i < 3; i++)
+  {
+    distance += lhs[i] > rhs[i] ? lhs[i] - rhs[i] : rhs[i] - lhs[i];
+  }
+  return distance;
+}
+} // namespace
+
+TEST_CASE("SpaceFillingCurveTest")
+{
+  SECTION("morton")
+  {
+    REQUIRE(MortonEncode3D(0, 0, 0) == 0);
+    REQUIRE(MortonEncode3D(1, 0, 0) == 1);
+    REQUIRE(MortonEncode3D(0, 1, 0) == 2);
+    REQUIRE(MortonEncode3D(0, 0, 1) == 4);
+    REQUIRE(MortonEncode3D(3, 0, 5) == 0b100'001'101);
+    REQUIRE(MortonEncode3D(k_MaxCurveCoordinate, k_MaxCurveCoordinate, k_MaxCurveCoordinate) == (1ull << 63) - 1);
+    REQUIRE(MortonEncode3D(k_MaxCurveCoordinate, 0, 0) == 0x1249249249249249ull);
+
+    std::mt19937_64 generator(42);
+    std::uniform_int_distribution<uint32> distribution(0, k_MaxCurveCoordinate);
+    usize numWrong = 0;
+    for(usize i = 0; i < 10000; i++)
+    {
+      const std::array<uint32, 3> coords = {distribution(generator), distribution(generator), distribution(generator)};
+      const uint64 key = MortonEncode3D(coords[0], coords[1], coords[2]);
+      numWrong += MortonDecode3D(key) != coords ? 1 : 0;
+    }
+    REQUIRE(numWrong == 0);
+  }
+
+  SECTION("hilbert")
+  {
+    for(uint32 numBits : {1u, 2u, 3u, 5u})
+    {
+      const uint64 numCells = 1ull << (3 * numBits);
+      std::vector<bool> visited(numCells, false);
+      std::array<uint32, 3> previous = HilbertDecode3D(0, numBits);
+      REQUIRE(previous == std::array<uint32, 3>{0, 0, 0});
+      usize numWrong = 0;
+      for(uint64 key = 0; key < numCells; key++)
+      {
+        const std::array<uint32, 3> coords = HilbertDecode3D(key, numBits);
+        numWrong += HilbertEncode3D(coords[0], coords[1], coords[2], numBits) != key ? 1 : 0;
+        numWrong += (key != 0 && Distance(previous, coords) != 1) ? 1 : 0;
+        const uint64 cell = (static_cast<uint64>(coords[2]) << (2 * numBits)) | (static_cast<uint64>(coords[1]) << numBits) | coords[0];
+        numWrong += visited[cell] ? 1 : 0;
+        visited[cell] = true;
+        previous = coords;
+      }
+      REQUIRE(numWrong == 0);
+    }
+
+    std::mt19937_64 generator(7);
+    std::uniform_int_distribution<uint32> distribution(0, k_MaxCurveCoordinate);
+    usize numWrong = 0;
+    for(usize i = 0; i < 1000; i++)
+    {
+      const std::array<uint32, 3> coords = {distribution(generator), distribution(generator), distribution(generator)};
+      const uint64 key = HilbertEncode3D(coords[0], coords[1], coords[2]);
+      numWrong += (key >= (1ull << 63) || HilbertDecode3D(key) != coords) ? 1 : 0;
+    }
+    REQUIRE(numWrong == 0);
+  }
+
+  SECTION("voxel indices")
+  {
+    const std::array<usize, 3> dims = {20, 11, 9};
+    const Range3D range(3, 19, 1, 10, 2, 7);
+    for(SpaceFillingCurve curve : {SpaceFillingCurve::Morton, SpaceFillingCurve::Hilbert})
+    {
+      const DataVector<uint64> indices = CurveOrderVoxelIndices(range, dims, curve);
+      REQUIRE(indices.size() == 16 * 9 * 5);
+
+      // Every voxel of the range is visited once
+      std::vector<uint64> sorted(indices.begin(), indices.end());
+      std::sort(sorted.begin(), sorted.end());
+      std::vector<uint64> expected;
+      for(usize z = 2; z < 7; z++)
+      {
+        for(usize y = 1; y < 10; y++)
+        {
+          for(usize x = 3; x < 19; x++)
+          {
+            expected.push_back((z * dims[1] + y) * dims[0] + x);
+          }
+        }
+      }
+      REQUIRE(sorted == expected);
+
+      // Voxels follow the order of their keys relative to the corner of the range
+      const auto keyOf = [&dims, curve](uint64 index) {
+        const auto x = static_cast<uint32>(index % dims[0] - 3);
+        const auto y = static_cast<uint32>((index / dims[0]) % dims[1] - 1);
+        const auto z = static_cast<uint32>(index / (dims[0] * dims[1]) - 2);
+        return CurveEncode3D(curve, x, y, z, 4);
+      };
+      usize numWrong = 0;
+      for(usize i = 1; i < indices.size(); i++)
+      {
+        numWrong += keyOf(indices[i - 1]) < keyOf(indices[i]) ? 0 : 1;
+      }
+      REQUIRE(numWrong == 0);
+    }
+
+    // A power of two cube is traversed along the Hilbert curve one face neighbor at a time
+    const DataVector<uint64> cube = CurveOrderVoxelIndices(Range3D(8, 8, 8), {8, 8, 8}, SpaceFillingCurve::Hilbert);
+    usize numWrong = 0;
+    for(usize i = 1; i < cube.size(); i++)
+    {
+      const std::array<uint32, 3> lhs = {static_cast<uint32>(cube[i - 1] % 8), static_cast<uint32>(cube[i - 1] / 8 % 8), static_cast<uint32>(cube[i - 1] / 64)};
+      const std::array<uint32, 3> rhs = {static_cast<uint32>(cube[i] % 8), static_cast<uint32>(cube[i] / 8 % 8), static_cast<uint32>(cube[i] / 64)};
+      numWrong += Distance(lhs, rhs) != 1 ? 1 : 0;
+    }
+    REQUIRE(numWrong == 0);
+
+    REQUIRE(CurveOrderVoxelIndices(Range3D(0, 20, 4, 4, 0, 9), dims, SpaceFillingCurve::Morton).size() == 0);
+    REQUIRE_THROWS_AS(CurveOrderVoxelIndices(Range3D(0, 21, 0, 11, 0, 9), dims, SpaceFillingCurve::Morton), std::runtime_error);
+  }
+
+  SECTION("block traversal")
+  {
+    const std::array<usize, 3> dims = {20, 11, 9};
+    const Range3D range(3, 19, 1, 10, 2, 7);
+    for(SpaceFillingCurve curve : {SpaceFillingCurve::Morton, SpaceFillingCurve::Hilbert})
+    {
+      // Single voxel blocks follow the same order as the sorted indices
+      std::vector<uint64> visited;
+      ForEachBlockInCurveOrder(range, dims, curve, 1, [&visited, &dims](const Range3D& block) {
+        const Range3D::RangeType bounds = block.getRange();
+        visited.push_back((bounds[4] * dims[1] + bounds[2]) * dims[0] + bounds[0]);
+      });
+      const DataVector<uint64> indices = CurveOrderVoxelIndices(range, dims, curve);
+      REQUIRE(visited == std::vector<uint64>(indices.begin(), indices.end()));
+
+      // Larger blocks are clipped cubes that still cover the range once
+      std::vector<uint32> visits(dims[0] * dims[1] * dims[2], 0);
+      usize numWrong = 0;
+      ForEachBlockInCurveOrder(range, dims, curve, 6, [&visits, &dims, &numWrong](const Range3D& block) {
+        const Range3D::RangeType bounds = block.getRange();
+        for(usize i = 0; i < 3; i++)
+        {
+          numWrong += bounds[2 * i + 1] - bounds[2 * i] > 4 ? 1 : 0;
+        }
+        for(usize z = bounds[4]; z < bounds[5]; z++)
+        {
+          for(usize y = bounds[2]; y < bounds[3]; y++)
+          {
+            for(usize x = bounds[0]; x < bounds[1]; x++)
+            {
+              visits[(z * dims[1] + y) * dims[0] + x]++;
+            }
+          }
+        }
+      });
+      for(usize z = 0; z < dims[2]; z++)
+      {
+        for(usize y = 0; y < dims[1]; y++)
+        {
+          for(usize x = 0; x < dims[0]; x++)
+          {
+            const bool inside = x >= 3 && x < 19 && y >= 1 && y < 10 && z >= 2 && z < 7;
+            numWrong += visits[(z * dims[1] + y) * dims[0] + x] != (inside ? 1 : 0) ? 1 : 0;
+          }
+        }
+      }
+      REQUIRE(numWrong == 0);
+    }
+
+    usize numBlocks = 0;
+    ForEachBlockInCurveOrder(Range3D(0, 20, 4, 4, 0, 9), dims, SpaceFillingCurve::Hilbert, 4, [&numBlocks](const Range3D&) { numBlocks++; });
+    REQUIRE(numBlocks == 0);
+    REQUIRE_THROWS_AS(ForEachBlockInCurveOrder(Range3D(0, 21, 0, 11, 0, 9), dims, SpaceFillingCurve::Morton, 4, [](const Range3D&) {}), std::runtime_error);
+  }
+
+  SECTION("point permutation")
+  {
+    std::mt19937_64 generator(3);
+    std::uniform_real_distribution<float64> distribution(-5.0, 15.0);
+    std::vector<Point3Dd> points;
+    for(usize i = 0; i < 5000; i++)
+    {
+      points.emplace_back(distribution(generator), distribution(generator), distribution(generator) * 0.5);
+    }
+    for(SpaceFillingCurve curve : {SpaceFillingCurve::Morton, SpaceFillingCurve::Hilbert})
+    {
+      const DataVector<uint64> permutation = CurveOrderPermutation(nonstd::span<const Point3Dd>(points.data(), points.size()), curve);
+      REQUIRE(permutation.size() == points.size());
+      std::vector<uint64> sorted(permutation.begin(), permutation.end());
+      std::sort(sorted.begin(), sorted.end());
+      usize numWrong = 0;
+      for(usize i = 0; i < sorted.size(); i++)
+      {
+        numWrong += sorted[i] != i ? 1 : 0;
+      }
+      REQUIRE(numWrong == 0);
+
+      // Consecutive points along the curve are much closer together than in the input order
+      float64 inputLength = 0.0;
+      float64 curveLength = 0.0;
+      for(usize i = 1; i < points.size(); i++)
+      {
+        inputLength += std::sqrt(std::pow(points[i][0] - points[i - 1][0], 2) + std::pow(points[i][1] - points[i - 1][1], 2) + std::pow(points[i][2] - points[i - 1][2], 2));
+        const Point3Dd& lhs = points[permutation[i - 1]];
+        const Point3Dd& rhs = points[permutation[i]];
+        curveLength += std::sqrt(std::pow(rhs[0] - lhs[0], 2) + std::pow(rhs[1] - lhs[1], 2) + std::pow(rhs[2] - lhs[2], 2));
+      }
+      REQUIRE(curveLength * 4.0 < inputLength);
+    }
+
+    // Identical points keep their order
+    const std::vector<Point3Df> same(10, Point3Df(1.0f, 2.0f, 3.0f));
+    const DataVector<uint64> identity = CurveOrderPermutation(nonstd::span<const Point3Df>(same.data(), same.size()), SpaceFillingCurve::Hilbert);
+    for(usize i = 0; i < identity.size(); i++)
+    {
+      REQUIRE(identity[i] == i);
+    }
+  }
+}
@@ -0,0 +1,175 @@
+#include <catch2/catch.hpp>
+
+#include "NX/Common/Stencil3D.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+using namespace NX;
+using namespace NX::Common;
+
+namespace
+{
+/**
+ * @brief Sums the neighbors of every voxel of range with explicit bounds checks, each neighbor weighted by its slot.
+ */
+std::vector<uint64> CheckedNeighborSums(const std::vector<uint64>& values, const std::array<usize, 3>& dims, const Range3D& range, const Stencil3D& stencil)
+{
+  std::vector<uint64> sums(values.size(), 0);
+  for(usize z = range[4]; z < range[5]; z++)
+  {
+    for(usize y = range[2]; y < range[3]; y++)
+    {
+      for(usize x = range[0]; x < range[1]; x++)
+      {
+        const std::array<int64, 3> position = {static_cast<int64>(x), static_cast<int64>(y), static_cast<int64>(z)};
+        uint64 sum = 1;
+        for(usize slot = 0; slot < stencil.numNeighbors(); slot++)
+        {
+          std::array<int64, 3> neighbor = {};
+          bool inside = true;
+          for(usize i = 0; i < 3; i++)
+          {
+            neighbor[i] = position[i] + stencil.directions()[slot][i];
+            inside = inside && neighbor[i] >= 0 && neighbor[i] < static_cast<int64>(dims[i]);
+          }
+          if(inside)
+          {
+            sum += (slot + 1) * values[(neighbor[2] * dims[1] + neighbor[1]) * dims[0] + neighbor[0]];
+          }
+        }
+        sums[(z * dims[1] + y) * dims[0] + x] = sum;
+      }
+    }
+  }
+  return sums;
+}
+} // namespace
+
+TEST_CASE("Stencil3DTest")
+{
+  const std::array<usize, 3> dims = {13, 9, 7};
+  std::vector<uint64> values(dims[0] * dims[1] * dims[2]);
+  for(usize i = 0; i < values.size(); i++)
+  {
+    values[i] = i * i + 7;
+  }
+
+  SECTION("offsets")
+  {
+    const Stencil3D face(dims, NeighborConnectivity::Face);
+    REQUIRE(face.numNeighbors() == 6);
+    REQUIRE(face.offsets() == std::vector<int64>{-117, -13, -1, 1, 13, 117});
+    REQUIRE(Stencil3D(dims, NeighborConnectivity::FaceEdge).numNeighbors() == 18);
+
+    const Stencil3D all(dims, NeighborConnectivity::FaceEdgeVertex);
+    REQUIRE(all.numNeighbors() == 26);
+    REQUIRE(all.offsets().front() == -1 - 13 - 117);
+    REQUIRE(all.offsets().back() == 1 + 13 + 117);
+    for(usize slot = 0; slot < all.numNeighbors(); slot++)
+    {
+      const Stencil3D::Direction& direction = all.directions()[slot];
+      REQUIRE(all.offsets()[slot] == direction[0] + direction[1] * 13 + direction[2] * 117);
+    }
+  }
+
+  SECTION("interior and shells")
+  {
+    const Stencil3D stencil(dims, NeighborConnectivity::Face);
+    for(const Range3D& range : {Range3D(13, 9, 7), Range3D(0, 5, 2, 9, 1, 4), Range3D(4, 8, 3, 6, 2, 5), Range3D(12, 13, 0, 9, 0, 7), Range3D(0, 13, 0, 9, 3, 3)})
+    {
+      std::vector<uint32> visits(values.size(), 0);
+      const Range3D interior = stencil.interior(range);
+      std::vector<Range3D> pieces = stencil.boundaryShells(range);
+      pieces.push_back(interior);
+      for(const Range3D& piece : pieces)
+      {
+        for(usize z = piece[4]; z < piece[5]; z++)
+        {
+          for(usize y = piece[2]; y < piece[3]; y++)
+          {
+            for(usize x = piece[0]; x < piece[1]; x++)
+            {
+              visits[(z * dims[1] + y) * dims[0] + x]++;
+            }
+          }
+        }
+      }
+      usize numWrong = 0;
+      for(usize z = 0; z < dims[2]; z++)
+      {
+        for(usize y = 0; y < dims[1]; y++)
+        {
+          for(usize x = 0; x < dims[0]; x++)
+          {
+            const bool inside = x >= range[0] && x < range[1] && y >= range[2] && y < range[3] && z >= range[4] && z < range[5];
+            numWrong += visits[(z * dims[1] + y) * dims[0] + x] != (inside ? 1 : 0) ? 1 : 0;
+          }
+        }
+      }
+      REQUIRE(numWrong == 0);
+    }
+
+    REQUIRE(stencil.interior(Range3D(13, 9, 7)).getRange() == Range3D::RangeType{1, 12, 1, 8, 1, 6});
+    REQUIRE(stencil.boundaryShells(Range3D(13, 9, 7)).size() == 6);
+    REQUIRE(stencil.boundaryShells(Range3D(4, 8, 3, 6, 2, 5)).empty());
+    REQUIRE_THROWS_AS(stencil.interior(Range3D(0, 14, 0, 9, 0, 7)), std::runtime_error);
+  }
+
+  SECTION("neighbors")
+  {
+    for(NeighborConnectivity connectivity : {NeighborConnectivity::Face, NeighborConnectivity::FaceEdge, NeighborConnectivity::FaceEdgeVertex})
+    {
+      const Stencil3D stencil(dims, connectivity);
+      for(const Range3D& range : {Range3D(13, 9, 7), Range3D(2, 11, 0, 4, 3, 7)})
+      {
+        const std::vector<uint64> expected = CheckedNeighborSums(values, dims, range, stencil);
+
+        std::vector<uint64> serial(values.size(), 0);
+        usize numInterior = 0;
+        usize numWrongCenters = 0;
+        stencil.forEach(range, [&](usize index, const auto& neighbors) {
+          if constexpr(std::is_same_v<std::decay_t<decltype(neighbors)>, Stencil3D::InteriorNeighbors>)
+          {
+            numInterior++;
+          }
+          uint64 sum = 1;
+          neighbors.forEach([&values, &sum](usize neighbor, usize slot) { sum += (slot + 1) * values[neighbor]; });
+          serial[index] = sum;
+          numWrongCenters += neighbors.center() != index ? 1 : 0;
+        });
+        REQUIRE(serial == expected);
+        REQUIRE(numWrongCenters == 0);
+        const Range3D interior = stencil.interior(range);
+        REQUIRE(numInterior == (interior[1] - interior[0]) * (interior[3] - interior[2]) * (interior[5] - interior[4]));
+
+        std::vector<uint64> parallel(values.size(), 0);
+        std::vector<std::atomic<uint32>> visits(values.size());
+        stencil.execute(range, [&](usize index, const auto& neighbors) {
+          uint64 sum = 1;
+          neighbors.forEach([&values, &sum](usize neighbor, usize slot) { sum += (slot + 1) * values[neighbor]; });
+          parallel[index] = sum;
+          visits[index]++;
+        });
+        REQUIRE(parallel == expected);
+        usize numVisits = 0;
+        for(const std::atomic<uint32>& count : visits)
+        {
+          numVisits += count;
+        }
+        REQUIRE(numVisits == (range[1] - range[0]) * (range[3] - range[2]) * (range[5] - range[4]));
+      }
+    }
+
+    // A grid only one voxel thick has no interior
+    const Stencil3D flat({8, 8, 1}, NeighborConnectivity::FaceEdgeVertex);
+    usize numNeighbors = 0;
+    REQUIRE(flat.interior(Range3D(8, 8, 1)).getRange() == Range3D::RangeType{0, 0, 0, 0, 0, 0});
+    flat.forEach(Range3D(8, 8, 1), [&numNeighbors](usize, const auto& neighbors) {
+      neighbors.forEach([&numNeighbors](usize, usize) { numNeighbors++; });
+    });
+    REQUIRE(numNeighbors == 4 * 3 + 24 * 5 + 36 * 8);
+  }
+}
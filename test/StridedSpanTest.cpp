@@ -0,0 +1,115 @@
+#include <catch2/catch.hpp>
+
+#include "NX/Common/DataVector.hpp"
+#include "NX/Common/StridedSpan.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+using namespace NX;
+using namespace NX::Common;
+
+namespace
+{
+template <class T>
+void CheckTranspose(usize numComponents, usize numTuples)
+{
+  std::vector<T> interleaved(numComponents * numTuples);
+  for(usize i = 0; i < interleaved.size(); i++)
+  {
+    interleaved[i] = static_cast<T>(i * 7 + 3);
+  }
+
+  std::vector<T> planar(interleaved.size());
+  TransposeToPlanar(TupleSpan<const T>(interleaved, numComponents), nonstd::span<T>(planar));
+  usize numMismatches = 0;
+  for(usize t = 0; t < numTuples; t++)
+  {
+    for(usize c = 0; c < numComponents; c++)
+    {
+      if(planar[c * numTuples + t] != interleaved[t * numComponents + c])
+      {
+        numMismatches++;
+      }
+    }
+  }
+  REQUIRE(numMismatches == 0);
+
+  std::vector<T> roundTrip(interleaved.size());
+  TransposeToInterleaved(nonstd::span<const T>(planar), TupleSpan<T>(roundTrip, numComponents));
+  REQUIRE(roundTrip == interleaved);
+}
+} // namespace
+
+TEST_CASE("StridedSpanTest")
+{
+  SECTION("views")
+  {
+    DataVector<float32> eulers(12);
+    std::iota(eulers.begin(), eulers.end(), 0.0f);
+    TupleSpan<float32> tuples(eulers, 3);
+    REQUIRE(tuples.numTuples() == 4);
+    REQUIRE(tuples.numComponents() == 3);
+    REQUIRE(tuples(2, 1) == 7.0f);
+    REQUIRE(tuples.tuple(3)[0] == 9.0f);
+    REQUIRE_THROWS_AS(tuples.at(4, 0), std::runtime_error);
+    REQUIRE_THROWS_AS(tuples.component(3), std::runtime_error);
+    REQUIRE_THROWS_AS(TupleSpan<float32>(eulers, 5), std::runtime_error);
+
+    StridedSpan<float32> phi2 = tuples.component(2);
+    REQUIRE(phi2.size() == 4);
+    REQUIRE(phi2.stride() == 3);
+    REQUIRE_FALSE(phi2.isContiguous());
+    REQUIRE(std::vector<float32>(phi2.begin(), phi2.end()) == std::vector<float32>{2.0f, 5.0f, 8.0f, 11.0f});
+    REQUIRE(phi2.end() - phi2.begin() == 4);
+    REQUIRE(*std::max_element(phi2.begin(), phi2.end()) == 11.0f);
+
+    // Writing through a component view modifies the interleaved array
+    std::fill(phi2.begin(), phi2.end(), -1.0f);
+    REQUIRE(eulers[5] == -1.0f);
+    REQUIRE(eulers[4] == 4.0f);
+    std::sort(tuples.component(0).begin(), tuples.component(0).end(), std::greater<>());
+    REQUIRE(eulers[0] == 9.0f);
+    REQUIRE(eulers[9] == 0.0f);
+
+    usize numTuples = 0;
+    for(nonstd::span<float32> tuple : tuples)
+    {
+      REQUIRE(tuple.size() == 3);
+      REQUIRE(tuple[2] == -1.0f);
+      numTuples++;
+    }
+    REQUIRE(numTuples == 4);
+
+    const DataVector<float32>& constEulers = eulers;
+    TupleSpan<const float32> constTuples(constEulers, 3);
+    StridedSpan<const float32> constComponent = constTuples.component(1);
+    REQUIRE(constComponent.at(1) == 4.0f);
+    REQUIRE_THROWS_AS(constComponent.at(4), std::runtime_error);
+  }
+
+  SECTION("transpose")
+  {
+    for(usize numComponents : {1, 2, 3, 4, 5, 7})
+    {
+      for(usize numTuples : {1, 3, 4, 17, 16, 35, 1000})
+      {
+        CheckTranspose<uint8>(numComponents, numTuples);
+        CheckTranspose<uint16>(numComponents, numTuples);
+        CheckTranspose<float32>(numComponents, numTuples);
+        CheckTranspose<int32>(numComponents, numTuples);
+        CheckTranspose<float64>(numComponents, numTuples);
+      }
+    }
+    // Large enough to be split across threads
+    CheckTranspose<float32>(3, 300001);
+    CheckTranspose<uint8>(3, 1000003);
+    CheckTranspose<uint8>(4, 1000003);
+
+    std::vector<float32> values(6);
+    std::vector<float32> tooSmall(5);
+    REQUIRE_THROWS_AS(TransposeToPlanar(TupleSpan<const float32>(values, 3), nonstd::span<float32>(tooSmall)), std::invalid_argument);
+  }
+}
@@ -0,0 +1,128 @@
+#include <catch2/catch.hpp>
+
+#include "NX/Common/ThreadPool.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace NX;
+using namespace NX::Common;
+
+namespace
+{
+/**
+ * @brief Sums [begin, end) by recursive fork-join so that tasks spawn and wait on tasks of their own.
+ */
+uint64 ForkJoinSum(ThreadPool& pool, uint64 begin, uint64 end)
+{
+  if(end - begin <= 64)
+  {
+    uint64 sum = 0;
+    for(uint64 i = begin; i < end; i++)
+    {
+      sum += i;
+    }
+    return sum;
+  }
+  const uint64 middle = begin + (end - begin) / 2;
+  uint64 rightSum = 0;
+  TaskGroup group(pool);
+  group.run([&pool, &rightSum, middle, end]() { rightSum = ForkJoinSum(pool, middle, end); });
+  const uint64 leftSum = ForkJoinSum(pool, begin, middle);
+  group.wait();
+  return leftSum + rightSum;
+}
+} // namespace
+
+TEST_CASE("ThreadPoolTest")
+{
+  SECTION("task group")
+  {
+    for(usize numThreads : {1, 2, 4})
+    {
+      ThreadPool pool(numThreads);
+      REQUIRE(pool.numThreads() == numThreads);
+
+      std::vector<std::atomic<uint32>> counts(1000);
+      TaskGroup group(pool);
+      for(usize i = 0; i < counts.size(); i++)
+      {
+        group.run([&counts, i]() { counts[i]++; });
+      }
+      group.wait();
+      usize numWrong = 0;
+      for(const auto& count : counts)
+      {
+        numWrong += count != 1 ? 1 : 0;
+      }
+      REQUIRE(numWrong == 0);
+
+      // A group can be reused after waiting
+      std::atomic<usize> total = 0;
+      group.run([&total]() { total += 5; });
+      group.wait();
+      REQUIRE(total == 5);
+    }
+  }
+
+  SECTION("fork join")
+  {
+    for(usize numThreads : {1, 3, 8})
+    {
+      ThreadPool pool(numThreads);
+      const uint64 size = 1000000;
+      REQUIRE(ForkJoinSum(pool, 0, size) == size * (size - 1) / 2);
+    }
+  }
+
+  SECTION("concurrent callers")
+  {
+    ThreadPool pool(4);
+    std::vector<uint64> sums(4);
+    std::vector<std::thread> callers;
+    for(usize i = 0; i < sums.size(); i++)
+    {
+      callers.emplace_back([&pool, &sums, i]() { sums[i] = ForkJoinSum(pool, 0, 100000 * (i + 1)); });
+    }
+    for(std::thread& caller : callers)
+    {
+      caller.join();
+    }
+    for(usize i = 0; i < sums.size(); i++)
+    {
+      const uint64 size = 100000 * (i + 1);
+      REQUIRE(sums[i] == size * (size - 1) / 2);
+    }
+  }
+
+  SECTION("exceptions")
+  {
+    ThreadPool pool(3);
+    std::atomic<usize> numRun = 0;
+    TaskGroup group(pool);
+    for(usize i = 0; i < 100; i++)
+    {
+      group.run([&numRun, i]() {
+        numRun++;
+        if(i % 10 == 3)
+        {
+          throw std::runtime_error("task failed");
+        }
+      });
+    }
+    REQUIRE_THROWS_AS(group.wait(), std::runtime_error);
+    // Every task still ran and the error was only reported once
+    REQUIRE(numRun == 100);
+    REQUIRE_NOTHROW(group.wait());
+  }
+
+  SECTION("global")
+  {
+    ThreadPool& pool = ThreadPool::Global();
+    REQUIRE(&pool == &ThreadPool::Global());
+    REQUIRE(pool.numThreads() >= 1);
+    REQUIRE(ForkJoinSum(pool, 0, 5000) == 5000ull * 4999ull / 2);
+  }
+}
@@ -0,0 +1,122 @@
+#include <catch2/catch.hpp>
+
+#include "NX/Common/TiledRange3D.hpp"
+
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+using namespace NX;
+using namespace NX::Common;
+
+namespace
+{
+std::vector<usize> NestedLoopIndices(const Range3D& range, const std::array<usize, 3>& dims)
+{
+  std::vector<usize> indices;
+  for(usize z = range[4]; z < range[5]; z++)
+  {
+    for(usize y = range[2]; y < range[3]; y++)
+    {
+      for(usize x = range[0]; x < range[1]; x++)
+      {
+        indices.push_back((z * dims[1] + y) * dims[0] + x);
+      }
+    }
+  }
+  return indices;
+}
+} // namespace
+
+TEST_CASE("TiledRange3DTest")
+{
+  const std::array<usize, 3> dims = {21, 17, 13};
+
+  SECTION("voxel indices")
+  {
+    for(const Range3D& range : {Range3D(0, 21, 0, 17, 0, 13), Range3D(3, 9, 2, 3, 5, 11), Range3D(20, 21, 16, 17, 12, 13), Range3D(4, 4, 0, 17, 0, 13)})
+    {
+      const VoxelIndexRange voxels(range, dims);
+      const std::vector<usize> expected = NestedLoopIndices(range, dims);
+      REQUIRE(voxels.size() == expected.size());
+      REQUIRE(std::vector<usize>(voxels.begin(), voxels.end()) == expected);
+
+      std::vector<usize> visited;
+      voxels.forEach([&visited](usize index) { visited.push_back(index); });
+      REQUIRE(visited == expected);
+    }
+  }
+
+  SECTION("tiles")
+  {
+    const Range3D range(2, 20, 1, 17, 0, 11);
+    TiledRange3D tiling(range, dims, {4, 5, 3});
+    REQUIRE(tiling.numTilesPerAxis() == std::array<usize, 3>{5, 4, 4});
+    REQUIRE(tiling.numTiles() == 80);
+    REQUIRE(tiling.tile(0).getRange() == Range3D::RangeType{2, 6, 1, 6, 0, 3});
+    REQUIRE(tiling.tile(1).getRange() == Range3D::RangeType{6, 10, 1, 6, 0, 3});
+    REQUIRE(tiling.tile(79).getRange() == Range3D::RangeType{18, 20, 16, 17, 9, 11});
+    REQUIRE_THROWS_AS(tiling.tile(80), std::runtime_error);
+
+    std::vector<uint32> visits(dims[0] * dims[1] * dims[2], 0);
+    usize numTiles = 0;
+    for(const Range3D& tile : tiling)
+    {
+      for(usize index : VoxelIndexRange(tile, dims))
+      {
+        visits[index]++;
+      }
+      numTiles++;
+    }
+    REQUIRE(numTiles == tiling.numTiles());
+    std::vector<uint32> expected(visits.size(), 0);
+    for(usize index : NestedLoopIndices(range, dims))
+    {
+      expected[index] = 1;
+    }
+    REQUIRE(visits == expected);
+
+    std::vector<std::atomic<uint32>> parallelVisits(visits.size());
+    tiling.execute([&parallelVisits, &dims](const Range3D& tile) { VoxelIndexRange(tile, dims).forEach([&parallelVisits](usize index) { parallelVisits[index]++; }); });
+    usize numWrong = 0;
+    for(usize i = 0; i < expected.size(); i++)
+    {
+      numWrong += parallelVisits[i] != expected[i] ? 1 : 0;
+    }
+    REQUIRE(numWrong == 0);
+
+    // Zero extents cover the whole axis
+    TiledRange3D slabs(range, dims, {0, 0, 2});
+    REQUIRE(slabs.tileExtents() == TiledRange3D::TileExtents{18, 16, 2});
+    REQUIRE(slabs.numTiles() == 6);
+    REQUIRE(slabs.voxelIndices(5).size() == 18 * 16 * 1);
+  }
+
+  SECTION("automatic extents")
+  {
+    const Range3D range(512, 512, 512);
+    const TiledRange3D::TileExtents extents = TiledRange3D::AutomaticTileExtents(range, 4);
+    REQUIRE(extents[0] * extents[1] * extents[2] * 4 <= k_DefaultTileBytes);
+    REQUIRE(extents[0] * extents[1] * extents[2] * 4 >= k_DefaultTileBytes / 2);
+    REQUIRE(extents[1] * extents[2] >= 64);
+    REQUIRE(TiledRange3D(range, {512, 512, 512}, 4).tileExtents() == extents);
+
+    // Small ranges fit in a single tile
+    const TiledRange3D small(Range3D(10, 10, 10), {10, 10, 10}, 4);
+    REQUIRE(small.numTiles() == 1);
+    REQUIRE(small.tile(0).getRange() == Range3D::RangeType{0, 10, 0, 10, 0, 10});
+  }
+
+  SECTION("invalid and empty ranges")
+  {
+    REQUIRE_THROWS_AS(TiledRange3D(Range3D(0, 22, 0, 17, 0, 13), dims, {4, 4, 4}), std::runtime_error);
+    REQUIRE_THROWS_AS(TiledRange3D(Range3D(5, 4, 0, 17, 0, 13), dims, {4, 4, 4}), std::runtime_error);
+
+    const TiledRange3D empty(Range3D(0, 21, 3, 3, 0, 13), dims, {4, 4, 4});
+    REQUIRE(empty.numTiles() == 0);
+    REQUIRE(empty.begin() == empty.end());
+    usize numCalls = 0;
+    empty.execute([&numCalls](const Range3D&) { numCalls++; });
+    REQUIRE(numCalls == 0);
+  }
+}